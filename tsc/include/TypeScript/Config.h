@@ -13,13 +13,6 @@
 #define ENABLE_ASYNC 1
 #define ENABLE_EXCEPTIONS 1
 
-#define USE_SPRINTF 1
-#ifndef WIN32
-#ifndef USE_SPRINTF
-#define USE_SPRINTF 1
-#endif
-#endif
-
 #define NUMBER_F64 1
 #define ANY_AS_DEFAULT 1
 
@@ -35,8 +28,6 @@
 //#define ALLOC_ALL_VARS_IN_HEAP 1
 #define ALLOC_CAPTURED_VARS_IN_HEAP 1
 #define ALLOC_CAPTURE_IN_HEAP 1
-// TODO: if I uncomment it, it will create errors in capture vars. calls. find out why? (wrong size of buffers?)
-//#define ALLOC_TRAMPOLINE_IN_HEAP 1
 
 //#define DISABLE_CUSTOM_CLASSSTORAGESTORAGE 1
 
@@ -4,6 +4,7 @@
 struct CompileOptions
 {
     bool disableGC;
+    bool generatorsAsCoroutines;
 };
 
 #endif // DATASTRUCT_H_
\ No newline at end of file
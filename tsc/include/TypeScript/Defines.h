@@ -4,6 +4,8 @@
 #define IDENTIFIER_ATTR_NAME "identifier"
 #define VIRTUALFUNC_ATTR_NAME "__virt"
 #define GENERIC_ATTR_NAME "__generic"
+#define STACK_ALLOC_ATTR_NAME "__stack"
+#define NOUNWIND_ATTR_NAME "__nounwind"
 #define INSTANCES_COUNT_ATTR_NAME "InstancesCount"
 #define RETURN_VARIABLE_NAME ".return"
 #define CAPTURED_NAME ".captured"
@@ -29,6 +31,9 @@
 #define LINSTANCEOF_NAME L".instanceOf"
 #define INSTANCEOF_PARAM_NAME "rttiParam"
 #define LINSTANCEOF_PARAM_NAME L"rttiParam"
+#define CLASS_ID_NAME ".classId"
+#define CLASS_MODULE_NAME ".classModule"
+#define MODULE_MARKER_NAME ".module_marker"
 #define MAIN_ENTRY_NAME "main"
 #define TS_NEST_ATTRIBUTE "ts.nest"
 #define THIS_TEMPVAR_NAME ".this"
@@ -40,12 +45,8 @@
 #define GLOBAL_CONSTUCTIONS_NAME "llvm.global_ctors"
 #define TYPE_BITMAP_NAME ".type_bitmap"
 #define TYPE_DESCR_NAME ".type_descr"
-
-#if __LP64__
-#define TRAMPOLINE_SIZE 48
-#else
-#define TRAMPOLINE_SIZE 40
-#endif
+#define TYPE_NAMES_TABLE_NAME ".type_names"
+#define TYPE_ID_LOOKUP_FUNC_NAME "__type_id_lookup"
 
 #define ATTR(attr) mlir::StringAttr::get(rewriter.getContext(), attr)
 #define IDENT(name) mlir::Identifier::get(name, rewriter.getContext())
@@ -54,4 +55,18 @@
 #define DATA_VALUE_INDEX 0
 #define THIS_VALUE_INDEX 1
 
+// switch with at least so many constant cases is dispatched by one multiway branch
+#define MIN_CASES_TO_DISPATCH_SWITCH 4
+
+// cost of callee in ops (see InlinerPass): small callees are always inlined, bigger ones while caller fits into budget
+#define INLINE_ALWAYS_COST 8
+#define INLINE_COST_THRESHOLD 40
+#define INLINE_CALLER_BUDGET 1000
+
+// buffered output of 'print' (see OutputBufferPass)
+#define OUTPUT_WRITE_NAME "__ts_output_write"
+#define OUTPUT_LINE_NAME "__ts_output_line"
+#define OUTPUT_FLUSH_NAME "__ts_output_flush"
+#define OUTPUT_BUFFER_SIZE 65536
+
 #endif // DEFINES_H_
\ No newline at end of file
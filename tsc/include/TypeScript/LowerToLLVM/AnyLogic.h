@@ -13,6 +13,7 @@
 #include "TypeScript/LowerToLLVM/CodeLogicHelper.h"
 #include "TypeScript/LowerToLLVM/LLVMCodeHelperBase.h"
 #include "TypeScript/LowerToLLVM/TypeOfOpHelper.h"
+#include "TypeScript/LowerToLLVM/TypeIdLogicHelper.h"
 
 using namespace mlir;
 namespace mlir_ts = mlir::typescript;
@@ -20,6 +21,13 @@ namespace mlir_ts = mlir::typescript;
 namespace typescript
 {
 
+// 'any' is i8*, on 64-bit targets small values and pointers are stored in the pointer itself (no allocation):
+//  - 0x0000_xxxx_xxxx_xxx0 - pointer to heap box {size, typeof string, value} (or null), boxes are 8-byte aligned
+//  - 0x0000_pppp_pppp_pppk - 8-byte aligned pointer (string, object, class instance, function) with kind k = 1..7 in
+//                            low bits, see pointerTypeNames(); it still points into the same object, so conservative
+//                            GC which accepts interior pointers keeps the object alive (tag in top bits would hide it)
+//  - 0xFFFF_iiii_vvvv_vvvv - value of up to 32 bits (v) with type id (i), see TypeIdLogicHelper
+//  - otherwise             - 'number', bits of double + 2^49 (NaN is canonicalized, so it never overlaps above ranges)
 class AnyLogic
 {
     Operation *op;
@@ -56,9 +64,34 @@ class AnyLogic
         return castToAny(in, typeOfValue, inLLVMType);
     }
 
-    mlir::Value castToAny(mlir::Value in, mlir::Value typeOfValue, mlir::Type inLLVMType)
+    // origTypeOfValue - typeof value before conversion, used to detect values which can be stored inline
+    mlir::Value castToAny(mlir::Value in, mlir::Value typeOfValue, mlir::Type inLLVMType, mlir::Value origTypeOfValue = mlir::Value())
+    {
+        if (origTypeOfValue && isInlineValuesEnabled())
+        {
+            auto typeId = TypeIdLogicHelper::constTypeId(origTypeOfValue);
+            if (typeId == TypeOfOpHelper::typeId("number") && inLLVMType.isF64())
+            {
+                return encodeNumber(in);
+            }
+
+            if (typeId >= 0 && canBeInlined(inLLVMType))
+            {
+                return encodeInline(in, typeId);
+            }
+
+            auto pointerKind = getPointerKind(typeId);
+            if (pointerKind > 0 && inLLVMType.isa<LLVM::LLVMPointerType>())
+            {
+                return encodePointer(in, pointerKind, typeOfValue, inLLVMType);
+            }
+        }
+
+        return castToAnyInHeap(in, typeOfValue, inLLVMType);
+    }
+
+    mlir::Value castToAnyInHeap(mlir::Value in, mlir::Value typeOfValue, mlir::Type inLLVMType)
     {
-        // TODO: add type id to track data type
         auto llvmStorageType = inLLVMType;
         auto dataWithSizeType = getStorageType(llvmStorageType);
         auto dataWithSizeTypePtr = LLVM::LLVMPointerType::get(dataWithSizeType);
@@ -87,7 +120,38 @@ class AnyLogic
 
     mlir::Value castFromAny(mlir::Value in, mlir::Type resLLVMType)
     {
-        // TODO: add type id to track data type
+        if (isInlineValuesEnabled())
+        {
+            if (resLLVMType.isF64())
+            {
+                auto isHeap = rewriter.create<LLVM::ICmpOp>(loc, LLVM::ICmpPredicate::eq, getHighBits(in), clh.createI64ConstantOf(0));
+                return clh.conditionalExpressionLowering(
+                    resLLVMType, isHeap, [&](OpBuilder &builder, Location loc) { return castFromAnyInHeap(in, resLLVMType); },
+                    [&](OpBuilder &builder, Location loc) { return decodeNumber(in); });
+            }
+
+            if (canBeInlined(resLLVMType))
+            {
+                auto isInline =
+                    rewriter.create<LLVM::ICmpOp>(loc, LLVM::ICmpPredicate::eq, getHighBits(in), clh.createI64ConstantOf(INLINE_TAG));
+                return clh.conditionalExpressionLowering(
+                    resLLVMType, isInline, [&](OpBuilder &builder, Location loc) { return decodeInline(in, resLLVMType); },
+                    [&](OpBuilder &builder, Location loc) { return castFromAnyInHeap(in, resLLVMType); });
+            }
+
+            if (resLLVMType.isa<LLVM::LLVMPointerType>())
+            {
+                return clh.conditionalExpressionLowering(
+                    resLLVMType, isInlinePointer(in), [&](OpBuilder &builder, Location loc) { return decodePointer(in, resLLVMType); },
+                    [&](OpBuilder &builder, Location loc) { return castFromAnyInHeap(in, resLLVMType); });
+            }
+        }
+
+        return castFromAnyInHeap(in, resLLVMType);
+    }
+
+    mlir::Value castFromAnyInHeap(mlir::Value in, mlir::Type resLLVMType)
+    {
         // TODO: add data size check
         auto llvmStorageType = resLLVMType;
         auto dataWithSizeType = getStorageType(llvmStorageType);
@@ -107,7 +171,45 @@ class AnyLogic
 
     mlir::Value typeOfFromAny(mlir::Value in)
     {
-        // TODO: add type id to track data type
+        if (isInlineValuesEnabled())
+        {
+            auto highBits = getHighBits(in);
+            return clh.conditionalExpressionLowering(
+                typeOfValueType, isHeapBox(in), [&](OpBuilder &builder, Location loc) { return typeOfFromAnyInHeap(in); },
+                [&](OpBuilder &builder, Location loc) {
+                    TypeIdLogicHelper tilh(op, rewriter, tch);
+                    auto isInline =
+                        rewriter.create<LLVM::ICmpOp>(loc, LLVM::ICmpPredicate::eq, highBits, clh.createI64ConstantOf(INLINE_TAG));
+                    mlir::Value typeId = rewriter.create<LLVM::TruncOp>(
+                        loc, tilh.getTypeIdType(),
+                        rewriter.create<LLVM::AndOp>(loc, rewriter.create<LLVM::LShrOp>(loc, getBits(in), clh.createI64ConstantOf(32)),
+                                                     clh.createI64ConstantOf(0xFFFF)));
+                    // bits of number or pointer are not type id, do not read outside of table
+                    typeId = rewriter.create<LLVM::SelectOp>(loc, isInline, typeId, clh.createI32ConstantOf(0));
+                    mlir::Value inlineTypeOf = tilh.typeInfoFromTypeId(typeId);
+                    mlir::Value numberTypeOf = ch.getOrCreateGlobalString("number");
+                    mlir::Value typeOf = rewriter.create<LLVM::SelectOp>(loc, isInline, inlineTypeOf, numberTypeOf);
+
+                    auto kind = getPointerKindBits(in);
+                    auto isPointer = isInlinePointer(in);
+                    for (auto indexedName : llvm::enumerate(pointerTypeNames()))
+                    {
+                        auto isKind = rewriter.create<LLVM::ICmpOp>(loc, LLVM::ICmpPredicate::eq, kind,
+                                                                    clh.createI64ConstantOf(indexedName.index() + 1));
+                        auto isPointerOfKind = rewriter.create<LLVM::AndOp>(loc, isPointer, isKind);
+                        mlir::Value kindTypeOf = ch.getOrCreateGlobalString(indexedName.value().str());
+                        typeOf = rewriter.create<LLVM::SelectOp>(loc, isPointerOfKind, kindTypeOf, typeOf);
+                    }
+
+                    return typeOf;
+                });
+        }
+
+        return typeOfFromAnyInHeap(in);
+    }
+
+    mlir::Value typeOfFromAnyInHeap(mlir::Value in)
+    {
         // TODO: add data size check
         // any random type
         auto llvmStorageType = th.getI8Type();
@@ -125,6 +227,141 @@ class AnyLogic
                                                      ValueRange{zero, one});
         return rewriter.create<LLVM::LoadOp>(loc, ptrValue);
     }
+
+  protected:
+    static constexpr int64_t INLINE_TAG = 0xFFFF;
+    static constexpr int64_t NUMBER_OFFSET = 1LL << 49;
+    static constexpr int64_t CANONICAL_NAN = 0x7FF8000000000000LL;
+    static constexpr int64_t POINTER_KIND_MASK = 7;
+    static constexpr int64_t HIGH_BITS_MASK = static_cast<int64_t>(0xFFFF000000000000ULL);
+
+    // kind of inline pointer is index + 1
+    static llvm::ArrayRef<llvm::StringRef> pointerTypeNames()
+    {
+        static const llvm::StringRef names[] = {"string", "object", "class", "function"};
+        return names;
+    }
+
+    // 0 if value of type can't be stored as inline pointer
+    static int getPointerKind(int typeId)
+    {
+        auto names = pointerTypeNames();
+        for (auto indexedName : llvm::enumerate(names))
+        {
+            if (TypeOfOpHelper::typeId(indexedName.value()) == typeId)
+            {
+                return indexedName.index() + 1;
+            }
+        }
+
+        return 0;
+    }
+
+    bool isInlineValuesEnabled()
+    {
+        LLVMTypeConverterHelper llvmtch((LLVMTypeConverter &)tch.typeConverter);
+        return llvmtch.getPointerBitwidth(0) == 64;
+    }
+
+    bool canBeInlined(mlir::Type llvmType)
+    {
+        return (llvmType.isa<mlir::IntegerType>() || llvmType.isF16() || llvmType.isF32()) &&
+               llvmType.getIntOrFloatBitWidth() <= 32;
+    }
+
+    mlir::Value getBits(mlir::Value in)
+    {
+        return rewriter.create<LLVM::PtrToIntOp>(loc, th.getI64Type(), in);
+    }
+
+    mlir::Value getHighBits(mlir::Value in)
+    {
+        return rewriter.create<LLVM::LShrOp>(loc, getBits(in), clh.createI64ConstantOf(48));
+    }
+
+    mlir::Value getPointerKindBits(mlir::Value in)
+    {
+        return rewriter.create<LLVM::AndOp>(loc, getBits(in), clh.createI64ConstantOf(POINTER_KIND_MASK));
+    }
+
+    // top 16 bits and kind bits are 0
+    mlir::Value isHeapBox(mlir::Value in)
+    {
+        auto maskedBits = rewriter.create<LLVM::AndOp>(loc, getBits(in), clh.createI64ConstantOf(HIGH_BITS_MASK | POINTER_KIND_MASK));
+        return rewriter.create<LLVM::ICmpOp>(loc, LLVM::ICmpPredicate::eq, maskedBits, clh.createI64ConstantOf(0));
+    }
+
+    // top 16 bits are 0 and kind bits are not
+    mlir::Value isInlinePointer(mlir::Value in)
+    {
+        auto isLow = rewriter.create<LLVM::ICmpOp>(loc, LLVM::ICmpPredicate::eq, getHighBits(in), clh.createI64ConstantOf(0));
+        auto hasKind =
+            rewriter.create<LLVM::ICmpOp>(loc, LLVM::ICmpPredicate::ne, getPointerKindBits(in), clh.createI64ConstantOf(0));
+        return rewriter.create<LLVM::AndOp>(loc, isLow, hasKind);
+    }
+
+    // pointer which is not 8-byte aligned (for example global string constant) or above 2^48 is stored in heap box
+    mlir::Value encodePointer(mlir::Value in, int pointerKind, mlir::Value typeOfValue, mlir::Type inLLVMType)
+    {
+        auto bits = getBits(in);
+        auto maskedBits = rewriter.create<LLVM::AndOp>(loc, bits, clh.createI64ConstantOf(HIGH_BITS_MASK | POINTER_KIND_MASK));
+        auto isAligned = rewriter.create<LLVM::ICmpOp>(loc, LLVM::ICmpPredicate::eq, maskedBits, clh.createI64ConstantOf(0));
+        return clh.conditionalExpressionLowering(
+            th.getI8PtrType(), isAligned,
+            [&](OpBuilder &builder, Location loc) {
+                auto taggedBits = rewriter.create<LLVM::OrOp>(loc, bits, clh.createI64ConstantOf(pointerKind));
+                return rewriter.create<LLVM::IntToPtrOp>(loc, th.getI8PtrType(), taggedBits);
+            },
+            [&](OpBuilder &builder, Location loc) { return castToAnyInHeap(in, typeOfValue, inLLVMType); });
+    }
+
+    mlir::Value decodePointer(mlir::Value in, mlir::Type resLLVMType)
+    {
+        auto bits = rewriter.create<LLVM::AndOp>(loc, getBits(in), clh.createI64ConstantOf(~POINTER_KIND_MASK));
+        return rewriter.create<LLVM::IntToPtrOp>(loc, resLLVMType, bits);
+    }
+
+    mlir::Value encodeNumber(mlir::Value in)
+    {
+        auto isNaN = rewriter.create<LLVM::FCmpOp>(loc, LLVM::FCmpPredicate::uno, in, in);
+        mlir::Value bits = rewriter.create<LLVM::BitcastOp>(loc, th.getI64Type(), in);
+        bits = rewriter.create<LLVM::SelectOp>(loc, isNaN, clh.createI64ConstantOf(CANONICAL_NAN), bits);
+        bits = rewriter.create<LLVM::AddOp>(loc, bits, clh.createI64ConstantOf(NUMBER_OFFSET));
+        return rewriter.create<LLVM::IntToPtrOp>(loc, th.getI8PtrType(), bits);
+    }
+
+    mlir::Value decodeNumber(mlir::Value in)
+    {
+        auto bits = rewriter.create<LLVM::SubOp>(loc, getBits(in), clh.createI64ConstantOf(NUMBER_OFFSET));
+        return rewriter.create<LLVM::BitcastOp>(loc, th.getF64Type(), bits);
+    }
+
+    mlir::Value encodeInline(mlir::Value in, int typeId)
+    {
+        auto width = in.getType().getIntOrFloatBitWidth();
+        mlir::Value value = in;
+        if (!value.getType().isa<mlir::IntegerType>())
+        {
+            value = rewriter.create<LLVM::BitcastOp>(loc, rewriter.getIntegerType(width), value);
+        }
+
+        mlir::Value bits = rewriter.create<LLVM::ZExtOp>(loc, th.getI64Type(), value);
+        auto tag = (INLINE_TAG << 48) | (static_cast<int64_t>(typeId) << 32);
+        bits = rewriter.create<LLVM::OrOp>(loc, bits, clh.createI64ConstantOf(tag));
+        return rewriter.create<LLVM::IntToPtrOp>(loc, th.getI8PtrType(), bits);
+    }
+
+    mlir::Value decodeInline(mlir::Value in, mlir::Type resLLVMType)
+    {
+        auto width = resLLVMType.getIntOrFloatBitWidth();
+        mlir::Value value = rewriter.create<LLVM::TruncOp>(loc, rewriter.getIntegerType(width), getBits(in));
+        if (!resLLVMType.isa<mlir::IntegerType>())
+        {
+            value = rewriter.create<LLVM::BitcastOp>(loc, resLLVMType, value);
+        }
+
+        return value;
+    }
 };
 } // namespace typescript
 
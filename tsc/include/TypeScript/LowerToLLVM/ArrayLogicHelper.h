@@ -0,0 +1,135 @@
+#ifndef MLIR_TYPESCRIPT_LOWERTOLLVMLOGIC_ARRAYLOGICHELPER_H_
+#define MLIR_TYPESCRIPT_LOWERTOLLVMLOGIC_ARRAYLOGICHELPER_H_
+
+#include "TypeScript/Config.h"
+#include "TypeScript/Defines.h"
+#include "TypeScript/Passes.h"
+#include "TypeScript/TypeScriptDialect.h"
+#include "TypeScript/TypeScriptOps.h"
+
+#include "TypeScript/LowerToLLVM/TypeHelper.h"
+#include "TypeScript/LowerToLLVM/TypeConverterHelper.h"
+#include "TypeScript/LowerToLLVM/CodeLogicHelper.h"
+#include "TypeScript/LowerToLLVM/LLVMCodeHelperBase.h"
+
+using namespace mlir;
+namespace mlir_ts = mlir::typescript;
+
+namespace typescript
+{
+
+// array is { T* data, i32 length, i32 capacity }, capacity grows at least twice, so pushing is amortized O(1).
+// Data of array created from constant is not owned by array (capacity is 0), it is copied when array grows.
+class ArrayLogicHelper
+{
+    Operation *op;
+    PatternRewriter &rewriter;
+    TypeConverterHelper &tch;
+    TypeHelper th;
+    LLVMCodeHelperBase ch;
+    CodeLogicHelper clh;
+    Location loc;
+
+  public:
+    ArrayLogicHelper(Operation *op, PatternRewriter &rewriter, TypeConverterHelper &tch)
+        : op(op), rewriter(rewriter), tch(tch), th(rewriter), ch(op, rewriter, &tch.typeConverter), clh(op, rewriter),
+          loc(op->getLoc())
+    {
+    }
+
+    mlir::Value fieldRef(mlir::Value arrayRef, mlir::Type fieldType, int index)
+    {
+        auto ind0 = clh.createI32ConstantOf(0);
+        auto indField = clh.createI32ConstantOf(index);
+        return rewriter.create<LLVM::GEPOp>(loc, th.getPointerType(fieldType), arrayRef, ValueRange{ind0, indField});
+    }
+
+    mlir::Value dataRef(mlir::Value arrayRef, mlir_ts::ArrayType arrayType)
+    {
+        return fieldRef(arrayRef, th.getPointerType(tch.convertType(arrayType.getElementType())), 0);
+    }
+
+    mlir::Value lengthRef(mlir::Value arrayRef)
+    {
+        return fieldRef(arrayRef, th.getI32Type(), 1);
+    }
+
+    mlir::Value capacityRef(mlir::Value arrayRef)
+    {
+        return fieldRef(arrayRef, th.getI32Type(), 2);
+    }
+
+    // loads i32 field as index
+    mlir::Value loadAsIndex(mlir::Value i32Ref)
+    {
+        auto value = rewriter.create<LLVM::LoadOp>(loc, th.getI32Type(), i32Ref);
+        return rewriter.create<LLVM::ZExtOp>(loc, th.getIndexType(), value);
+    }
+
+    void storeAsI32(mlir::Value indexValue, mlir::Value i32Ref)
+    {
+        auto value = rewriter.create<LLVM::TruncOp>(loc, th.getI32Type(), indexValue);
+        rewriter.create<LLVM::StoreOp>(loc, value, i32Ref);
+    }
+
+    // grows data of array (kept by reference) to keep 'newLength' elements (index type), returns pointer to data
+    mlir::Value ensureCapacity(mlir::Value arrayRef, mlir_ts::ArrayType arrayType, mlir::Value newLength)
+    {
+        auto indexType = th.getIndexType();
+        auto llvmPtrElementType = th.getPointerType(tch.convertType(arrayType.getElementType()));
+
+        auto dataPtrRef = dataRef(arrayRef, arrayType);
+        mlir::Value data = rewriter.create<LLVM::LoadOp>(loc, llvmPtrElementType, dataPtrRef);
+        auto length = loadAsIndex(lengthRef(arrayRef));
+        auto capacityPtrRef = capacityRef(arrayRef);
+        auto capacity = loadAsIndex(capacityPtrRef);
+
+        auto needGrow = rewriter.create<LLVM::ICmpOp>(loc, LLVM::ICmpPredicate::ugt, newLength, capacity);
+        return clh.conditionalExpressionLowering(
+            llvmPtrElementType, needGrow,
+            [&](OpBuilder &builder, Location loc) {
+                mlir::Value doubleCapacity = rewriter.create<LLVM::AddOp>(loc, indexType, ValueRange{capacity, capacity});
+                auto isDoubleEnough =
+                    rewriter.create<LLVM::ICmpOp>(loc, LLVM::ICmpPredicate::uge, doubleCapacity, newLength);
+                mlir::Value newCapacity =
+                    rewriter.create<LLVM::SelectOp>(loc, isDoubleEnough, doubleCapacity, newLength);
+
+                auto sizeOfTypeValue =
+                    rewriter.create<mlir_ts::SizeOfOp>(loc, indexType, arrayType.getElementType());
+                auto newSize = rewriter.create<LLVM::MulOp>(loc, indexType, ValueRange{sizeOfTypeValue, newCapacity});
+
+                // not owned data (capacity is 0) is copied into new memory, length can't tell it as it is 0 after pop
+                auto isOwned = rewriter.create<LLVM::ICmpOp>(loc, LLVM::ICmpPredicate::ne, capacity,
+                                                             clh.createIndexConstantOf(0));
+                auto nullPtr = rewriter.create<LLVM::NullOp>(loc, llvmPtrElementType);
+                auto ptrToRealloc = rewriter.create<LLVM::SelectOp>(loc, isOwned, data, nullPtr);
+                auto allocated = ch.MemoryReallocBitcast(llvmPtrElementType, ptrToRealloc, newSize);
+
+                auto lengthSize = rewriter.create<LLVM::MulOp>(loc, indexType, ValueRange{sizeOfTypeValue, length});
+                auto copySize = rewriter.create<LLVM::SelectOp>(loc, isOwned, clh.createI64ConstantOf(0), lengthSize);
+                copy(allocated, data, copySize);
+
+                rewriter.create<LLVM::StoreOp>(loc, allocated, dataPtrRef);
+                storeAsI32(newCapacity, capacityPtrRef);
+
+                return allocated;
+            },
+            [&](OpBuilder &builder, Location loc) { return data; });
+    }
+
+    void copy(mlir::Value dest, mlir::Value src, mlir::Value size)
+    {
+        auto i8PtrTy = th.getI8PtrType();
+        auto copyMemFuncOp = ch.getOrInsertFunction(
+            "llvm.memcpy.p0i8.p0i8.i64",
+            th.getFunctionType(th.getVoidType(), {i8PtrTy, i8PtrTy, th.getI64Type(), th.getLLVMBoolType()}));
+
+        auto destI8Ptr = rewriter.create<LLVM::BitcastOp>(loc, i8PtrTy, dest);
+        auto srcI8Ptr = rewriter.create<LLVM::BitcastOp>(loc, i8PtrTy, src);
+        rewriter.create<LLVM::CallOp>(loc, copyMemFuncOp,
+                                      ValueRange{destI8Ptr, srcI8Ptr, size, clh.createI1ConstantOf(false)});
+    }
+};
+} // namespace typescript
+
+#endif // MLIR_TYPESCRIPT_LOWERTOLLVMLOGIC_ARRAYLOGICHELPER_H_
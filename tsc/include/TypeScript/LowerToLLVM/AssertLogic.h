@@ -98,6 +98,10 @@ class AssertLogic
 
         mlir::Value lineNumberRes = rewriter.create<LLVM::ConstantOp>(loc, rewriter.getI32Type(), rewriter.getI32IntegerAttr(line));
 
+        // output of 'print' is flushed before process is aborted
+        auto flushFuncOp = ch.getOrInsertFunction(OUTPUT_FLUSH_NAME, th.getFunctionType(th.getVoidType(), ArrayRef<mlir::Type>{}));
+        rewriter.create<LLVM::CallOp>(loc, flushFuncOp, ValueRange{});
+
         rewriter.create<LLVM::CallOp>(loc, assertFuncOp, ValueRange{msgCst, fileCst, lineNumberRes});
         // rewriter.create<LLVM::UnreachableOp>(loc);
         rewriter.create<mlir::BranchOp>(loc, unreachable);
@@ -158,6 +162,10 @@ class AssertLogic
         mlir::Value lineNumberRes = rewriter.create<LLVM::ConstantOp>(loc, rewriter.getI32Type(), rewriter.getI32IntegerAttr(line));
         mlir::Value funcName = rewriter.create<LLVM::NullOp>(loc, i8PtrTy);
 
+        // output of 'print' is flushed before process is aborted
+        auto flushFuncOp = ch.getOrInsertFunction(OUTPUT_FLUSH_NAME, th.getFunctionType(th.getVoidType(), ArrayRef<mlir::Type>{}));
+        rewriter.create<LLVM::CallOp>(loc, flushFuncOp, ValueRange{});
+
         rewriter.create<LLVM::CallOp>(loc, assertFuncOp, ValueRange{msgCst, fileCst, lineNumberRes, funcName});
         // rewriter.create<LLVM::UnreachableOp>(loc);
         rewriter.create<mlir::BranchOp>(loc, unreachable);
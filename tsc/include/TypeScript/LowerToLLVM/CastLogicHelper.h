@@ -15,6 +15,7 @@
 #include "TypeScript/LowerToLLVM/CodeLogicHelper.h"
 #include "TypeScript/LowerToLLVM/LLVMCodeHelper.h"
 #include "TypeScript/LowerToLLVM/ConvertLogic.h"
+#include "TypeScript/LowerToLLVM/StringLogicHelper.h"
 #include "TypeScript/LowerToLLVM/AnyLogic.h"
 #include "TypeScript/LowerToLLVM/LLVMCodeHelperBase.h"
 
@@ -101,6 +102,12 @@ class CastLogicHelper
             return castF32orF64ToString(in);
         }
 
+        if (isResString && isCStringType(inType))
+        {
+            StringLogicHelper slh(op, rewriter, tch);
+            return slh.fromExternal(clh.castToI8Ptr(in));
+        }
+
         if (auto arrType = resType.dyn_cast_or_null<mlir_ts::ArrayType>())
         {
             return castToArrayType(in, inType, resType);
@@ -159,12 +166,7 @@ class CastLogicHelper
         {
             if (auto inBoundFunc = inType.dyn_cast_or_null<mlir_ts::BoundFunctionType>())
             {
-                // somehow llvm.trampoline accepts only direct method symbol
-                /*
-                auto thisVal = rewriter.create<mlir_ts::GetThisOp>(loc, mlir_ts::OpaqueType::get(rewriter.getContext()), in);
-                auto methodVal = rewriter.create<mlir_ts::GetMethodOp>(loc, resFuncType, in);
-                return rewriter.create<mlir_ts::TrampolineOp>(loc, resFuncType, methodVal, thisVal);
-                */
+                // plain function pointer can't keep 'this', keep function as HybridFunction (see 'let' of function type)
                 op->emitWarning("losing this reference");
                 /*
                 // you can wrap into () => {} lambda call to capture vars
@@ -768,7 +770,12 @@ class CastLogicHelper
         auto structValue3 =
             rewriter.create<LLVM::InsertValueOp>(loc, llvmRtArrayStructType, structValue2, sizeValue, clh.getStructIndexAttr(1));
 
-        return structValue3;
+        // data is not owned when it is not copied
+        auto capacityValue = byValue ? sizeValue : clh.createI32ConstantOf(0);
+        auto structValue4 =
+            rewriter.create<LLVM::InsertValueOp>(loc, llvmRtArrayStructType, structValue3, capacityValue, clh.getStructIndexAttr(2));
+
+        return structValue4;
     }
 
     mlir::Value castToAny(mlir::Value in, mlir::Type inType, mlir::Type inLLVMType)
@@ -837,6 +844,18 @@ class CastLogicHelper
         return results.getResult(0);
     }
 
+    // pointer to chars (i8*) which came from outside, it does not have header of string
+    bool isCStringType(mlir::Type type)
+    {
+        if (auto refType = type.dyn_cast_or_null<mlir_ts::RefType>())
+        {
+            auto elementType = refType.getElementType();
+            return elementType.isa<mlir_ts::CharType>() || elementType.isInteger(8);
+        }
+
+        return false;
+    }
+
     mlir::Value castBoundRefToRef(mlir::Value in, mlir_ts::BoundRefType boundRefTypeIn, mlir_ts::RefType refTypeOut)
     {
         auto llvmType = tch.convertType(boundRefTypeIn.getElementType());
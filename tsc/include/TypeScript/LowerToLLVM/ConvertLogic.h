@@ -12,6 +12,9 @@
 #include "TypeScript/LowerToLLVM/LLVMTypeConverterHelper.h"
 #include "TypeScript/LowerToLLVM/CodeLogicHelper.h"
 #include "TypeScript/LowerToLLVM/LLVMCodeHelperBase.h"
+#include "TypeScript/LowerToLLVM/StringLogicHelper.h"
+
+#include <limits>
 
 using namespace mlir;
 namespace mlir_ts = mlir::typescript;
@@ -27,6 +30,7 @@ class ConvertLogic
     TypeHelper th;
     LLVMCodeHelperBase ch;
     CodeLogicHelper clh;
+    StringLogicHelper slh;
     Location loc;
 
   protected:
@@ -35,134 +39,465 @@ class ConvertLogic
 
   public:
     ConvertLogic(Operation *op, PatternRewriter &rewriter, TypeConverterHelper &tch, Location loc)
-        : op(op), rewriter(rewriter), tch(tch), th(rewriter), ch(op, rewriter, &tch.typeConverter), clh(op, rewriter), loc(loc)
+        : op(op), rewriter(rewriter), tch(tch), th(rewriter), ch(op, rewriter, &tch.typeConverter), clh(op, rewriter),
+          slh(op, rewriter, tch), loc(loc)
     {
         sizeType = th.getIndexType();
         typeOfValueType = th.getI8PtrType();
     }
 
-    mlir::Value itoa(mlir::Value value)
+    // number of chars of buffer for i64 in decimal form with sign
+    static constexpr int64_t int64BufferSize = 24;
+    // number of chars of buffer for double in "%.16e" form or in JavaScript notation
+    static constexpr int64_t doubleBufferSize = 32;
+    // strings with up to 15 decimal digits are parsed without C runtime, any of such numbers is exact double
+    static constexpr int64_t maxFastParseDigits = 15;
+
+    mlir::Value intToString(mlir::Value value)
     {
-        auto i8PtrTy = th.getI8PtrType();
+        return toString(intToChars(value));
+    }
 
-        auto _itoaFuncOp = ch.getOrInsertFunction(
-            "_itoa", th.getFunctionType(th.getI8PtrType(),
-                                        ArrayRef<mlir::Type>{rewriter.getI32Type(), th.getI8PtrType(), rewriter.getI32Type()}, true));
+    mlir::Value int64ToString(mlir::Value value)
+    {
+        return toString(int64ToChars(value));
+    }
 
-        auto bufferSizeValue = clh.createI32ConstantOf(50);
-        // auto newStringValue = rewriter.create<LLVM::AllocaOp>(loc, i8PtrTy, bufferSizeValue, true);
-        auto newStringValue = ch.MemoryAllocBitcast(i8PtrTy, bufferSizeValue);
-        auto base = clh.createI32ConstantOf(10);
+    mlir::Value f32OrF64ToString(mlir::Value value)
+    {
+        return toString(f32OrF64ToChars(value));
+    }
 
-        return rewriter.create<LLVM::CallOp>(loc, _itoaFuncOp, ValueRange{value, newStringValue, base}).getResult(0);
+    // conversions to chars return pointer to chars (in stack or constant, not terminated with zero) and number of chars
+    // (i64), 'print' writes them to output as is, conversion to string copies them into string of exact length
+    std::pair<mlir::Value, mlir::Value> intToChars(mlir::Value value)
+    {
+        return int64ToChars(rewriter.create<LLVM::SExtOp>(loc, th.getI64Type(), value));
     }
 
-    mlir::Value i64toa(mlir::Value value)
+    // digits are written from the end of buffer
+    std::pair<mlir::Value, mlir::Value> int64ToChars(mlir::Value value)
     {
         auto i8PtrTy = th.getI8PtrType();
+        auto i64Ty = th.getI64Type();
+
+        auto buffer = allocaInFuncTop(int64BufferSize);
+        auto isNegative = rewriter.create<LLVM::ICmpOp>(loc, LLVM::ICmpPredicate::slt, value, clh.createI64ConstantOf(0));
+        auto negValue = rewriter.create<LLVM::SubOp>(loc, i64Ty, ValueRange{clh.createI64ConstantOf(0), value});
+        // INT64_MIN is kept as unsigned value
+        auto absValue = rewriter.create<LLVM::SelectOp>(loc, isNegative, negValue, value);
+
+        auto *opBlock = rewriter.getInsertionBlock();
+        auto *continuationBlock = rewriter.splitBlock(opBlock, rewriter.getInsertionPoint());
+
+        // loop block: position of last written char and value of digits which are not written yet
+        auto *loopBlock = rewriter.createBlock(continuationBlock, TypeRange{i64Ty, i64Ty});
+        auto position = loopBlock->getArgument(0);
+        auto rest = loopBlock->getArgument(1);
+        auto ten = clh.createI64ConstantOf(10);
+        auto digitPosition = rewriter.create<LLVM::SubOp>(loc, i64Ty, ValueRange{position, clh.createI64ConstantOf(1)});
+        auto digit = rewriter.create<LLVM::URemOp>(loc, i64Ty, ValueRange{rest, ten});
+        auto digitChar = rewriter.create<LLVM::AddOp>(loc, i64Ty, ValueRange{digit, clh.createI64ConstantOf('0')});
+        rewriter.create<LLVM::StoreOp>(loc, rewriter.create<LLVM::TruncOp>(loc, th.getI8Type(), digitChar),
+                                       rewriter.create<LLVM::GEPOp>(loc, i8PtrTy, buffer, ValueRange{digitPosition}));
+        auto nextRest = rewriter.create<LLVM::UDivOp>(loc, i64Ty, ValueRange{rest, ten});
+        auto hasMore = rewriter.create<LLVM::ICmpOp>(loc, LLVM::ICmpPredicate::ne, nextRest, clh.createI64ConstantOf(0));
+
+        // result block: position of first digit
+        auto *resultBlock = rewriter.createBlock(continuationBlock, TypeRange{i64Ty});
+        auto firstDigitPosition = resultBlock->getArgument(0);
+        // there are at most 20 digits, so buffer always has space for sign
+        auto signPosition =
+            rewriter.create<LLVM::SubOp>(loc, i64Ty, ValueRange{firstDigitPosition, clh.createI64ConstantOf(1)});
+        rewriter.create<LLVM::StoreOp>(loc, clh.createI8ConstantOf('-'),
+                                       rewriter.create<LLVM::GEPOp>(loc, i8PtrTy, buffer, ValueRange{signPosition}));
+        auto start = rewriter.create<LLVM::SelectOp>(loc, isNegative, signPosition, firstDigitPosition);
+        rewriter.create<LLVM::BrOp>(loc, ValueRange{}, continuationBlock);
+
+        rewriter.setInsertionPointToEnd(loopBlock);
+        rewriter.create<LLVM::CondBrOp>(loc, hasMore, loopBlock, ValueRange{digitPosition, nextRest}, resultBlock,
+                                        ValueRange{digitPosition});
+
+        rewriter.setInsertionPointToEnd(opBlock);
+        rewriter.create<LLVM::BrOp>(loc, ValueRange{clh.createI64ConstantOf(int64BufferSize), absValue}, loopBlock);
+
+        rewriter.setInsertionPointToStart(continuationBlock);
+
+        auto len = rewriter.create<LLVM::SubOp>(loc, i64Ty, ValueRange{clh.createI64ConstantOf(int64BufferSize), start});
+        auto chars = rewriter.create<LLVM::GEPOp>(loc, i8PtrTy, buffer, ValueRange{start});
+        return {chars, len};
+    }
 
-        auto _i64toaFuncOp = ch.getOrInsertFunction(
-            "_i64toa", th.getFunctionType(th.getI8PtrType(),
-                                          ArrayRef<mlir::Type>{rewriter.getI64Type(), th.getI8PtrType(), rewriter.getI32Type()}, true));
-
-        auto bufferSizeValue = clh.createI32ConstantOf(50);
-        // auto newStringValue = rewriter.create<LLVM::AllocaOp>(loc, i8PtrTy, bufferSizeValue, true);
-        auto newStringValue = ch.MemoryAllocBitcast(i8PtrTy, bufferSizeValue);
-        auto base = clh.createI32ConstantOf(10);
-
-        return rewriter.create<LLVM::CallOp>(loc, _i64toaFuncOp, ValueRange{value, newStringValue, base}).getResult(0);
+    // integer values (up to 2^53) are converted as i64, other values are printed with the least precision which
+    // gives the same value back in JavaScript notation, NaN and Infinity are spelled as in JavaScript
+    std::pair<mlir::Value, mlir::Value> f32OrF64ToChars(mlir::Value value)
+    {
+        auto i64Ty = th.getI64Type();
+
+        mlir::Value doubleValue = value;
+        if (value.getType().isF32())
+        {
+            doubleValue = rewriter.create<LLVM::FPExtOp>(loc, th.getF64Type(), value);
+        }
+
+        // fptosi of value out of range of i64 is poison, so only safe integers are converted
+        auto maxSafeInteger = clh.createF64ConstantOf(9007199254740992.0);
+        auto minSafeInteger = clh.createF64ConstantOf(-9007199254740992.0);
+        auto isInRange = rewriter.create<LLVM::AndOp>(
+            loc, rewriter.create<LLVM::FCmpOp>(loc, LLVM::FCmpPredicate::olt, doubleValue, maxSafeInteger),
+            rewriter.create<LLVM::FCmpOp>(loc, LLVM::FCmpPredicate::ogt, doubleValue, minSafeInteger));
+        auto safeValue = rewriter.create<LLVM::SelectOp>(loc, isInRange, doubleValue, clh.createF64ConstantOf(0.0));
+        auto intValue = rewriter.create<LLVM::FPToSIOp>(loc, i64Ty, safeValue);
+        auto intAsDouble = rewriter.create<LLVM::SIToFPOp>(loc, th.getF64Type(), intValue);
+        auto isInteger = rewriter.create<LLVM::AndOp>(
+            loc, isInRange, rewriter.create<LLVM::FCmpOp>(loc, LLVM::FCmpPredicate::oeq, intAsDouble, doubleValue));
+
+        return conditional(
+            isInteger, [&]() { return int64ToChars(intValue); },
+            [&]() {
+                auto isNaN = rewriter.create<LLVM::FCmpOp>(loc, LLVM::FCmpPredicate::uno, doubleValue, doubleValue);
+                return conditional(
+                    isNaN,
+                    [&]() -> std::pair<mlir::Value, mlir::Value> {
+                        return {ch.getOrCreateGlobalString("__nan__", std::string("NaN")), clh.createI64ConstantOf(3)};
+                    },
+                    [&]() {
+                        auto inf = std::numeric_limits<double>::infinity();
+                        auto isPosInf = rewriter.create<LLVM::FCmpOp>(loc, LLVM::FCmpPredicate::oeq, doubleValue,
+                                                                      clh.createF64ConstantOf(inf));
+                        auto isNegInf = rewriter.create<LLVM::FCmpOp>(loc, LLVM::FCmpPredicate::oeq, doubleValue,
+                                                                      clh.createF64ConstantOf(-inf));
+                        auto isInf = rewriter.create<LLVM::OrOp>(loc, isPosInf, isNegInf);
+                        return conditional(
+                            isInf,
+                            [&]() -> std::pair<mlir::Value, mlir::Value> {
+                                auto chars = rewriter.create<LLVM::SelectOp>(
+                                    loc, isPosInf, ch.getOrCreateGlobalString("__infinity__", std::string("Infinity")),
+                                    ch.getOrCreateGlobalString("__neg_infinity__", std::string("-Infinity")));
+                                auto len = rewriter.create<LLVM::SelectOp>(loc, isPosInf, clh.createI64ConstantOf(8),
+                                                                           clh.createI64ConstantOf(9));
+                                return {chars, len};
+                            },
+                            [&]() { return shortestToChars(doubleValue); });
+                    });
+            });
     }
 
-    mlir::Value gcvt(mlir::Value in)
+    // tries precisions 15, 16 and 17 ("%.16e" always gives the same double back), digits and exponent are written
+    // in JavaScript notation by 'toJsNotation'
+    std::pair<mlir::Value, mlir::Value> shortestToChars(mlir::Value doubleValue)
     {
         auto i8PtrTy = th.getI8PtrType();
+        auto i32Ty = th.getI32Type();
+
+        auto snprintfFuncOp = getSnprintf();
+        auto strtodFuncOp =
+            ch.getOrInsertFunction("strtod", th.getFunctionType(th.getF64Type(), {i8PtrTy, th.getI8PtrPtrType()}));
+
+        auto isNegative =
+            rewriter.create<LLVM::FCmpOp>(loc, LLVM::FCmpPredicate::olt, doubleValue, clh.createF64ConstantOf(0.0));
+        auto negValue = rewriter.create<LLVM::FNegOp>(loc, th.getF64Type(), doubleValue);
+        auto absValue = rewriter.create<LLVM::SelectOp>(loc, isNegative, negValue, doubleValue);
+
+        auto buffer = allocaInFuncTop(doubleBufferSize);
+        auto format = ch.getOrCreateGlobalString("__frmt_precision_e__", std::string("%.*e"));
+
+        auto *opBlock = rewriter.getInsertionBlock();
+        auto *continuationBlock = rewriter.splitBlock(opBlock, rewriter.getInsertionPoint());
+
+        // loop block: number of digits
+        auto *loopBlock = rewriter.createBlock(continuationBlock, TypeRange{i32Ty});
+        auto precision = loopBlock->getArgument(0);
+        auto digitsAfterPoint =
+            rewriter.create<LLVM::SubOp>(loc, i32Ty, ValueRange{precision, clh.createI32ConstantOf(1)});
+        rewriter.create<LLVM::CallOp>(
+            loc, snprintfFuncOp,
+            ValueRange{buffer, clh.createI32ConstantOf(doubleBufferSize), format, digitsAfterPoint, absValue});
+        auto nullPtr = rewriter.create<LLVM::NullOp>(loc, th.getI8PtrPtrType());
+        auto parsed = rewriter.create<LLVM::CallOp>(loc, strtodFuncOp, ValueRange{buffer, nullPtr});
+        auto isSame = rewriter.create<LLVM::FCmpOp>(loc, LLVM::FCmpPredicate::oeq, parsed.getResult(0), absValue);
+        auto isLast =
+            rewriter.create<LLVM::ICmpOp>(loc, LLVM::ICmpPredicate::eq, precision, clh.createI32ConstantOf(17));
+        auto isDone = rewriter.create<LLVM::OrOp>(loc, isSame, isLast);
+        auto nextPrecision = rewriter.create<LLVM::AddOp>(loc, i32Ty, ValueRange{precision, clh.createI32ConstantOf(1)});
+
+        // result block: number of digits
+        auto *resultBlock = rewriter.createBlock(continuationBlock, TypeRange{i32Ty});
+        rewriter.create<LLVM::BrOp>(loc, ValueRange{}, continuationBlock);
+
+        rewriter.setInsertionPointToEnd(loopBlock);
+        rewriter.create<LLVM::CondBrOp>(loc, isDone, resultBlock, ValueRange{precision}, loopBlock,
+                                        ValueRange{nextPrecision});
+
+        rewriter.setInsertionPointToEnd(opBlock);
+        rewriter.create<LLVM::BrOp>(loc, ValueRange{clh.createI32ConstantOf(15)}, loopBlock);
+
+        rewriter.setInsertionPointToStart(continuationBlock);
+
+        return toJsNotation(buffer, resultBlock->getArgument(0), isNegative);
+    }
 
-        auto _gcvtFuncOp = ch.getOrInsertFunction(
-            "_gcvt", th.getFunctionType(th.getI8PtrType(),
-                                        ArrayRef<mlir::Type>{rewriter.getF64Type(), rewriter.getI32Type(), th.getI8PtrType()}, true));
-
-        auto bufferSizeValue = clh.createI32ConstantOf(50);
-        // auto newStringValue = rewriter.create<LLVM::AllocaOp>(loc, i8PtrTy, bufferSizeValue, true);
-        auto newStringValue = ch.MemoryAllocBitcast(i8PtrTy, bufferSizeValue);
-        auto doubleValue = rewriter.create<LLVM::FPExtOp>(loc, rewriter.getF64Type(), in);
-        auto precision = clh.createI32ConstantOf(16);
-
-        return rewriter.create<LLVM::CallOp>(loc, _gcvtFuncOp, ValueRange{doubleValue, precision, newStringValue}).getResult(0);
+    // 'buffer' keeps "d.ddde+XX" ("de+XX" for one digit) with 'count' digits, value is 0.ddd * 10^n. As in
+    // JavaScript, fixed notation is used for 1e-7 < value < 1e21, exponent is written without leading zeros
+    std::pair<mlir::Value, mlir::Value> toJsNotation(mlir::Value buffer, mlir::Value count, mlir::Value isNegative)
+    {
+        auto i8PtrTy = th.getI8PtrType();
+        auto i8Ty = th.getI8Type();
+        auto i32Ty = th.getI32Type();
+
+        auto snprintfFuncOp = getSnprintf();
+        auto strtolFuncOp =
+            ch.getOrInsertFunction("strtol", th.getFunctionType(i32Ty, {i8PtrTy, th.getI8PtrPtrType(), i32Ty}));
+
+        auto one = clh.createI32ConstantOf(1);
+        auto hasPoint = rewriter.create<LLVM::ICmpOp>(loc, LLVM::ICmpPredicate::sgt, count, one);
+        auto countPlusOne = rewriter.create<LLVM::AddOp>(loc, i32Ty, ValueRange{count, one});
+        auto ePosition = rewriter.create<LLVM::SelectOp>(loc, hasPoint, countPlusOne, one);
+        auto exponentPosition = rewriter.create<LLVM::AddOp>(loc, i32Ty, ValueRange{ePosition, one});
+        auto exponentChars = rewriter.create<LLVM::GEPOp>(loc, i8PtrTy, buffer, ValueRange{exponentPosition});
+        auto nullPtr = rewriter.create<LLVM::NullOp>(loc, th.getI8PtrPtrType());
+        auto exponent =
+            rewriter
+                .create<LLVM::CallOp>(loc, strtolFuncOp, ValueRange{exponentChars, nullPtr, clh.createI32ConstantOf(10)})
+                .getResult(0);
+        auto n = rewriter.create<LLVM::AddOp>(loc, i32Ty, ValueRange{exponent, one});
+
+        // first digit is moved in place of '.', so all digits are together
+        auto firstDigit = rewriter.create<LLVM::LoadOp>(loc, i8Ty, buffer);
+        auto digits = rewriter.create<LLVM::GEPOp>(loc, i8PtrTy, buffer, ValueRange{one});
+        rewriter.create<LLVM::StoreOp>(loc, firstDigit, digits);
+
+        auto sign = rewriter.create<LLVM::SelectOp>(loc, isNegative,
+                                                    ch.getOrCreateGlobalString("__minus__", std::string("-")),
+                                                    ch.getOrCreateGlobalString("__empty__", std::string("")));
+        auto zeros = ch.getOrCreateGlobalString("__zeros__", std::string(21, '0'));
+        auto maxFixed = clh.createI32ConstantOf(21);
+
+        auto out = allocaInFuncTop(doubleBufferSize);
+        auto print = [&](StringRef name, StringRef format,
+                         ArrayRef<mlir::Value> args) -> std::pair<mlir::Value, mlir::Value> {
+            SmallVector<mlir::Value> values{out, clh.createI32ConstantOf(doubleBufferSize),
+                                            ch.getOrCreateGlobalString(name, format.str()), sign};
+            values.append(args.begin(), args.end());
+            auto written = rewriter.create<LLVM::CallOp>(loc, snprintfFuncOp, values);
+            return {out, rewriter.create<LLVM::ZExtOp>(loc, th.getI64Type(), written.getResult(0))};
+        };
+
+        auto lessOrEqualMax = rewriter.create<LLVM::ICmpOp>(loc, LLVM::ICmpPredicate::sle, n, maxFixed);
+        auto isInteger = rewriter.create<LLVM::AndOp>(
+            loc, rewriter.create<LLVM::ICmpOp>(loc, LLVM::ICmpPredicate::sge, n, count), lessOrEqualMax);
+        return conditional(
+            isInteger,
+            [&]() {
+                // 123000
+                auto zerosCount = rewriter.create<LLVM::SubOp>(loc, i32Ty, ValueRange{n, count});
+                return print("__frmt_js_integer__", "%s%.*s%.*s", {count, digits, zerosCount, zeros});
+            },
+            [&]() {
+                auto isFixed = rewriter.create<LLVM::AndOp>(
+                    loc, rewriter.create<LLVM::ICmpOp>(loc, LLVM::ICmpPredicate::sgt, n, clh.createI32ConstantOf(0)),
+                    lessOrEqualMax);
+                return conditional(
+                    isFixed,
+                    [&]() {
+                        // 12.3
+                        auto fractionCount = rewriter.create<LLVM::SubOp>(loc, i32Ty, ValueRange{count, n});
+                        auto fraction = rewriter.create<LLVM::GEPOp>(loc, i8PtrTy, digits, ValueRange{n});
+                        return print("__frmt_js_fixed__", "%s%.*s.%.*s", {n, digits, fractionCount, fraction});
+                    },
+                    [&]() {
+                        auto isSmall = rewriter.create<LLVM::AndOp>(
+                            loc,
+                            rewriter.create<LLVM::ICmpOp>(loc, LLVM::ICmpPredicate::sgt, n, clh.createI32ConstantOf(-6)),
+                            rewriter.create<LLVM::ICmpOp>(loc, LLVM::ICmpPredicate::sle, n, clh.createI32ConstantOf(0)));
+                        return conditional(
+                            isSmall,
+                            [&]() {
+                                // 0.000123
+                                auto zerosCount =
+                                    rewriter.create<LLVM::SubOp>(loc, i32Ty, ValueRange{clh.createI32ConstantOf(0), n});
+                                return print("__frmt_js_small__", "%s0.%.*s%.*s", {zerosCount, zeros, count, digits});
+                            },
+                            [&]() {
+                                // 1.23e-7, 1e+21
+                                auto point = rewriter.create<LLVM::SelectOp>(
+                                    loc, hasPoint, ch.getOrCreateGlobalString("__point__", std::string(".")),
+                                    ch.getOrCreateGlobalString("__empty__", std::string("")));
+                                auto fractionCount = rewriter.create<LLVM::SubOp>(loc, i32Ty, ValueRange{count, one});
+                                auto fraction = rewriter.create<LLVM::GEPOp>(loc, i8PtrTy, digits, ValueRange{one});
+                                return print("__frmt_js_exponent__", "%s%.1s%s%.*se%+d",
+                                             {digits, point, fractionCount, fraction, exponent});
+                            });
+                    });
+            });
     }
 
-    mlir::Value sprintf(int buffSize, std::string format, mlir::Value value)
+    LLVM::LLVMFuncOp getSnprintf()
     {
         auto i8PtrTy = th.getI8PtrType();
+        auto i32Ty = th.getI32Type();
 
 #ifdef WIN32
-        auto sprintfFuncOp = ch.getOrInsertFunction(
-            "sprintf_s", th.getFunctionType(rewriter.getI32Type(), {th.getI8PtrType(), rewriter.getI32Type(), th.getI8PtrType()}, true));
+        return ch.getOrInsertFunction("sprintf_s", th.getFunctionType(i32Ty, {i8PtrTy, i32Ty, i8PtrTy}, true));
 #else
-        auto sprintfFuncOp = ch.getOrInsertFunction(
-            "snprintf", th.getFunctionType(rewriter.getI32Type(), {th.getI8PtrType(), rewriter.getI32Type(), th.getI8PtrType()}, true));
+        return ch.getOrInsertFunction("snprintf", th.getFunctionType(i32Ty, {i8PtrTy, i32Ty, i8PtrTy}, true));
 #endif
+    }
 
-        auto bufferSizeValue = clh.createI32ConstantOf(buffSize);
-        // auto newStringValue = rewriter.create<LLVM::AllocaOp>(loc, i8PtrTy, bufferSizeValue, true);
-        auto newStringValue = ch.MemoryAllocBitcast(i8PtrTy, bufferSizeValue);
-
-        auto opHash = std::hash<std::string>{}(format);
-
-        std::stringstream formatVarName;
-        formatVarName << "frmt_" << opHash;
-
-        auto formatSpecifierCst = ch.getOrCreateGlobalString(formatVarName.str(), format);
-
-        rewriter.create<LLVM::CallOp>(loc, sprintfFuncOp, ValueRange{newStringValue, bufferSizeValue, formatSpecifierCst, value});
-
-        return newStringValue;
+    // JavaScript 'parseInt' without radix, i32 result
+    mlir::Value parseInt(mlir::Value str)
+    {
+        auto i8PtrTy = th.getI8PtrType();
+        auto i32Ty = th.getI32Type();
+
+        return parseDigits(
+            str, i32Ty, [&](mlir::Value digits) -> mlir::Value { return rewriter.create<LLVM::TruncOp>(loc, i32Ty, digits); },
+            [&]() -> mlir::Value {
+                auto strtolFuncOp = ch.getOrInsertFunction(
+                    "strtol", th.getFunctionType(i32Ty, {i8PtrTy, th.getI8PtrPtrType(), i32Ty}));
+                auto nullPtr = rewriter.create<LLVM::NullOp>(loc, th.getI8PtrPtrType());
+                return rewriter.create<LLVM::CallOp>(loc, strtolFuncOp, ValueRange{str, nullPtr, clh.createI32ConstantOf(10)})
+                    .getResult(0);
+            });
     }
 
-    mlir::Value sprintfOfInt(mlir::Value value)
+    // JavaScript 'parseFloat', NaN when string does not start with number, f64 result
+    mlir::Value parseFloat(mlir::Value str)
     {
-        return sprintf(50, "%d", value);
+        auto i8PtrTy = th.getI8PtrType();
+        auto f64Ty = th.getF64Type();
+
+        return parseDigits(
+            str, f64Ty, [&](mlir::Value digits) -> mlir::Value { return rewriter.create<LLVM::SIToFPOp>(loc, f64Ty, digits); },
+            [&]() -> mlir::Value {
+                auto strtodFuncOp =
+                    ch.getOrInsertFunction("strtod", th.getFunctionType(f64Ty, {i8PtrTy, th.getI8PtrPtrType()}));
+                auto endRef = allocaInFuncTop(th.getI8PtrType());
+                auto parsed = rewriter.create<LLVM::CallOp>(loc, strtodFuncOp, ValueRange{str, endRef});
+                auto end = rewriter.create<LLVM::LoadOp>(loc, endRef);
+                auto isEmpty = rewriter.create<LLVM::ICmpOp>(loc, LLVM::ICmpPredicate::eq, end, str);
+                return rewriter.create<LLVM::SelectOp>(
+                    loc, isEmpty, clh.createF64ConstantOf(std::numeric_limits<double>::quiet_NaN()),
+                    parsed.getResult(0));
+            });
     }
 
-    mlir::Value sprintfOfF32orF64(mlir::Value value)
+  private:
+    // strings of 1..15 decimal digits are parsed in place (value is passed to 'fromDigits' as i64), other strings are
+    // parsed by 'parseOther'
+    mlir::Value parseDigits(mlir::Value str, mlir::Type type, function_ref<mlir::Value(mlir::Value)> fromDigits,
+                            function_ref<mlir::Value()> parseOther)
     {
-#ifdef NUMBER_F64
-        auto doubleValue = value;
-#else
-        auto doubleValue = rewriter.create<LLVM::FPExtOp>(loc, rewriter.getF64Type(), value);
-#endif
-        return sprintf(50, "%g", doubleValue);
+        auto i8PtrTy = th.getI8PtrType();
+        auto i64Ty = th.getI64Type();
+
+        auto len = slh.length(str);
+        // (len - 1) < 15 is false for empty string
+        auto lenMinusOne = rewriter.create<LLVM::SubOp>(loc, i64Ty, ValueRange{len, clh.createI64ConstantOf(1)});
+        auto isShort = rewriter.create<LLVM::ICmpOp>(loc, LLVM::ICmpPredicate::ult, lenMinusOne,
+                                                     clh.createI64ConstantOf(maxFastParseDigits));
+
+        auto *opBlock = rewriter.getInsertionBlock();
+        auto *continuationBlock = rewriter.splitBlock(opBlock, rewriter.getInsertionPoint());
+
+        // condition block: index of char and value of digits before it
+        auto *condBlock = rewriter.createBlock(continuationBlock, TypeRange{i64Ty, i64Ty});
+        auto index = condBlock->getArgument(0);
+        auto digits = condBlock->getArgument(1);
+
+        // body block
+        auto *bodyBlock = rewriter.createBlock(continuationBlock);
+        auto charRef = rewriter.create<LLVM::GEPOp>(loc, i8PtrTy, str, ValueRange{index});
+        auto charValue = rewriter.create<LLVM::ZExtOp>(loc, i64Ty, rewriter.create<LLVM::LoadOp>(loc, charRef));
+        auto digit = rewriter.create<LLVM::SubOp>(loc, i64Ty, ValueRange{charValue, clh.createI64ConstantOf('0')});
+        auto isDigit =
+            rewriter.create<LLVM::ICmpOp>(loc, LLVM::ICmpPredicate::ult, digit, clh.createI64ConstantOf(10));
+
+        // next digit block
+        auto *nextDigitBlock = rewriter.createBlock(continuationBlock);
+        auto shifted = rewriter.create<LLVM::MulOp>(loc, i64Ty, ValueRange{digits, clh.createI64ConstantOf(10)});
+        auto nextDigits = rewriter.create<LLVM::AddOp>(loc, i64Ty, ValueRange{shifted, digit});
+        auto nextIndex = rewriter.create<LLVM::AddOp>(loc, i64Ty, ValueRange{index, clh.createI64ConstantOf(1)});
+        rewriter.create<LLVM::BrOp>(loc, ValueRange{nextIndex, nextDigits}, condBlock);
+
+        // result block
+        auto *resultBlock = rewriter.createBlock(continuationBlock, TypeRange{type});
+        rewriter.create<LLVM::BrOp>(loc, ValueRange{}, continuationBlock);
+
+        // digits block
+        auto *digitsBlock = rewriter.createBlock(resultBlock);
+        rewriter.create<LLVM::BrOp>(loc, ValueRange{fromDigits(digits)}, resultBlock);
+
+        // other block
+        auto *otherBlock = rewriter.createBlock(resultBlock);
+        rewriter.create<LLVM::BrOp>(loc, ValueRange{parseOther()}, resultBlock);
+
+        rewriter.setInsertionPointToEnd(bodyBlock);
+        rewriter.create<LLVM::CondBrOp>(loc, isDigit, nextDigitBlock, otherBlock);
+
+        rewriter.setInsertionPointToEnd(condBlock);
+        auto isLess = rewriter.create<LLVM::ICmpOp>(loc, LLVM::ICmpPredicate::ult, index, len);
+        rewriter.create<LLVM::CondBrOp>(loc, isLess, bodyBlock, digitsBlock);
+
+        rewriter.setInsertionPointToEnd(opBlock);
+        rewriter.create<LLVM::CondBrOp>(loc, isShort, condBlock,
+                                        ValueRange{clh.createI64ConstantOf(0), clh.createI64ConstantOf(0)}, otherBlock,
+                                        ValueRange{});
+
+        rewriter.setInsertionPointToStart(continuationBlock);
+
+        return resultBlock->getArgument(0);
     }
 
-    mlir::Value sprintfOfI64(mlir::Value value)
+    // builders may create blocks, chars are returned from the last block of builder
+    std::pair<mlir::Value, mlir::Value> conditional(mlir::Value condition,
+                                                    function_ref<std::pair<mlir::Value, mlir::Value>()> thenBuilder,
+                                                    function_ref<std::pair<mlir::Value, mlir::Value>()> elseBuilder)
     {
-        return sprintf(50, "%llu", value);
+        auto *opBlock = rewriter.getInsertionBlock();
+        auto *continuationBlock = rewriter.splitBlock(opBlock, rewriter.getInsertionPoint());
+
+        auto *resultBlock = rewriter.createBlock(continuationBlock, TypeRange{th.getI8PtrType(), th.getI64Type()});
+        rewriter.create<LLVM::BrOp>(loc, ValueRange{}, continuationBlock);
+
+        auto *thenBlock = rewriter.createBlock(resultBlock);
+        auto thenChars = thenBuilder();
+        rewriter.create<LLVM::BrOp>(loc, ValueRange{thenChars.first, thenChars.second}, resultBlock);
+
+        auto *elseBlock = rewriter.createBlock(resultBlock);
+        auto elseChars = elseBuilder();
+        rewriter.create<LLVM::BrOp>(loc, ValueRange{elseChars.first, elseChars.second}, resultBlock);
+
+        rewriter.setInsertionPointToEnd(opBlock);
+        rewriter.create<LLVM::CondBrOp>(loc, condition, thenBlock, elseBlock);
+
+        rewriter.setInsertionPointToStart(continuationBlock);
+
+        return {resultBlock->getArgument(0), resultBlock->getArgument(1)};
     }
 
-    mlir::Value intToString(mlir::Value value)
+    // buffers are allocated once at top of function, so conversions in loops do not grow stack
+    mlir::Value allocaInFuncTop(mlir::Type type, int64_t count = 1)
     {
-#ifndef USE_SPRINTF
-        return itoa(value);
-#else
-        return sprintfOfInt(value);
-#endif
+        mlir::OpBuilder::InsertionGuard insertGuard(rewriter);
+        if (auto parentFuncOp = op->getParentOfType<LLVM::LLVMFuncOp>())
+        {
+            rewriter.setInsertionPoint(&parentFuncOp.getBody().front().front());
+        }
+
+        return rewriter.create<LLVM::AllocaOp>(loc, th.getPointerType(type), clh.createI32ConstantOf(count));
     }
 
-    mlir::Value int64ToString(mlir::Value value)
+    mlir::Value allocaInFuncTop(int64_t size)
     {
-#ifndef USE_SPRINTF
-        return i64toa(value);
-#else
-        return sprintfOfI64(value);
-#endif
+        return allocaInFuncTop(th.getI8Type(), size);
     }
 
-    mlir::Value f32OrF64ToString(mlir::Value value)
+    mlir::Value toString(std::pair<mlir::Value, mlir::Value> chars)
     {
-#ifndef USE_SPRINTF
-        return gcvt(value);
-#else
-        return sprintfOfF32orF64(value);
-#endif
+        auto str = slh.allocate(chars.second);
+        slh.copy(str, ValueRange{chars.first}, ArrayRef<mlir::Value>{chars.second});
+        return str;
     }
 };
 } // namespace typescript
@@ -84,6 +84,10 @@ class LLVMCodeHelper : public LLVMCodeHelperBase
             {
                 linkage = LLVM::Linkage::Appending;
             }
+            else if (val == "Internal")
+            {
+                linkage = LLVM::Linkage::Internal;
+            }
         }
 
         return linkage;
@@ -281,7 +285,13 @@ class LLVMCodeHelper : public LLVMCodeHelperBase
         auto structValue3 = rewriter.create<LLVM::InsertValueOp>(loc, llvmArrayType, structValue2, sizeValue,
                                                                  rewriter.getI32ArrayAttr(mlir::ArrayRef<int32_t>(1)));
 
-        return structValue3;
+        // capacity 0: data in global is not owned by array, it is copied when array grows
+        auto capacityValue = rewriter.create<LLVM::ConstantOp>(loc, rewriter.getIntegerType(32),
+                                                               rewriter.getIntegerAttr(rewriter.getI32Type(), 0));
+        auto structValue4 = rewriter.create<LLVM::InsertValueOp>(loc, llvmArrayType, structValue3, capacityValue,
+                                                                 rewriter.getI32ArrayAttr(mlir::ArrayRef<int32_t>(2)));
+
+        return structValue4;
     }
 
     mlir::Value getOrCreateGlobalArray(mlir::Type originalElementType, StringRef name, mlir::Type llvmElementType, unsigned size,
@@ -132,7 +132,7 @@ class LLVMCodeHelperBase
 
   private:
     /// Return a value representing an access into a global string with the given
-    /// name, creating the string if necessary.
+    /// name, creating the string if necessary. String is stored as { i64 length, [N x i8] chars } (see StringLogicHelper)
     mlir::Value getOrCreateGlobalString_(StringRef name, StringRef value)
     {
         auto loc = op->getLoc();
@@ -147,16 +147,34 @@ class LLVMCodeHelperBase
             OpBuilder::InsertionGuard insertGuard(rewriter);
             rewriter.setInsertionPointToStart(parentModule.getBody());
 
-            seekLast<StringAttr>(parentModule.getBody());
+            seekLast(parentModule.getBody());
 
-            auto type = th.getArrayType(th.getI8Type(), value.size());
-            global = rewriter.create<LLVM::GlobalOp>(loc, type, true, LLVM::Linkage::Internal, name, rewriter.getStringAttr(value));
+            auto charsType = th.getArrayType(th.getI8Type(), value.size());
+            auto type = LLVM::LLVMStructType::getLiteral(rewriter.getContext(), {th.getI64Type(), charsType}, false);
+            global = rewriter.create<LLVM::GlobalOp>(loc, type, true, LLVM::Linkage::Internal, name, mlir::Attribute());
+
+            {
+                mlir::Block *block = rewriter.createBlock(&global.getInitializerRegion());
+                rewriter.setInsertionPoint(block, block->begin());
+
+                // length without terminating zero
+                mlir::Value structValue = rewriter.create<LLVM::UndefOp>(loc, type);
+                mlir::Value lengthValue = rewriter.create<LLVM::ConstantOp>(
+                    loc, th.getI64Type(), rewriter.getI64IntegerAttr(value.size() - 1));
+                mlir::Value charsValue = rewriter.create<LLVM::ConstantOp>(loc, charsType, rewriter.getStringAttr(value));
+                structValue = rewriter.create<LLVM::InsertValueOp>(loc, type, structValue, lengthValue,
+                                                                   rewriter.getI32ArrayAttr(mlir::ArrayRef<int32_t>(0)));
+                structValue = rewriter.create<LLVM::InsertValueOp>(loc, type, structValue, charsValue,
+                                                                   rewriter.getI32ArrayAttr(mlir::ArrayRef<int32_t>(1)));
+                rewriter.create<LLVM::ReturnOp>(loc, mlir::ValueRange{structValue});
+            }
         }
 
         // Get the pointer to the first character in the global string.
         mlir::Value globalPtr = rewriter.create<LLVM::AddressOfOp>(loc, global);
         mlir::Value cst0 = rewriter.create<LLVM::ConstantOp>(loc, th.getIndexType(), th.getIndexAttrValue(0));
-        return rewriter.create<LLVM::GEPOp>(loc, th.getI8PtrType(), globalPtr, ArrayRef<mlir::Value>({cst0, cst0}));
+        mlir::Value cst1 = rewriter.create<LLVM::ConstantOp>(loc, th.getI32Type(), rewriter.getI32IntegerAttr(1));
+        return rewriter.create<LLVM::GEPOp>(loc, th.getI8PtrType(), globalPtr, ArrayRef<mlir::Value>({cst0, cst1, cst0}));
     }
 
   public:
@@ -239,6 +257,23 @@ class LLVMCodeHelperBase
         return _MemoryFree<int>(ptrValue);
     }
 
+    // memset(ptr, 0, sizeof(storageType)) to zero stack allocated memory the same way as heap allocated memory
+    void MemoryZero(mlir::Value ptrValue, mlir::Type storageType)
+    {
+        TypeHelper th(rewriter);
+        CodeLogicHelper clh(op, rewriter);
+
+        auto loc = op->getLoc();
+
+        auto i8PtrTy = th.getI8PtrType();
+        auto memsetFuncOp = getOrInsertFunction("memset", th.getFunctionType(i8PtrTy, {i8PtrTy, th.getI32Type(), th.getIndexType()}));
+
+        auto ptr = rewriter.create<LLVM::BitcastOp>(loc, i8PtrTy, ptrValue);
+        auto sizeOfTypeValue = rewriter.create<mlir_ts::SizeOfOp>(loc, th.getIndexType(), storageType);
+        auto const0 = clh.createI32ConstantOf(0);
+        rewriter.create<LLVM::CallOp>(loc, memsetFuncOp, ValueRange{ptr, const0, sizeOfTypeValue});
+    }
+
     template <typename T> mlir::Value _MemoryAlloc(mlir::Value sizeOfAlloc, MemoryAllocSet zero)
     {
         TypeHelper th(rewriter);
@@ -51,6 +51,16 @@ class LLVMTypeConverterHelper
         return typeConverter.getDataLayout().getTypeAllocSize(type);
     }
 
+    // alignment of alloca of type without explicit alignment
+    int32_t getTypeAlignment(mlir::Type llvmType)
+    {
+        llvm::LLVMContext llvmContext;
+        LLVM::TypeToLLVMIRTranslator typeToLLVMIRTranslator(llvmContext);
+
+        auto type = typeToLLVMIRTranslator.translateType(llvmType);
+        return typeConverter.getDataLayout().getPrefTypeAlign(type).value();
+    }
+
     mlir::Type findMaxSizeType(mlir_ts::UnionType unionType)
     {
         auto currentSize = 0;
@@ -0,0 +1,225 @@
+#ifndef MLIR_TYPESCRIPT_LOWERTOLLVMLOGIC_STRINGLOGICHELPER_H_
+#define MLIR_TYPESCRIPT_LOWERTOLLVMLOGIC_STRINGLOGICHELPER_H_
+
+#include "TypeScript/Config.h"
+#include "TypeScript/Defines.h"
+#include "TypeScript/Passes.h"
+#include "TypeScript/TypeScriptDialect.h"
+#include "TypeScript/TypeScriptOps.h"
+
+#include "TypeScript/LowerToLLVM/TypeHelper.h"
+#include "TypeScript/LowerToLLVM/TypeConverterHelper.h"
+#include "TypeScript/LowerToLLVM/CodeLogicHelper.h"
+#include "TypeScript/LowerToLLVM/LLVMCodeHelperBase.h"
+
+using namespace mlir;
+namespace mlir_ts = mlir::typescript;
+
+namespace typescript
+{
+
+// strings are stored with header: length of string (i64, without terminating zero) is kept right before first char.
+// Value of string points to first char, so string is still C string for puts, printf and external functions.
+// Length of string is O(1) and concatenation of strings copies each part once.
+class StringLogicHelper
+{
+    Operation *op;
+    PatternRewriter &rewriter;
+    TypeHelper th;
+    LLVMCodeHelperBase ch;
+    CodeLogicHelper clh;
+    Location loc;
+
+  public:
+    StringLogicHelper(Operation *op, PatternRewriter &rewriter, TypeConverterHelper &tch)
+        : op(op), rewriter(rewriter), th(rewriter), ch(op, rewriter, &tch.typeConverter), clh(op, rewriter), loc(op->getLoc())
+    {
+    }
+
+    // size of header in bytes
+    mlir::Value headerSize()
+    {
+        return clh.createI64ConstantOf(sizeof(int64_t));
+    }
+
+    mlir::Value lengthRef(mlir::Value str)
+    {
+        auto i64PtrTy = th.getPointerType(th.getI64Type());
+        auto header = rewriter.create<LLVM::BitcastOp>(loc, i64PtrTy, str);
+        return rewriter.create<LLVM::GEPOp>(loc, i64PtrTy, header, ValueRange{clh.createI64ConstantOf(-1)});
+    }
+
+    // length of string without terminating zero (i64)
+    mlir::Value length(mlir::Value str)
+    {
+        return rewriter.create<LLVM::LoadOp>(loc, lengthRef(str));
+    }
+
+    void setLength(mlir::Value str, mlir::Value len)
+    {
+        rewriter.create<LLVM::StoreOp>(loc, len, lengthRef(str));
+    }
+
+    // pointer to first char of string in allocated memory
+    mlir::Value fromAllocated(mlir::Value allocated)
+    {
+        return rewriter.create<LLVM::GEPOp>(loc, th.getI8PtrType(), allocated, ValueRange{headerSize()});
+    }
+
+    // allocated memory of string
+    mlir::Value toAllocated(mlir::Value str)
+    {
+        return rewriter.create<LLVM::BitcastOp>(loc, th.getI8PtrType(), lengthRef(str));
+    }
+
+    // allocates string of length 'len' (terminating zero is not written)
+    mlir::Value allocate(mlir::Value len, bool inStack = false)
+    {
+        auto i8PtrTy = th.getI8PtrType();
+        mlir::Value size = rewriter.create<LLVM::AddOp>(loc, th.getI64Type(), ValueRange{len, headerSize()});
+        size = rewriter.create<LLVM::AddOp>(loc, th.getI64Type(), ValueRange{size, clh.createI64ConstantOf(1)});
+
+        mlir::Value allocated = inStack ? rewriter.create<LLVM::AllocaOp>(loc, i8PtrTy, size, sizeof(int64_t))
+                                        : ch.MemoryAllocBitcast(i8PtrTy, size);
+        auto str = fromAllocated(allocated);
+        setLength(str, len);
+        return str;
+    }
+
+    // reallocates string to keep 'capacity' chars (terminating zero is not included)
+    mlir::Value reallocate(mlir::Value str, mlir::Value capacity)
+    {
+        mlir::Value size = rewriter.create<LLVM::AddOp>(loc, th.getI64Type(), ValueRange{capacity, headerSize()});
+        size = rewriter.create<LLVM::AddOp>(loc, th.getI64Type(), ValueRange{size, clh.createI64ConstantOf(1)});
+        return fromAllocated(ch.MemoryReallocBitcast(th.getI8PtrType(), toAllocated(str), size));
+    }
+
+    // allocates buffer for C function which writes C string in it, call 'fromCString' after writing
+    mlir::Value allocateForCString(int bufferSize)
+    {
+        return allocate(clh.createI64ConstantOf(bufferSize - 1));
+    }
+
+    // sets length of C string written into buffer allocated by 'allocateForCString'
+    mlir::Value fromCString(mlir::Value str)
+    {
+        auto strlenFuncOp = ch.getOrInsertFunction("strlen", th.getFunctionType(th.getI64Type(), {th.getI8PtrType()}));
+        auto len = rewriter.create<LLVM::CallOp>(loc, strlenFuncOp, ValueRange{str}).getResult(0);
+        setLength(str, len);
+        return str;
+    }
+
+    // copies C string without header (returned by external function, casted from pointer) into new string, null stays
+    // null
+    mlir::Value fromExternal(mlir::Value cstr)
+    {
+        auto i8PtrTy = th.getI8PtrType();
+        auto nullPtr = rewriter.create<LLVM::NullOp>(loc, i8PtrTy);
+        auto isNull = rewriter.create<LLVM::ICmpOp>(loc, LLVM::ICmpPredicate::eq, cstr, nullPtr);
+        return clh.conditionalExpressionLowering(
+            i8PtrTy, isNull, [&](OpBuilder &builder, Location loc) { return cstr; },
+            [&](OpBuilder &builder, Location loc) {
+                auto strlenFuncOp = ch.getOrInsertFunction("strlen", th.getFunctionType(th.getI64Type(), {i8PtrTy}));
+                auto len = rewriter.create<LLVM::CallOp>(loc, strlenFuncOp, ValueRange{cstr}).getResult(0);
+                auto str = allocate(len);
+                copy(str, ValueRange{cstr}, ArrayRef<mlir::Value>{len});
+                return str;
+            });
+    }
+
+    // strings with different lengths are not equal, memcmp is called with 0 size for them
+    mlir::Value equals(mlir::Value str1, mlir::Value str2)
+    {
+        auto i8PtrTy = th.getI8PtrType();
+        auto memcmpFuncOp =
+            ch.getOrInsertFunction("memcmp", th.getFunctionType(th.getI32Type(), {i8PtrTy, i8PtrTy, th.getI64Type()}));
+
+        auto length1 = length(str1);
+        auto sameLength = rewriter.create<LLVM::ICmpOp>(loc, LLVM::ICmpPredicate::eq, length1, length(str2));
+        auto size = rewriter.create<LLVM::SelectOp>(loc, sameLength, length1, clh.createI64ConstantOf(0));
+        auto compareResult = rewriter.create<LLVM::CallOp>(loc, memcmpFuncOp, ValueRange{str1, str2, size});
+        auto sameBody = rewriter.create<LLVM::ICmpOp>(loc, LLVM::ICmpPredicate::eq, compareResult.getResult(0),
+                                                      clh.createI32ConstantOf(0));
+        return rewriter.create<LLVM::AndOp>(loc, sameLength, sameBody);
+    }
+
+    // FNV-1a hash (i32) of chars of string, MLIRGen computes the same hash of string cases of 'switch'
+    mlir::Value hash(mlir::Value str)
+    {
+        auto i8PtrTy = th.getI8PtrType();
+        auto i32Ty = th.getI32Type();
+        auto i64Ty = th.getI64Type();
+
+        auto len = length(str);
+
+        auto *opBlock = rewriter.getInsertionBlock();
+        auto *continuationBlock = rewriter.splitBlock(opBlock, rewriter.getInsertionPoint());
+
+        // condition block: index of char and hash of chars before it
+        auto *condBlock = rewriter.createBlock(continuationBlock, TypeRange{i64Ty, i32Ty});
+        auto index = condBlock->getArgument(0);
+        auto hashValue = condBlock->getArgument(1);
+
+        // body block
+        auto *bodyBlock = rewriter.createBlock(continuationBlock);
+        auto charRef = rewriter.create<LLVM::GEPOp>(loc, i8PtrTy, str, ValueRange{index});
+        auto charValue = rewriter.create<LLVM::LoadOp>(loc, charRef);
+        auto charI32 = rewriter.create<LLVM::ZExtOp>(loc, i32Ty, charValue);
+        auto xorValue = rewriter.create<LLVM::XOrOp>(loc, i32Ty, ValueRange{hashValue, charI32});
+        auto nextHash =
+            rewriter.create<LLVM::MulOp>(loc, i32Ty, ValueRange{xorValue, clh.createI32ConstantOf(16777619)});
+        auto nextIndex = rewriter.create<LLVM::AddOp>(loc, i64Ty, ValueRange{index, clh.createI64ConstantOf(1)});
+        rewriter.create<LLVM::BrOp>(loc, ValueRange{nextIndex, nextHash}, condBlock);
+
+        // result block
+        auto *resultBlock = rewriter.createBlock(continuationBlock, TypeRange{i32Ty});
+        rewriter.create<LLVM::BrOp>(loc, ValueRange{}, continuationBlock);
+
+        rewriter.setInsertionPointToEnd(condBlock);
+        auto isLess = rewriter.create<LLVM::ICmpOp>(loc, LLVM::ICmpPredicate::ult, index, len);
+        rewriter.create<LLVM::CondBrOp>(loc, isLess, bodyBlock, ValueRange{}, resultBlock, ValueRange{hashValue});
+
+        rewriter.setInsertionPointToEnd(opBlock);
+        rewriter.create<LLVM::BrOp>(
+            loc, ValueRange{clh.createI64ConstantOf(0), clh.createI32ConstantOf((int32_t)2166136261u)}, condBlock);
+
+        rewriter.setInsertionPointToStart(continuationBlock);
+
+        return resultBlock->getArguments().front();
+    }
+
+    mlir::Value totalLength(ValueRange strs, SmallVectorImpl<mlir::Value> &lengths)
+    {
+        mlir::Value total = clh.createI64ConstantOf(0);
+        for (auto str : strs)
+        {
+            auto len = length(str);
+            lengths.push_back(len);
+            total = rewriter.create<LLVM::AddOp>(loc, th.getI64Type(), ValueRange{total, len});
+        }
+
+        return total;
+    }
+
+    // copies parts one after another into dest and terminates result with zero
+    void copy(mlir::Value dest, ValueRange strs, ArrayRef<mlir::Value> lengths)
+    {
+        auto i8PtrTy = th.getI8PtrType();
+        auto copyMemFuncOp = ch.getOrInsertFunction(
+            "llvm.memcpy.p0i8.p0i8.i64", th.getFunctionType(th.getVoidType(), {i8PtrTy, i8PtrTy, th.getI64Type(), th.getLLVMBoolType()}));
+
+        auto immarg = clh.createI1ConstantOf(false);
+        auto offset = dest;
+        for (auto it : llvm::zip(strs, lengths))
+        {
+            auto len = std::get<1>(it);
+            rewriter.create<LLVM::CallOp>(loc, copyMemFuncOp, ValueRange{offset, std::get<0>(it), len, immarg});
+            offset = rewriter.create<LLVM::GEPOp>(loc, i8PtrTy, offset, ValueRange{len});
+        }
+
+        rewriter.create<LLVM::StoreOp>(loc, clh.createI8ConstantOf(0), offset);
+    }
+};
+} // namespace typescript
+
+#endif // MLIR_TYPESCRIPT_LOWERTOLLVMLOGIC_STRINGLOGICHELPER_H_
@@ -0,0 +1,238 @@
+#ifndef MLIR_TYPESCRIPT_LOWERTOLLVMLOGIC_TYPEIDLOGICHELPER_H_
+#define MLIR_TYPESCRIPT_LOWERTOLLVMLOGIC_TYPEIDLOGICHELPER_H_
+
+#include "TypeScript/Config.h"
+#include "TypeScript/Defines.h"
+#include "TypeScript/Passes.h"
+#include "TypeScript/TypeScriptDialect.h"
+#include "TypeScript/TypeScriptOps.h"
+
+#include "TypeScript/LowerToLLVM/TypeHelper.h"
+#include "TypeScript/LowerToLLVM/TypeConverterHelper.h"
+#include "TypeScript/LowerToLLVM/CodeLogicHelper.h"
+#include "TypeScript/LowerToLLVM/LLVMCodeHelperBase.h"
+#include "TypeScript/LowerToLLVM/TypeOfOpHelper.h"
+
+#include "scanner_enums.h"
+
+using namespace mlir;
+namespace mlir_ts = mlir::typescript;
+
+namespace typescript
+{
+
+// tagged union stores type id (index in TypeOfOpHelper::typeNames()) instead of typeof string, so checking type of
+// union value is integer compare
+class TypeIdLogicHelper
+{
+    Operation *op;
+    PatternRewriter &rewriter;
+    TypeHelper th;
+    LLVMCodeHelperBase ch;
+    CodeLogicHelper clh;
+    Location loc;
+
+  public:
+    TypeIdLogicHelper(Operation *op, PatternRewriter &rewriter, TypeConverterHelper &tch)
+        : op(op), rewriter(rewriter), th(rewriter), ch(op, rewriter, &tch.typeConverter), clh(op, rewriter), loc(op->getLoc())
+    {
+    }
+
+    mlir::Type getTypeIdType()
+    {
+        return th.getI32Type();
+    }
+
+    // type id of constant typeof string or of typeof of value which type is known, -1 if it is not known
+    static int constTypeId(mlir::Value typeInfo)
+    {
+        // string literal type to string
+        if (auto castOp = typeInfo.getDefiningOp<mlir_ts::CastOp>())
+        {
+            typeInfo = castOp.in();
+        }
+
+        if (auto typeOfOp = typeInfo.getDefiningOp<mlir_ts::TypeOfOp>())
+        {
+            MLIRTypeHelper mth(typeInfo.getContext());
+            auto typeOfName = mth.getTypeOfName(typeOfOp.value().getType());
+            return typeOfName.empty() ? -1 : TypeOfOpHelper::typeId(typeOfName);
+        }
+
+        if (auto constantOp = typeInfo.getDefiningOp<mlir_ts::ConstantOp>())
+        {
+            if (auto strAttr = constantOp.valueAttr().dyn_cast_or_null<StringAttr>())
+            {
+                return TypeOfOpHelper::typeId(strAttr.getValue());
+            }
+        }
+
+        return -1;
+    }
+
+    // origTypeInfo - value before conversion to find constant value, typeInfo - converted value (i8*)
+    mlir::Value typeIdFromTypeInfo(mlir::Value origTypeInfo, mlir::Value typeInfo)
+    {
+        auto id = constTypeId(origTypeInfo);
+        if (id >= 0)
+        {
+            return clh.createI32ConstantOf(id);
+        }
+
+        // not known at compile time (for example typeof of 'any'), look for it in table
+        auto lookupFuncOp = getOrCreateTypeIdLookupFunction();
+        auto callOp = rewriter.create<LLVM::CallOp>(loc, lookupFuncOp, ValueRange{typeInfo});
+        return callOp.getResult(0);
+    }
+
+    // i32 __type_id_lookup(i8* typeInfo), linear search of typeof string in TypeOfOpHelper::typeNames()
+    LLVM::LLVMFuncOp getOrCreateTypeIdLookupFunction()
+    {
+        auto parentModule = op->getParentOfType<ModuleOp>();
+        if (auto funcOp = parentModule.lookupSymbol<LLVM::LLVMFuncOp>(TYPE_ID_LOOKUP_FUNC_NAME))
+        {
+            return funcOp;
+        }
+
+        auto i8PtrTy = th.getI8PtrType();
+        auto i32Ty = th.getI32Type();
+        auto strcmpFuncOp = ch.getOrInsertFunction("strcmp", th.getFunctionType(i32Ty, {i8PtrTy, i8PtrTy}));
+
+        OpBuilder::InsertionGuard insertGuard(rewriter);
+        rewriter.setInsertionPointToStart(parentModule.getBody());
+
+        auto funcOp = rewriter.create<LLVM::LLVMFuncOp>(loc, TYPE_ID_LOOKUP_FUNC_NAME, th.getFunctionType(i32Ty, {i8PtrTy}),
+                                                        LLVM::Linkage::Internal);
+
+        auto *entryBlock = funcOp.addEntryBlock();
+        auto typeInfo = entryBlock->getArgument(0);
+        auto &body = funcOp.getBody();
+        auto *condBlock = rewriter.createBlock(&body, body.end(), {i32Ty});
+        auto *compareBlock = rewriter.createBlock(&body, body.end());
+        auto *foundBlock = rewriter.createBlock(&body, body.end());
+        auto *notFoundBlock = rewriter.createBlock(&body, body.end());
+        auto *checkDigitBlock = rewriter.createBlock(&body, body.end());
+        auto *numberBlock = rewriter.createBlock(&body, body.end());
+        auto *unknownBlock = rewriter.createBlock(&body, body.end());
+
+        rewriter.setInsertionPointToStart(entryBlock);
+        auto tablePtr = getOrCreateTypeNamesTable();
+        rewriter.create<LLVM::BrOp>(loc, ValueRange{clh.createI32ConstantOf(0)}, condBlock);
+
+        rewriter.setInsertionPointToStart(condBlock);
+        auto index = condBlock->getArgument(0);
+        auto count = clh.createI32ConstantOf(static_cast<int32_t>(TypeOfOpHelper::typeNames().size()));
+        auto inRange = rewriter.create<LLVM::ICmpOp>(loc, LLVM::ICmpPredicate::slt, index, count);
+        rewriter.create<LLVM::CondBrOp>(loc, inRange, compareBlock, notFoundBlock);
+
+        rewriter.setInsertionPointToStart(compareBlock);
+        auto itemPtr = rewriter.create<LLVM::GEPOp>(loc, tablePtr.getType(), tablePtr, ValueRange{index});
+        auto nameValue = rewriter.create<LLVM::LoadOp>(loc, itemPtr);
+        auto compareResult = rewriter.create<LLVM::CallOp>(loc, strcmpFuncOp, ValueRange{typeInfo, nameValue});
+        auto isEqual =
+            rewriter.create<LLVM::ICmpOp>(loc, LLVM::ICmpPredicate::eq, compareResult.getResult(0), clh.createI32ConstantOf(0));
+        auto next = rewriter.create<LLVM::AddOp>(loc, index, clh.createI32ConstantOf(1));
+        rewriter.create<LLVM::CondBrOp>(loc, isEqual, foundBlock, ValueRange{}, condBlock, ValueRange{next});
+
+        rewriter.setInsertionPointToStart(foundBlock);
+        rewriter.create<LLVM::ReturnOp>(loc, ValueRange{index});
+
+        // "i<N>"/"f<N>" of width which is not in table, the same as TypeOfOpHelper::typeId
+        auto i8Ty = th.getI8Type();
+        rewriter.setInsertionPointToStart(notFoundBlock);
+        auto firstChar = rewriter.create<LLVM::LoadOp>(loc, typeInfo);
+        auto isInt = rewriter.create<LLVM::ICmpOp>(loc, LLVM::ICmpPredicate::eq, firstChar, clh.createI8ConstantOf('i'));
+        auto isFloat = rewriter.create<LLVM::ICmpOp>(loc, LLVM::ICmpPredicate::eq, firstChar, clh.createI8ConstantOf('f'));
+        auto isIntOrFloat = rewriter.create<LLVM::OrOp>(loc, isInt, isFloat);
+        rewriter.create<LLVM::CondBrOp>(loc, isIntOrFloat, checkDigitBlock, unknownBlock);
+
+        rewriter.setInsertionPointToStart(checkDigitBlock);
+        auto secondCharPtr = rewriter.create<LLVM::GEPOp>(loc, i8PtrTy, typeInfo, ValueRange{clh.createI32ConstantOf(1)});
+        auto secondChar = rewriter.create<LLVM::LoadOp>(loc, secondCharPtr);
+        auto digit = rewriter.create<LLVM::SubOp>(loc, i8Ty, secondChar, clh.createI8ConstantOf('0'));
+        auto isDigit = rewriter.create<LLVM::ICmpOp>(loc, LLVM::ICmpPredicate::ult, digit, clh.createI8ConstantOf(10));
+        rewriter.create<LLVM::CondBrOp>(loc, isDigit, numberBlock, unknownBlock);
+
+        rewriter.setInsertionPointToStart(numberBlock);
+        rewriter.create<LLVM::ReturnOp>(loc, ValueRange{clh.createI32ConstantOf(TypeOfOpHelper::typeId("number"))});
+
+        rewriter.setInsertionPointToStart(unknownBlock);
+        rewriter.create<LLVM::ReturnOp>(loc, ValueRange{clh.createI32ConstantOf(TypeOfOpHelper::typeId("unknown"))});
+
+        return funcOp;
+    }
+
+    // typeof string by type id, to print typeof of union value
+    mlir::Value typeInfoFromTypeId(mlir::Value typeId)
+    {
+        auto tablePtr = getOrCreateTypeNamesTable();
+        auto itemPtr = rewriter.create<LLVM::GEPOp>(loc, tablePtr.getType(), tablePtr, ValueRange{typeId});
+        return rewriter.create<LLVM::LoadOp>(loc, itemPtr);
+    }
+
+    // i8*[] of TypeOfOpHelper::typeNames()
+    mlir::Value getOrCreateTypeNamesTable()
+    {
+        auto parentModule = op->getParentOfType<ModuleOp>();
+
+        auto i8PtrTy = th.getI8PtrType();
+        auto names = TypeOfOpHelper::typeNames();
+        auto arrayType = th.getArrayType(i8PtrTy, names.size());
+
+        LLVM::GlobalOp global;
+        if (!(global = parentModule.lookupSymbol<LLVM::GlobalOp>(TYPE_NAMES_TABLE_NAME)))
+        {
+            OpBuilder::InsertionGuard insertGuard(rewriter);
+            rewriter.setInsertionPointToStart(parentModule.getBody());
+
+            global = rewriter.create<LLVM::GlobalOp>(loc, arrayType, true, LLVM::Linkage::Internal, TYPE_NAMES_TABLE_NAME,
+                                                     mlir::Attribute{});
+
+            rewriter.createBlock(&global.getInitializerRegion());
+
+            mlir::Value arrayVal = rewriter.create<LLVM::UndefOp>(loc, arrayType);
+
+            auto position = 0;
+            for (auto name : names)
+            {
+                auto itemVal = ch.getOrCreateGlobalString(name.str());
+                arrayVal = rewriter.create<LLVM::InsertValueOp>(loc, arrayVal, itemVal, rewriter.getI64ArrayAttr(position++));
+            }
+
+            rewriter.create<LLVM::ReturnOp>(loc, ValueRange{arrayVal});
+        }
+
+        mlir::Value globalPtr = rewriter.create<LLVM::AddressOfOp>(loc, global);
+        mlir::Value cst0 = rewriter.create<LLVM::ConstantOp>(loc, th.getIndexType(), th.getIndexAttrValue(0));
+        return rewriter.create<LLVM::GEPOp>(loc, LLVM::LLVMPointerType::get(i8PtrTy), globalPtr, ArrayRef<mlir::Value>({cst0, cst0}));
+    }
+
+    // compare type id of union with constant typeof string, returns null value if typeof string is not known
+    mlir::Value compareTypeId(SyntaxKind opCode, mlir::Value typeId, mlir::Value origTypeInfo)
+    {
+        auto id = constTypeId(origTypeInfo);
+        if (id < 0)
+        {
+            return mlir::Value();
+        }
+
+        auto predicate = LLVM::ICmpPredicate::eq;
+        switch (opCode)
+        {
+        case SyntaxKind::EqualsEqualsToken:
+        case SyntaxKind::EqualsEqualsEqualsToken:
+            break;
+        case SyntaxKind::ExclamationEqualsToken:
+        case SyntaxKind::ExclamationEqualsEqualsToken:
+            predicate = LLVM::ICmpPredicate::ne;
+            break;
+        default:
+            return mlir::Value();
+        }
+
+        return rewriter.create<LLVM::ICmpOp>(loc, predicate, typeId, clh.createI32ConstantOf(id));
+    }
+};
+} // namespace typescript
+
+#endif // MLIR_TYPESCRIPT_LOWERTOLLVMLOGIC_TYPEIDLOGICHELPER_H_
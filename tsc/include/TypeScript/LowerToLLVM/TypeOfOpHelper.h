@@ -6,6 +6,7 @@
 #include "TypeScript/Passes.h"
 #include "TypeScript/TypeScriptDialect.h"
 #include "TypeScript/TypeScriptOps.h"
+#include "TypeScript/MLIRLogic/MLIRTypeHelper.h"
 
 #include "TypeScript/LowerToLLVM/TypeHelper.h"
 #include "TypeScript/LowerToLLVM/TypeConverterHelper.h"
@@ -25,130 +26,54 @@ class TypeOfOpHelper
     {
     }
 
-    mlir::Value strValue(mlir::Location loc, std::string value)
+    // all values which typeOfLogic can return, index in this table is type id which is stored in tagged union
+    static llvm::ArrayRef<llvm::StringRef> typeNames()
     {
-        auto strType = mlir_ts::StringType::get(rewriter.getContext());
-        auto typeOfValue = rewriter.create<mlir_ts::ConstantOp>(loc, strType, rewriter.getStringAttr(value));
-        return typeOfValue;
+        static const llvm::StringRef names[] = {
+            "unknown", "undefined", "boolean", "number", "string", "array", "function", "class",
+            "object",  "interface", "symbol",  "tuple",  "ptrint", "i1",    "i8",       "i16",
+            "i32",     "i64",       "i128",    "f16",    "f32",    "f64",   "f80",      "f128"};
+        return names;
     }
 
-    mlir::Value typeOfLogic(mlir::Location loc, mlir::Type type)
+    // i<N>/f<N> of width which is not in table
+    static bool isOtherNumberName(llvm::StringRef typeName)
     {
-        if (type.isIntOrIndex() && !type.isIndex())
-        {
-            std::stringstream val;
-            val << "i" << type.getIntOrFloatBitWidth();
-            auto typeOfValue = strValue(loc, val.str());
-            return typeOfValue;
-        }
-
-        if (type.isIntOrFloat() && !type.isIntOrIndex())
-        {
-            std::stringstream val;
-            val << "f" << type.getIntOrFloatBitWidth();
-            auto typeOfValue = strValue(loc, val.str());
-            return typeOfValue;
-        }
-
-        if (type.isIndex())
-        {
-            auto typeOfValue = strValue(loc, "ptrint");
-            return typeOfValue;
-        }
-
-        if (type.isa<mlir_ts::BooleanType>())
-        {
-            auto typeOfValue = strValue(loc, "boolean");
-            return typeOfValue;
-        }
-
-        if (type.isa<mlir_ts::NumberType>())
-        {
-            auto typeOfValue = strValue(loc, "number");
-            return typeOfValue;
-        }
-
-        if (type.isa<mlir_ts::StringType>())
-        {
-            auto typeOfValue = strValue(loc, "string");
-            return typeOfValue;
-        }
-
-        if (type.isa<mlir_ts::ArrayType>())
-        {
-            auto typeOfValue = strValue(loc, "array");
-            return typeOfValue;
-        }
-
-        if (type.isa<mlir_ts::FunctionType>())
-        {
-            auto typeOfValue = strValue(loc, "function");
-            return typeOfValue;
-        }
-
-        if (type.isa<mlir_ts::BoundFunctionType>())
+        if (typeName.size() < 2 || (typeName.front() != 'i' && typeName.front() != 'f'))
         {
-            auto typeOfValue = strValue(loc, "function");
-            return typeOfValue;
+            return false;
         }
 
-        if (type.isa<mlir_ts::ClassType>())
-        {
-            auto typeOfValue = strValue(loc, "class");
-            return typeOfValue;
-        }
-
-        if (type.isa<mlir_ts::ClassStorageType>())
-        {
-            auto typeOfValue = strValue(loc, "class");
-            return typeOfValue;
-        }
-
-        if (type.isa<mlir_ts::ObjectType>())
-        {
-            auto typeOfValue = strValue(loc, "object");
-            return typeOfValue;
-        }
-
-        if (type.isa<mlir_ts::InterfaceType>())
-        {
-            auto typeOfValue = strValue(loc, "interface");
-            return typeOfValue;
-        }
-
-        if (type.isa<mlir_ts::OpaqueType>())
-        {
-            auto typeOfValue = strValue(loc, "object");
-            return typeOfValue;
-        }
-
-        if (type.isa<mlir_ts::SymbolType>())
-        {
-            auto typeOfValue = strValue(loc, "symbol");
-            return typeOfValue;
-        }
+        return llvm::all_of(typeName.drop_front(), [](char c) { return c >= '0' && c <= '9'; });
+    }
 
-        if (type.isa<mlir_ts::UndefinedType>())
+    // returns -1 if type name is unknown, integer and float widths not in table share id of "number"
+    static int typeId(llvm::StringRef typeName)
+    {
+        auto names = typeNames();
+        auto found = std::find(names.begin(), names.end(), typeName);
+        if (found != names.end())
         {
-            auto typeOfValue = strValue(loc, "undefined");
-            return typeOfValue;
+            return static_cast<int>(std::distance(names.begin(), found));
         }
 
-        if (type.isa<mlir_ts::UnknownType>())
-        {
-            auto typeOfValue = strValue(loc, "unknown");
-            return typeOfValue;
-        }
+        return isOtherNumberName(typeName) ? typeId("number") : -1;
+    }
 
-        if (type.isa<mlir_ts::ConstTupleType>())
-        {
-            auto typeOfValue = strValue(loc, "tuple");
-            return typeOfValue;
-        }
+    mlir::Value strValue(mlir::Location loc, std::string value)
+    {
+        auto strType = mlir_ts::StringType::get(rewriter.getContext());
+        auto typeOfValue = rewriter.create<mlir_ts::ConstantOp>(loc, strType, rewriter.getStringAttr(value));
+        return typeOfValue;
+    }
 
-        if (type.isa<mlir_ts::TupleType>())
+    mlir::Value typeOfLogic(mlir::Location loc, mlir::Type type)
+    {
+        MLIRTypeHelper mth(rewriter.getContext());
+        auto typeOfName = mth.getTypeOfName(type);
+        if (!typeOfName.empty())
         {
-            auto typeOfValue = strValue(loc, "tuple");
+            auto typeOfValue = strValue(loc, typeOfName);
             return typeOfValue;
         }
 
@@ -22,6 +22,9 @@
 #include "TypeScript/LowerToLLVM/CastLogicHelper.h"
 #include "TypeScript/LowerToLLVM/OptionalLogicHelper.h"
 #include "TypeScript/LowerToLLVM/TypeOfOpHelper.h"
+#include "TypeScript/LowerToLLVM/TypeIdLogicHelper.h"
+#include "TypeScript/LowerToLLVM/StringLogicHelper.h"
+#include "TypeScript/LowerToLLVM/ArrayLogicHelper.h"
 #include "TypeScript/LowerToLLVM/ThrowLogic.h"
 
 #endif // MLIR_TYPESCRIPT_LOWERTOLLVMLOGIC_H_
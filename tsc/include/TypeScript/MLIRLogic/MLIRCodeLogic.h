@@ -241,7 +241,25 @@ class MLIRCustomMethods
         SmallVector<mlir::Value> vals;
         for (auto &oper : operands)
         {
-            if (!oper.getType().isa<mlir_ts::StringType>())
+            // formatted by 'print' itself
+            auto type = oper.getType();
+            if (auto literalType = type.dyn_cast<mlir_ts::LiteralType>())
+            {
+                type = literalType.getElementType();
+            }
+
+            if (type.isa<mlir_ts::NumberType>() || type.isa<mlir_ts::BooleanType>() || type.isInteger(32) ||
+                type.isInteger(64))
+            {
+                mlir::Value val = oper;
+                if (type != oper.getType())
+                {
+                    val = builder.create<mlir_ts::CastOp>(location, type, oper);
+                }
+
+                vals.push_back(val);
+            }
+            else if (!oper.getType().isa<mlir_ts::StringType>())
             {
                 auto strCast =
                     builder.create<mlir_ts::CastOp>(location, mlir_ts::StringType::get(builder.getContext()), oper);
@@ -387,8 +405,11 @@ class MLIRCustomMethods
             op = builder.create<mlir_ts::CastOp>(location, int32Type, op);
         }
 
-        auto switchStateOp =
-            builder.create<mlir_ts::SwitchStateOp>(location, op, builder.getBlock(), mlir::BlockRange{});
+        // second operand is reference to coroutine handle when generator is lowered into coroutine
+        auto coroutineRef = operands.size() > 1 ? operands[1] : mlir::Value();
+
+        auto switchStateOp = builder.create<mlir_ts::SwitchStateOp>(location, op, coroutineRef, builder.getBlock(),
+                                                                    mlir::BlockRange{});
 
         auto *block = builder.createBlock(builder.getBlock()->getParent());
         switchStateOp.setSuccessor(block, 0);
@@ -598,7 +619,7 @@ class MLIRPropertyAccessCodeLogic
         return mlir::Value();
     }
 
-    bool isArrayCustomMethod(StringRef propName)
+    static bool isArrayCustomMethod(StringRef propName)
     {
         if (propName == "forEach") return true;
         if (propName == "every") return true;
@@ -609,14 +630,14 @@ class MLIRPropertyAccessCodeLogic
         return false;
     }
 
-    bool isArrayCustomMethodReturnsBool(StringRef propName)
+    static bool isArrayCustomMethodReturnsBool(StringRef propName)
     {
         if (propName == "every") return true;
         if (propName == "some") return true;
         return false;
     }
 
-    const char* getArrayCustomMethodName(StringRef propName)
+    static const char* getArrayCustomMethodName(StringRef propName)
     {
         if (propName == "forEach") return "__array_foreach";
         if (propName == "every") return "__array_every";
@@ -627,6 +648,46 @@ class MLIRPropertyAccessCodeLogic
         return nullptr;
     }
 
+    // accumulatorType is type of result of 'reduce', it is generic when it is not known yet
+    static mlir_ts::FunctionType getArrayCustomMethodType(mlir::MLIRContext *context, StringRef propName,
+                                                          mlir::Type elementType,
+                                                          mlir::Type accumulatorType = mlir::Type())
+    {
+        auto isReduce = propName == "reduce";
+        SmallVector<mlir::Type> resultArgs;
+        if (isArrayCustomMethodReturnsBool(propName))
+        {
+            resultArgs.push_back(mlir_ts::BooleanType::get(context));
+        }
+
+        SmallVector<mlir::Type> lambdaArgs{elementType};
+        SmallVector<mlir::Type> lambdaResultArgs(resultArgs.begin(), resultArgs.end());
+        if (isReduce)
+        {
+            // add sum param
+            if (!accumulatorType)
+            {
+                accumulatorType = mlir_ts::NamedGenericType::get(context, mlir::FlatSymbolRefAttr::get(context, "T"));
+            }
+            else
+            {
+                lambdaResultArgs.push_back(accumulatorType);
+            }
+
+            lambdaArgs.insert(&lambdaArgs.front(), accumulatorType);
+        }
+
+        auto lambdaFuncType = mlir_ts::FunctionType::get(context, lambdaArgs, lambdaResultArgs);
+
+        SmallVector<mlir::Type> funcArgs{lambdaFuncType};
+        if (isReduce)
+        {
+            funcArgs.push_back(accumulatorType);
+        }
+
+        return mlir_ts::FunctionType::get(context, funcArgs, resultArgs);
+    }
+
     template <typename T> mlir::Value Array(T arrayType)
     {
         SmallVector<mlir::NamedAttribute> customAttrs;
@@ -698,31 +759,7 @@ class MLIRPropertyAccessCodeLogic
                     elementType = arrayType.getElementType();
                 }
 
-                auto isReduce = propName == "reduce";
-                SmallVector<mlir::Type> resultArgs;
-                if (isArrayCustomMethodReturnsBool(propName))
-                {
-                    resultArgs.push_back(mlir_ts::BooleanType::get(builder.getContext()));
-                }
-
-                mlir::Type genericTypeT;
-                SmallVector<mlir::Type> lambdaArgs{elementType};
-                if (isReduce)
-                {
-                    // add sum param
-                    genericTypeT = mlir_ts::NamedGenericType::get(builder.getContext(), mlir::FlatSymbolRefAttr::get(builder.getContext(), "T"));
-                    lambdaArgs.insert(&lambdaArgs.front(), genericTypeT);
-                }
-
-                auto lambdaFuncType = mlir_ts::FunctionType::get(builder.getContext(), lambdaArgs, resultArgs);
-                
-                SmallVector<mlir::Type> funcArgs{lambdaFuncType};
-                if (isReduce)
-                {
-                    funcArgs.push_back(genericTypeT);
-                }
-
-                auto funcType = mlir_ts::FunctionType::get(builder.getContext(), funcArgs, resultArgs);
+                auto funcType = getArrayCustomMethodType(builder.getContext(), propName, elementType);
                 auto symbOp = builder.create<mlir_ts::ThisSymbolRefOp>(
                     location, funcType, expression,
                     mlir::FlatSymbolRefAttr::get(builder.getContext(), 
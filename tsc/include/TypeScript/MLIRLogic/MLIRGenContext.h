@@ -1,6 +1,8 @@
 #ifndef MLIR_TYPESCRIPT_MLIRGENCONTEXT_H_
 #define MLIR_TYPESCRIPT_MLIRGENCONTEXT_H_
 
+#include "TypeScript/Config.h"
+#include "TypeScript/Defines.h"
 #include "TypeScript/TypeScriptDialect.h"
 #include "TypeScript/TypeScriptOps.h"
 
@@ -205,10 +207,32 @@ struct VirtualMethodOrInterfaceVTableInfo
     {
     }
 
+    // record to store class id, see ClassInfo::classId
+    static VirtualMethodOrInterfaceVTableInfo classIdRecord()
+    {
+        MethodInfo methodInfo;
+        methodInfo.name = CLASS_ID_NAME;
+        VirtualMethodOrInterfaceVTableInfo record(methodInfo, false);
+        record.isClassId = true;
+        return record;
+    }
+
+    // record to store address of module marker, class ids are unique only inside of module
+    static VirtualMethodOrInterfaceVTableInfo classModuleRecord()
+    {
+        MethodInfo methodInfo;
+        methodInfo.name = CLASS_MODULE_NAME;
+        VirtualMethodOrInterfaceVTableInfo record(methodInfo, false);
+        record.isClassModule = true;
+        return record;
+    }
+
     MethodInfo methodInfo;
     StaticFieldInfo staticFieldInfo;
     bool isStaticField;
     bool isInterfaceVTable;
+    bool isClassId = false;
+    bool isClassModule = false;
 };
 
 struct AccessorInfo
@@ -533,11 +557,17 @@ struct ClassInfo
     bool processedStorageClass;
     bool enteredProcessingStorageClass;
 
+    // classes of module are numbered in preorder of hierarchy, so class is derived from this class when its id is in
+    // range [classId, lastDescendantClassId], -1 if class does not have id (declared in other module etc.); ids are
+    // unique only inside of module, so module of object is checked too (see CLASS_MODULE_NAME)
+    int classId;
+    int lastDescendantClassId;
+
     ClassInfo()
         : isDeclaration(false), hasNew(false), hasConstructor(false), hasInitializers(false), hasStaticConstructor(false),
           hasStaticInitializers(false), hasVirtualTable(false), isAbstract(false), hasRTTI(false),
           fullyProcessedAtEvaluation(false), fullyProcessed(false), processingStorageClass(false),
-          processedStorageClass(false), enteredProcessingStorageClass(false)
+          processedStorageClass(false), enteredProcessingStorageClass(false), classId(-1), lastDescendantClassId(-1)
     {
     }
 
@@ -602,6 +632,15 @@ struct ClassInfo
             base->getVirtualTable(vtable);
         }
 
+#ifdef ENABLE_RTTI
+        // INFO: class id and its module are first elements in VTable of root class
+        if (baseClasses.empty())
+        {
+            vtable.push_back(VirtualMethodOrInterfaceVTableInfo::classIdRecord());
+            vtable.push_back(VirtualMethodOrInterfaceVTableInfo::classModuleRecord());
+        }
+#endif
+
         // do vtable for current class
         for (auto &implement : implements)
         {
@@ -1,6 +1,7 @@
 #ifndef MLIR_TYPESCRIPT_COMMONGENLOGIC_MLIRTYPEHELPER_H_
 #define MLIR_TYPESCRIPT_COMMONGENLOGIC_MLIRTYPEHELPER_H_
 
+#include "TypeScript/TypeScriptDialect.h"
 #include "TypeScript/TypeScriptOps.h"
 #include "TypeScript/DOM.h"
 #include "TypeScript/MLIRLogic/MLIRTypeIterator.h"
@@ -785,6 +786,113 @@ class MLIRTypeHelper
         return storeType.isa<mlir_ts::UnionType>();
     }
 
+    // result of 'typeof' if it is decided by type of value, empty string for 'any', optional types and unions which
+    // need tag (they are checked at runtime)
+    std::string getTypeOfName(mlir::Type type)
+    {
+        if (type.isIndex())
+        {
+            return "ptrint";
+        }
+
+        if (type.isIntOrIndex())
+        {
+            return "i" + std::to_string(type.getIntOrFloatBitWidth());
+        }
+
+        if (type.isIntOrFloat())
+        {
+            return "f" + std::to_string(type.getIntOrFloatBitWidth());
+        }
+
+        if (type.isa<mlir_ts::BooleanType>())
+        {
+            return "boolean";
+        }
+
+        if (type.isa<mlir_ts::NumberType>())
+        {
+            return "number";
+        }
+
+        if (type.isa<mlir_ts::StringType>())
+        {
+            return "string";
+        }
+
+        if (type.isa<mlir_ts::ArrayType>())
+        {
+            return "array";
+        }
+
+        if (type.isa<mlir_ts::FunctionType>() || type.isa<mlir_ts::BoundFunctionType>())
+        {
+            return "function";
+        }
+
+        if (type.isa<mlir_ts::ClassType>() || type.isa<mlir_ts::ClassStorageType>())
+        {
+            return "class";
+        }
+
+        if (type.isa<mlir_ts::ObjectType>() || type.isa<mlir_ts::OpaqueType>())
+        {
+            return "object";
+        }
+
+        if (type.isa<mlir_ts::InterfaceType>())
+        {
+            return "interface";
+        }
+
+        if (type.isa<mlir_ts::SymbolType>())
+        {
+            return "symbol";
+        }
+
+        if (type.isa<mlir_ts::UndefinedType>())
+        {
+            return "undefined";
+        }
+
+        if (type.isa<mlir_ts::UnknownType>())
+        {
+            return "unknown";
+        }
+
+        if (type.isa<mlir_ts::ConstTupleType>() || type.isa<mlir_ts::TupleType>())
+        {
+            return "tuple";
+        }
+
+        if (auto subType = type.dyn_cast<mlir_ts::RefType>())
+        {
+            return getTypeOfName(subType.getElementType());
+        }
+
+        if (auto subType = type.dyn_cast<mlir_ts::ValueRefType>())
+        {
+            return getTypeOfName(subType.getElementType());
+        }
+
+        if (auto literalType = type.dyn_cast<mlir_ts::LiteralType>())
+        {
+            return getTypeOfName(literalType.getElementType());
+        }
+
+        // values of union without tag are stored as value of base type
+        if (auto unionType = type.dyn_cast<mlir_ts::UnionType>())
+        {
+            mlir::Type baseType;
+            if (!isUnionTypeNeedsTag(unionType, baseType))
+            {
+                return getTypeOfName(baseType);
+            }
+        }
+
+        return std::string();
+    }
+
     bool extendsType(mlir::Type srcType, mlir::Type extendType, llvm::StringMap<std::pair<ts::TypeParameterDOM::TypePtr,mlir::Type>> &typeParamsWithArgs)
     {
         if (srcType == extendType)
@@ -1010,7 +1118,8 @@ class MLIRTypeHelper
 
     mlir::Type getUnionTypeWithMerge(mlir::ArrayRef<mlir::Type> types, bool mergeLiterals = true)
     {
-        UnionTypeProcessContext unionContext = {};
+        // order of types is part of key, union keeps order of types in which it was built
+        mlir_ts::TypeScriptDialect::UnionTypeCacheKey key{mergeLiterals, {}};
         for (auto type : types)
         {
             if (!type)
@@ -1018,6 +1127,32 @@ class MLIRTypeHelper
                 llvm_unreachable("wrong type");
             }
 
+            key.second.push_back(type.getAsOpaquePointer());
+        }
+
+        auto *dialect = context->getLoadedDialect<mlir_ts::TypeScriptDialect>();
+        {
+            std::lock_guard<std::mutex> lock(dialect->unionTypesCacheMutex);
+            auto cached = dialect->unionTypesCache.find(key);
+            if (cached != dialect->unionTypesCache.end())
+            {
+                return cached->second;
+            }
+        }
+
+        // not under lock, merging can build nested unions
+        auto unionType = getUnionTypeWithMergeNoCache(types, mergeLiterals);
+
+        std::lock_guard<std::mutex> lock(dialect->unionTypesCacheMutex);
+        dialect->unionTypesCache.insert({std::move(key), unionType});
+        return unionType;
+    }
+
+    mlir::Type getUnionTypeWithMergeNoCache(mlir::ArrayRef<mlir::Type> types, bool mergeLiterals = true)
+    {
+        UnionTypeProcessContext unionContext = {};
+        for (auto type : types)
+        {
             processUnionTypeItem(type, unionContext);
 
             // default wide types
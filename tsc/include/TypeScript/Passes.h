@@ -25,6 +25,34 @@ std::unique_ptr<mlir::Pass> createLowerToLLVMPass();
 // TODO: should you process, switch satate in createLowerToAffinePass to resolve issue?
 std::unique_ptr<mlir::Pass> createRelocateConstantPass();
 
+/// Narrow local 'number' variables (loop counters etc.) to integers when their values are proven to be integral
+std::unique_ptr<mlir::Pass> createIntegerRangePass();
+
+/// Replace virtual calls with direct calls when class hierarchy of program allows only one or two targets
+std::unique_ptr<mlir::Pass> createDevirtualizePass();
+
+/// Inline calls of small TypeScript functions, getters and setters before escape analysis
+std::unique_ptr<mlir::Pass> createInlinerPass();
+
+/// Mark functions which can not throw and calls of them as nounwind, such calls in 'try' do not need landing pads
+std::unique_ptr<mlir::Pass> createNounwindPass();
+
+/// Allocate in stack class instances, captures and captured variables which do not outlive function
+std::unique_ptr<mlir::Pass> createEscapeAnalysisPass();
+
+/// Replace fields of local class instances with SSA values
+std::unique_ptr<mlir::Pass> createScalarReplacementPass();
+
+/// Replace concatenation to local string variable in loops (s = s + x) with appending to string builder
+std::unique_ptr<mlir::Pass> createStringBuilderPass();
+
+/// Lower generators marked to be coroutines into body of LLVM coroutine and function resuming it
+std::unique_ptr<mlir::Pass> createGeneratorToCoroutinePass();
+
+/// Define buffer of output written by 'print', it is flushed when full, when 'main' returns, before failed assert and
+/// after each line when 'lineBuffered' is set
+std::unique_ptr<mlir::Pass> createOutputBufferPass(bool lineBuffered);
+
 /// GC Pass to replace malloc, realloc, free with GC_malloc, GC_realloc, GC_free
 std::unique_ptr<mlir::Pass> createGCPass();
 
@@ -3,6 +3,11 @@
 
 #include "mlir/IR/Dialect.h"
 
+#include "llvm/ADT/SmallVector.h"
+
+#include <map>
+#include <mutex>
+
 #include "TypeScript/TypeScriptOpsDialect.h.inc"
 
 #endif // TYPESCRIPT_TYPESCRIPTDIALECT_H
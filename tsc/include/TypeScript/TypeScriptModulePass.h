@@ -0,0 +1,28 @@
+#ifndef TYPESCRIPT_TYPESCRIPTMODULEPASS_H
+#define TYPESCRIPT_TYPESCRIPTMODULEPASS_H
+
+#include "mlir/IR/BuiltinOps.h"
+#include "mlir/Pass/Pass.h"
+
+class TypeScriptModulePass : public mlir::OperationPass<mlir::ModuleOp>
+{
+  public:
+    using mlir::OperationPass<mlir::ModuleOp>::OperationPass;
+
+    /// The polymorphic API that runs the pass over the currently held module.
+    virtual void runOnModule() = 0;
+
+    /// The polymorphic API that runs the pass over the currently held operation.
+    void runOnOperation() final
+    {
+        runOnModule();
+    }
+
+    /// Return the current module being transformed.
+    mlir::ModuleOp getModule()
+    {
+        return this->getOperation();
+    }
+};
+
+#endif // TYPESCRIPT_TYPESCRIPTMODULEPASS_H
@@ -1 +0,0 @@
-void _mlir__enable_execute_stack(void *addr);
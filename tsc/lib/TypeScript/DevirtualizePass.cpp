@@ -0,0 +1,441 @@
+#define DEBUG_TYPE "pass"
+
+#include "mlir/Pass/Pass.h"
+
+#include "TypeScript/Config.h"
+#include "TypeScript/Defines.h"
+#include "TypeScript/TypeScriptDialect.h"
+#include "TypeScript/TypeScriptOps.h"
+#include "TypeScript/Passes.h"
+#include "TypeScript/TypeScriptModulePass.h"
+
+#include "mlir/IR/BuiltinOps.h"
+#include "mlir/IR/SymbolTable.h"
+
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/SetVector.h"
+#include "llvm/ADT/StringMap.h"
+#include "llvm/Support/Debug.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include "scanner_enums.h"
+
+namespace mlir_ts = mlir::typescript;
+
+namespace
+{
+
+// Class hierarchy analysis. All classes of program are known when module has 'main' (classes of other modules are
+// declarations), so the targets of virtual call are the methods in vtables of static class of 'this' and all its
+// derived classes:
+//  - one target: call is replaced with direct call
+//  - two targets: method in vtable is compared with the first target, both branches call the methods directly
+//
+//    %0 = ts.ThisVirtualSymbolRef(%this, %vtbl[3]) {identifier = @Base.foo}
+//    %1 = ts.get_method %0
+//    %2 = ts.get_this %0
+//    ts.CallIndirect %1(%2, %args)
+//
+//  ->
+//
+//    ts.Call @Derived.foo(cast %this, %args)
+class DevirtualizePass : public mlir::PassWrapper<DevirtualizePass, TypeScriptModulePass>
+{
+    struct ClassNode
+    {
+        mlir_ts::ClassType classType;
+        mlir::StringRef baseName;
+        // vtable is not known (class is declared in other module)
+        bool isExternal = false;
+        bool hasVTable = false;
+        llvm::DenseMap<int, mlir::FlatSymbolRefAttr> vtable;
+    };
+
+    llvm::StringMap<ClassNode> classes;
+
+  public:
+    void runOnModule() override
+    {
+        auto module = getModule();
+
+        // library can be extended by other modules
+        auto mainFunc = module.lookupSymbol<mlir_ts::FuncOp>(MAIN_ENTRY_NAME);
+        if (!mainFunc || mainFunc.isExternal())
+        {
+            return;
+        }
+
+        collectClasses(module);
+
+        mlir::SmallVector<mlir_ts::CallIndirectOp> workList;
+        module.walk([&](mlir_ts::CallIndirectOp callIndirectOp) {
+            if (getVirtualSymbolRef(callIndirectOp))
+            {
+                workList.push_back(callIndirectOp);
+            }
+        });
+
+        mlir::SymbolTable symbolTable(module);
+        for (auto callIndirectOp : workList)
+        {
+            devirtualize(callIndirectOp, symbolTable);
+        }
+    }
+
+  private:
+    // ThisVirtualSymbolRefOp which is used as method and this of call
+    mlir_ts::ThisVirtualSymbolRefOp getVirtualSymbolRef(mlir_ts::CallIndirectOp callIndirectOp)
+    {
+        auto getMethodOp = callIndirectOp.getCallee().getDefiningOp<mlir_ts::GetMethodOp>();
+        if (!getMethodOp)
+        {
+            return mlir_ts::ThisVirtualSymbolRefOp();
+        }
+
+        auto thisVirtualSymbolRefOp = getMethodOp.boundFunc().getDefiningOp<mlir_ts::ThisVirtualSymbolRefOp>();
+        if (!thisVirtualSymbolRefOp || callIndirectOp.getArgOperands().empty())
+        {
+            return mlir_ts::ThisVirtualSymbolRefOp();
+        }
+
+        auto getThisOp = callIndirectOp.getArgOperands().front().getDefiningOp<mlir_ts::GetThisOp>();
+        if (!getThisOp || getThisOp.boundFunc() != thisVirtualSymbolRefOp.getResult())
+        {
+            return mlir_ts::ThisVirtualSymbolRefOp();
+        }
+
+        return thisVirtualSymbolRefOp;
+    }
+
+    void addClass(mlir::Type type)
+    {
+        auto classType = type.dyn_cast_or_null<mlir_ts::ClassType>();
+        if (!classType)
+        {
+            return;
+        }
+
+        auto name = classType.getName().getValue();
+        if (classes.count(name))
+        {
+            return;
+        }
+
+        auto &node = classes[name];
+        node.classType = classType;
+        if (auto storageType = classType.getStorageType().dyn_cast_or_null<mlir_ts::ClassStorageType>())
+        {
+            for (auto &field : storageType.getFields())
+            {
+                if (auto baseStorageType = field.type.dyn_cast_or_null<mlir_ts::ClassStorageType>())
+                {
+                    node.baseName = baseStorageType.getName().getValue();
+                }
+            }
+        }
+    }
+
+    void collectClasses(mlir::ModuleOp module)
+    {
+        module.walk([&](mlir::Operation *op) {
+            if (auto funcOp = dyn_cast<mlir_ts::FuncOp>(op))
+            {
+                for (auto inputType : funcOp.getType().getInputs())
+                {
+                    addClass(inputType);
+                }
+
+                return;
+            }
+
+            for (auto resultType : op->getResultTypes())
+            {
+                addClass(resultType);
+            }
+        });
+
+        // classes with methods declared in other modules
+        module.walk([&](mlir_ts::FuncOp funcOp) {
+            if (funcOp.isExternal() && funcOp.getType().getNumInputs() > 0)
+            {
+                if (auto classType = funcOp.getType().getInput(0).dyn_cast<mlir_ts::ClassType>())
+                {
+                    classes[classType.getName().getValue()].isExternal = true;
+                }
+            }
+        });
+
+        for (auto &classEntry : classes)
+        {
+            auto &node = classEntry.getValue();
+            auto vtableName = (classEntry.getKey() + VTABLE_NAME).str();
+            auto globalOp = module.lookupSymbol<mlir_ts::GlobalOp>(vtableName);
+            if (!globalOp)
+            {
+                // abstract class
+                continue;
+            }
+
+            node.hasVTable = true;
+            if (globalOp.getInitializerRegion().empty())
+            {
+                node.isExternal = true;
+                continue;
+            }
+
+            for (auto &op : globalOp.getInitializerRegion().front())
+            {
+                if (auto insertPropertyOp = dyn_cast<mlir_ts::InsertPropertyOp>(op))
+                {
+                    if (insertPropertyOp.position().size() != 1)
+                    {
+                        continue;
+                    }
+
+                    auto index = insertPropertyOp.position()[0].cast<mlir::IntegerAttr>().getInt();
+                    if (auto symbolRefOp = insertPropertyOp.value().getDefiningOp<mlir_ts::SymbolRefOp>())
+                    {
+                        node.vtable[index] = symbolRefOp.identifierAttr();
+                    }
+                }
+            }
+        }
+    }
+
+    bool isDerivedOrSame(mlir::StringRef name, mlir::StringRef baseName)
+    {
+        while (!name.empty())
+        {
+            if (name == baseName)
+            {
+                return true;
+            }
+
+            auto it = classes.find(name);
+            if (it == classes.end())
+            {
+                return false;
+            }
+
+            name = it->getValue().baseName;
+        }
+
+        return false;
+    }
+
+    bool hasExternalBase(mlir::StringRef name)
+    {
+        while (!name.empty())
+        {
+            auto it = classes.find(name);
+            if (it == classes.end() || it->getValue().isExternal)
+            {
+                return true;
+            }
+
+            name = it->getValue().baseName;
+        }
+
+        return false;
+    }
+
+    // returns false if one of possible targets is not known
+    bool getTargets(mlir::StringRef className, int index, llvm::SetVector<mlir::StringRef> &targets)
+    {
+        if (hasExternalBase(className))
+        {
+            return false;
+        }
+
+        for (auto &classEntry : classes)
+        {
+            auto &node = classEntry.getValue();
+            if (!isDerivedOrSame(classEntry.getKey(), className))
+            {
+                continue;
+            }
+
+            if (node.isExternal)
+            {
+                return false;
+            }
+
+            if (!node.hasVTable)
+            {
+                continue;
+            }
+
+            auto it = node.vtable.find(index);
+            if (it == node.vtable.end())
+            {
+                return false;
+            }
+
+            targets.insert(it->second.getValue());
+        }
+
+        return true;
+    }
+
+    // 'this' is casted to type of target method, other operands and results must match
+    bool canCall(mlir_ts::CallIndirectOp callIndirectOp, mlir_ts::FuncOp targetFuncOp)
+    {
+        if (!targetFuncOp)
+        {
+            return false;
+        }
+
+        auto funcType = targetFuncOp.getType();
+        auto args = callIndirectOp.getArgOperands();
+        if (funcType.getNumInputs() != args.size() || funcType.getNumResults() != callIndirectOp.getNumResults())
+        {
+            return false;
+        }
+
+        if (!funcType.getInput(0).isa<mlir_ts::ClassType>())
+        {
+            return false;
+        }
+
+        for (auto index = 1; index < static_cast<int>(args.size()); index++)
+        {
+            if (args[index].getType() != funcType.getInput(index))
+            {
+                return false;
+            }
+        }
+
+        for (auto index = 0; index < static_cast<int>(funcType.getNumResults()); index++)
+        {
+            if (callIndirectOp.getResult(index).getType() != funcType.getResult(index))
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    mlir::ValueRange createDirectCall(mlir::OpBuilder &builder, mlir_ts::CallIndirectOp callIndirectOp,
+                                      mlir_ts::ThisVirtualSymbolRefOp thisVirtualSymbolRefOp,
+                                      mlir_ts::FuncOp targetFuncOp)
+    {
+        auto loc = callIndirectOp->getLoc();
+
+        mlir::Value thisVal = thisVirtualSymbolRefOp.thisVal();
+        auto thisType = targetFuncOp.getType().getInput(0);
+        if (thisVal.getType() != thisType)
+        {
+            thisVal = builder.create<mlir_ts::CastOp>(loc, thisType, thisVal);
+        }
+
+        mlir::SmallVector<mlir::Value> args;
+        args.push_back(thisVal);
+        auto restArgs = callIndirectOp.getArgOperands().drop_front();
+        args.append(restArgs.begin(), restArgs.end());
+
+        auto callOp = builder.create<mlir_ts::CallOp>(loc, targetFuncOp.getName(), callIndirectOp.getResultTypes(), args);
+        return callOp.getResults();
+    }
+
+    // ts.get_method and ts.get_this are removed only by next canonicalizer, remove them here to release 'this' for
+    // other passes (EscapeAnalysisPass)
+    void eraseCall(mlir_ts::CallIndirectOp callIndirectOp, mlir_ts::ThisVirtualSymbolRefOp thisVirtualSymbolRefOp)
+    {
+        auto getMethodOp = callIndirectOp.getCallee().getDefiningOp();
+        auto getThisOp = callIndirectOp.getArgOperands().front().getDefiningOp();
+
+        callIndirectOp->erase();
+
+        for (auto op : {getMethodOp, getThisOp})
+        {
+            if (op->use_empty())
+            {
+                op->erase();
+            }
+        }
+
+        if (thisVirtualSymbolRefOp->use_empty())
+        {
+            thisVirtualSymbolRefOp->erase();
+        }
+    }
+
+    void devirtualize(mlir_ts::CallIndirectOp callIndirectOp, mlir::SymbolTable &symbolTable)
+    {
+        auto thisVirtualSymbolRefOp = getVirtualSymbolRef(callIndirectOp);
+        auto classType = thisVirtualSymbolRefOp.thisVal().getType().dyn_cast<mlir_ts::ClassType>();
+        auto index = static_cast<int>(thisVirtualSymbolRefOp.index());
+        if (!classType || index < 0)
+        {
+            return;
+        }
+
+        llvm::SetVector<mlir::StringRef> targets;
+        if (!getTargets(classType.getName().getValue(), index, targets) || targets.empty() ||
+            targets.size() > 2)
+        {
+            return;
+        }
+
+        mlir::SmallVector<mlir_ts::FuncOp> targetFuncOps;
+        for (auto target : targets)
+        {
+            auto targetFuncOp = symbolTable.lookup<mlir_ts::FuncOp>(target);
+            if (!canCall(callIndirectOp, targetFuncOp))
+            {
+                return;
+            }
+
+            targetFuncOps.push_back(targetFuncOp);
+        }
+
+        LLVM_DEBUG(llvm::dbgs() << "\n!! devirtualizing: " << callIndirectOp << " targets: " << targets.size() << "\n";);
+
+        auto loc = callIndirectOp->getLoc();
+        mlir::OpBuilder builder(callIndirectOp);
+
+        if (targetFuncOps.size() == 1)
+        {
+            auto results = createDirectCall(builder, callIndirectOp, thisVirtualSymbolRefOp, targetFuncOps.front());
+            callIndirectOp->replaceAllUsesWith(results);
+            eraseCall(callIndirectOp, thisVirtualSymbolRefOp);
+            return;
+        }
+
+        // guarded call: vtable[index] == first target ? first target() : second target()
+        auto opaqueType = mlir_ts::OpaqueType::get(builder.getContext());
+        auto methodPtr = builder.create<mlir_ts::VTableOffsetRefOp>(loc, opaqueType, thisVirtualSymbolRefOp.vtable(), index);
+        auto firstTarget = builder.create<mlir_ts::SymbolRefOp>(
+            loc, targetFuncOps.front().getType(),
+            mlir::FlatSymbolRefAttr::get(builder.getContext(), targetFuncOps.front().getName()));
+        auto firstTargetPtr = builder.create<mlir_ts::CastOp>(loc, opaqueType, firstTarget);
+        auto isFirstTarget = builder.create<mlir_ts::LogicalBinaryOp>(
+            loc, mlir_ts::BooleanType::get(builder.getContext()),
+            builder.getI32IntegerAttr((int)SyntaxKind::EqualsEqualsToken), methodPtr, firstTargetPtr);
+
+        auto resultTypes = callIndirectOp.getResultTypes();
+        auto ifOp = builder.create<mlir_ts::IfOp>(loc, resultTypes, isFirstTarget, true);
+
+        auto createBranch = [&](mlir::OpBuilder branchBuilder, mlir_ts::FuncOp targetFuncOp) {
+            auto results = createDirectCall(branchBuilder, callIndirectOp, thisVirtualSymbolRefOp, targetFuncOp);
+            if (!resultTypes.empty())
+            {
+                branchBuilder.create<mlir_ts::ResultOp>(loc, results);
+            }
+        };
+
+        createBranch(ifOp.getThenBodyBuilder(), targetFuncOps[0]);
+        createBranch(ifOp.getElseBodyBuilder(), targetFuncOps[1]);
+
+        callIndirectOp->replaceAllUsesWith(ifOp.getResults());
+        eraseCall(callIndirectOp, thisVirtualSymbolRefOp);
+    }
+};
+} // end anonymous namespace
+
+/// Create a class hierarchy analysis pass to replace virtual calls with direct calls.
+std::unique_ptr<mlir::Pass> mlir_ts::createDevirtualizePass()
+{
+    return std::make_unique<DevirtualizePass>();
+}
@@ -0,0 +1,436 @@
+#define DEBUG_TYPE "pass"
+
+#include "mlir/Pass/Pass.h"
+
+#include "TypeScript/Config.h"
+#include "TypeScript/Defines.h"
+#include "TypeScript/TypeScriptDialect.h"
+#include "TypeScript/TypeScriptOps.h"
+#include "TypeScript/Passes.h"
+#include "TypeScript/TypeScriptModulePass.h"
+
+#include "mlir/IR/BlockAndValueMapping.h"
+#include "mlir/IR/BuiltinOps.h"
+#include "mlir/IR/SymbolTable.h"
+
+#ifdef ENABLE_ASYNC
+#include "mlir/Dialect/Async/IR/Async.h"
+#endif
+
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/SmallPtrSet.h"
+#include "llvm/Support/Debug.h"
+#include "llvm/Support/raw_ostream.h"
+
+namespace mlir_ts = mlir::typescript;
+
+namespace
+{
+
+// Finds values which do not outlive function where they are created and puts them in stack:
+//  - ts.New => stackAlloc = true
+//  - ts.Call @Class..new() (allocation of class instance) => ts.New {stackAlloc = true} + initialization of vtable
+//  - ts.Capture and captured ts.Variable => attribute STACK_ALLOC_ATTR_NAME
+//
+// value escapes if it is stored in memory (except local variables), returned, sent to unknown function or used by
+// operation which is not known here. Parameters of functions are analysed the same way to allow calls of
+// constructors and methods.
+class EscapeAnalysisPass : public mlir::PassWrapper<EscapeAnalysisPass, TypeScriptModulePass>
+{
+    static constexpr int MaxDepth = 16;
+
+    mlir::SymbolTable *symbolTable = nullptr;
+
+    // (function, argument index) => escapes
+    llvm::DenseMap<std::pair<mlir::Operation *, unsigned>, bool> argEscapesCache;
+
+  public:
+    void runOnModule() override
+    {
+        auto module = getModule();
+
+        mlir::SymbolTable moduleSymbolTable(module);
+        symbolTable = &moduleSymbolTable;
+
+        mlir::SmallVector<mlir::Operation *> candidates;
+        module.walk([&](mlir::Operation *op) {
+            if (!op->getParentOfType<mlir_ts::FuncOp>())
+            {
+                return;
+            }
+
+            if (auto newOp = dyn_cast<mlir_ts::NewOp>(op))
+            {
+                if (!newOp.stackAlloc().hasValue() || !newOp.stackAlloc().getValue())
+                {
+                    candidates.push_back(op);
+                }
+            }
+            else if (auto callOp = dyn_cast<mlir_ts::CallOp>(op))
+            {
+                if (getAllocation(symbolTable->lookup<mlir_ts::FuncOp>(callOp.getCallee())))
+                {
+                    candidates.push_back(op);
+                }
+            }
+            else if (isa<mlir_ts::CaptureOp>(op))
+            {
+                candidates.push_back(op);
+            }
+            else if (auto variableOp = dyn_cast<mlir_ts::VariableOp>(op))
+            {
+                if (variableOp.captured().hasValue() && variableOp.captured().getValue())
+                {
+                    candidates.push_back(op);
+                }
+            }
+        });
+
+        for (auto op : candidates)
+        {
+            if (valueEscapes(op->getResult(0), 0))
+            {
+                continue;
+            }
+
+            LLVM_DEBUG(llvm::dbgs() << "\n!! does not escape: " << *op << "\n";);
+
+            if (auto newOp = dyn_cast<mlir_ts::NewOp>(op))
+            {
+                mlir::OpBuilder builder(newOp);
+                newOp.stackAllocAttr(builder.getBoolAttr(true));
+            }
+            else if (auto callOp = dyn_cast<mlir_ts::CallOp>(op))
+            {
+                allocateInStack(callOp);
+            }
+            else
+            {
+                op->setAttr(STACK_ALLOC_ATTR_NAME, mlir::UnitAttr::get(op->getContext()));
+            }
+        }
+
+        symbolTable = nullptr;
+    }
+
+  private:
+    // returns allocation of function which only allocates class instance and initializes it (Class..new)
+    mlir::Operation *getAllocation(mlir_ts::FuncOp funcOp)
+    {
+        if (!funcOp || funcOp.isExternal() || funcOp.getType().getNumInputs() != 0 ||
+            funcOp.getType().getNumResults() != 1 || !funcOp.getType().getResult(0).isa<mlir_ts::ClassType>() ||
+            !funcOp.getBody().hasOneBlock())
+        {
+            return nullptr;
+        }
+
+        mlir_ts::ReturnValOp returnValOp;
+        auto count = 0;
+        funcOp.walk([&](mlir_ts::ReturnValOp op) {
+            returnValOp = op;
+            count++;
+        });
+
+        if (count != 1 || returnValOp->getBlock() != &funcOp.getBody().front())
+        {
+            return nullptr;
+        }
+
+        mlir::Value value = returnValOp.operand();
+        while (auto castOp = value.getDefiningOp<mlir_ts::CastOp>())
+        {
+            value = castOp.in();
+        }
+
+        auto allocOp = value.getDefiningOp();
+        if (!allocOp || allocOp->getBlock() != returnValOp->getBlock() ||
+            !isa<mlir_ts::NewOp, mlir_ts::GCNewExplicitlyTypedOp>(allocOp) ||
+            !value.getType().isa<mlir_ts::ClassType>())
+        {
+            return nullptr;
+        }
+
+        return allocOp;
+    }
+
+    // replaces call of Class..new with its body where instance is allocated in stack
+    void allocateInStack(mlir_ts::CallOp callOp)
+    {
+        auto funcOp = symbolTable->lookup<mlir_ts::FuncOp>(callOp.getCallee());
+        auto allocOp = getAllocation(funcOp);
+        auto &block = funcOp.getBody().front();
+
+        // skip allocation and all ops which are needed only for it (type descriptor for GC)
+        llvm::SmallPtrSet<mlir::Operation *, 16> skipOps;
+        skipOps.insert(allocOp);
+        for (auto &op : llvm::reverse(block))
+        {
+            if (isReturnLogic(&op))
+            {
+                continue;
+            }
+
+            if (op.getNumResults() > 0 && !op.use_empty() &&
+                llvm::all_of(op.getUsers(), [&](mlir::Operation *user) { return skipOps.count(user) > 0; }))
+            {
+                skipOps.insert(&op);
+            }
+        }
+
+        mlir_ts::ReturnValOp returnValOp;
+        funcOp.walk([&](mlir_ts::ReturnValOp op) { returnValOp = op; });
+
+        mlir::OpBuilder builder(callOp);
+        mlir::BlockAndValueMapping mapping;
+
+        auto newOp =
+            builder.create<mlir_ts::NewOp>(allocOp->getLoc(), allocOp->getResult(0).getType(), builder.getBoolAttr(true));
+        mapping.map(allocOp->getResult(0), newOp.getResult());
+
+        for (auto &op : block)
+        {
+            if (isReturnLogic(&op) || skipOps.count(&op))
+            {
+                continue;
+            }
+
+            builder.clone(op, mapping);
+        }
+
+        mlir::Value result = mapping.lookupOrDefault(returnValOp.operand());
+        if (result.getType() != callOp.getResult(0).getType())
+        {
+            result = builder.create<mlir_ts::CastOp>(callOp->getLoc(), callOp.getResult(0).getType(), result);
+        }
+
+        callOp.getResult(0).replaceAllUsesWith(result);
+        callOp->erase();
+    }
+
+    bool isReturnLogic(mlir::Operation *op)
+    {
+        return isa<mlir_ts::EntryOp, mlir_ts::ReturnValOp, mlir_ts::ReturnOp, mlir_ts::ExitOp>(op);
+    }
+
+    bool argEscapes(mlir_ts::FuncOp funcOp, unsigned index, int depth)
+    {
+        if (!funcOp || funcOp.isExternal() || index >= funcOp.getNumArguments())
+        {
+            return true;
+        }
+
+        auto key = std::make_pair(funcOp.getOperation(), index);
+        auto it = argEscapesCache.find(key);
+        if (it != argEscapesCache.end())
+        {
+            return it->second;
+        }
+
+        // recursive call => escapes
+        argEscapesCache[key] = true;
+        auto escapes = valueEscapes(funcOp.getArgument(index), depth + 1);
+        argEscapesCache[key] = escapes;
+        return escapes;
+    }
+
+    // local variable (or parameter) which holds value
+    bool localVariableEscapes(mlir::Value reference, int depth)
+    {
+        for (auto &use : reference.getUses())
+        {
+            auto user = use.getOwner();
+            if (auto loadOp = dyn_cast<mlir_ts::LoadOp>(user))
+            {
+                if (valueEscapes(loadOp.getResult(), depth + 1))
+                {
+                    return true;
+                }
+
+                continue;
+            }
+
+            if (auto storeOp = dyn_cast<mlir_ts::StoreOp>(user))
+            {
+                if (storeOp.reference() == reference && storeOp.value() != reference)
+                {
+                    continue;
+                }
+            }
+
+            return true;
+        }
+
+        return false;
+    }
+
+    // reference to field of value
+    bool fieldEscapes(mlir::Value reference, int depth)
+    {
+        for (auto &use : reference.getUses())
+        {
+            auto user = use.getOwner();
+            if (auto loadOp = dyn_cast<mlir_ts::LoadOp>(user))
+            {
+                // captured variable is stored in capture as reference
+                if (loadOp.getType().isa<mlir_ts::RefType>() && valueEscapes(loadOp.getResult(), depth + 1))
+                {
+                    return true;
+                }
+
+                continue;
+            }
+
+            if (auto storeOp = dyn_cast<mlir_ts::StoreOp>(user))
+            {
+                if (storeOp.reference() == reference && storeOp.value() != reference)
+                {
+                    continue;
+                }
+            }
+
+            return true;
+        }
+
+        return false;
+    }
+
+    bool isUsedInOtherContext(mlir::Value value, mlir::Operation *user)
+    {
+#ifdef ENABLE_ASYNC
+        // body of async.execute is moved into other function
+        mlir::Operation *defOp = value.getDefiningOp();
+        if (!defOp)
+        {
+            defOp = value.getParentBlock()->getParentOp();
+        }
+
+        return defOp->getParentOfType<mlir::async::ExecuteOp>() != user->getParentOfType<mlir::async::ExecuteOp>();
+#else
+        return false;
+#endif
+    }
+
+    bool valueEscapes(mlir::Value value, int depth)
+    {
+        if (depth > MaxDepth)
+        {
+            return true;
+        }
+
+        for (auto &use : value.getUses())
+        {
+            auto user = use.getOwner();
+            if (isUsedInOtherContext(value, user))
+            {
+                return true;
+            }
+
+            if (isa<mlir_ts::LoadOp>(user))
+            {
+                continue;
+            }
+
+            if (auto storeOp = dyn_cast<mlir_ts::StoreOp>(user))
+            {
+                if (storeOp.reference() == value && storeOp.value() != value)
+                {
+                    continue;
+                }
+
+                return true;
+            }
+
+            if (auto propertyRefOp = dyn_cast<mlir_ts::PropertyRefOp>(user))
+            {
+                if (fieldEscapes(propertyRefOp.getResult(), depth + 1))
+                {
+                    return true;
+                }
+
+                continue;
+            }
+
+            if (auto variableOp = dyn_cast<mlir_ts::VariableOp>(user))
+            {
+                auto captured = variableOp.captured().hasValue() && variableOp.captured().getValue();
+                // variable must be initialized each time when value is created
+                if (captured || variableOp->getBlock() != value.getParentBlock() ||
+                    localVariableEscapes(variableOp.reference(), depth + 1))
+                {
+                    return true;
+                }
+
+                continue;
+            }
+
+            if (auto paramOp = dyn_cast<mlir_ts::ParamOp>(user))
+            {
+                auto captured = paramOp.captured().hasValue() && paramOp.captured().getValue();
+                if (captured || localVariableEscapes(paramOp.reference(), depth + 1))
+                {
+                    return true;
+                }
+
+                continue;
+            }
+
+            if (auto castOp = dyn_cast<mlir_ts::CastOp>(user))
+            {
+                if (!castOp.getType().isa<mlir_ts::BooleanType>() && valueEscapes(castOp.getResult(), depth + 1))
+                {
+                    return true;
+                }
+
+                continue;
+            }
+
+            if (isa<mlir_ts::LogicalBinaryOp, mlir_ts::GetMethodOp>(user))
+            {
+                continue;
+            }
+
+            // closure, 'this' of it is captured data
+            if (isa<mlir_ts::CreateBoundFunctionOp, mlir_ts::GetThisOp>(user))
+            {
+                if (valueEscapes(user->getResult(0), depth + 1))
+                {
+                    return true;
+                }
+
+                continue;
+            }
+
+            if (auto captureOp = dyn_cast<mlir_ts::CaptureOp>(user))
+            {
+                if (valueEscapes(captureOp.getResult(), depth + 1))
+                {
+                    return true;
+                }
+
+                continue;
+            }
+
+            if (auto callOp = dyn_cast<mlir_ts::CallOp>(user))
+            {
+                if (argEscapes(symbolTable->lookup<mlir_ts::FuncOp>(callOp.getCallee()), use.getOperandNumber(),
+                               depth))
+                {
+                    return true;
+                }
+
+                continue;
+            }
+
+            return true;
+        }
+
+        return false;
+    }
+};
+} // end anonymous namespace
+
+/// Create a pass to allocate values which do not outlive function in stack.
+std::unique_ptr<mlir::Pass> mlir_ts::createEscapeAnalysisPass()
+{
+    return std::make_unique<EscapeAnalysisPass>();
+}
@@ -5,6 +5,7 @@
 #include "TypeScript/TypeScriptDialect.h"
 #include "TypeScript/TypeScriptOps.h"
 #include "TypeScript/TypeScriptFunctionPass.h"
+#include "TypeScript/TypeScriptModulePass.h"
 #include "TypeScript/Passes.h"
 
 #include "TypeScript/LowerToLLVMLogic.h"
@@ -21,28 +22,7 @@ namespace mlir_ts = mlir::typescript;
 namespace
 {
 
-class ModulePass : public OperationPass<mlir::ModuleOp>
-{
-  public:
-    using OperationPass<mlir::ModuleOp>::OperationPass;
-
-    /// The polymorphic API that runs the pass over the currently held function.
-    virtual void runOnModule() = 0;
-
-    /// The polymorphic API that runs the pass over the currently held operation.
-    void runOnOperation() final
-    {
-        runOnModule();
-    }
-
-    /// Return the current function being transformed.
-    mlir::ModuleOp getModule()
-    {
-        return this->getOperation();
-    }
-};
-
-class GCPass : public mlir::PassWrapper<GCPass, ModulePass>
+class GCPass : public mlir::PassWrapper<GCPass, TypeScriptModulePass>
 {
   public:
     void runOnModule() override
@@ -0,0 +1,221 @@
+#define DEBUG_TYPE "pass"
+
+#include "mlir/Pass/Pass.h"
+
+#include "TypeScript/Config.h"
+#include "TypeScript/Defines.h"
+#include "TypeScript/TypeScriptDialect.h"
+#include "TypeScript/TypeScriptOps.h"
+#include "TypeScript/Passes.h"
+#include "TypeScript/TypeScriptModulePass.h"
+
+#include "mlir/Dialect/StandardOps/IR/Ops.h"
+#include "mlir/IR/BuiltinOps.h"
+#include "mlir/IR/SymbolTable.h"
+
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/Support/Debug.h"
+#include "llvm/Support/raw_ostream.h"
+
+namespace mlir_ts = mlir::typescript;
+
+namespace
+{
+
+// 'next' method of generator compiled with --coroutines has ts.SwitchState with reference to the field of generator
+// object to keep coroutine handle. The method is split into two functions:
+//  - 'next__coro' is body of LLVM coroutine: 'yield' stores value in promise of coroutine and suspends it, 'return'
+//    stores value and suspends coroutine at final suspend point
+//  - 'next' starts coroutine at first call and resumes it at next calls, result is loaded from promise of coroutine
+//
+//    func @next(%this) {
+//      %0 = ts.Entry
+//      %coro = ts.PropertyRef %this, "_coro_"
+//      ts.SwitchState %step, %coro ^body
+//      ...
+//    }
+//
+//  ->
+//
+//    func @next(%this) {
+//      %0 = ts.Entry
+//      ts.If %step != 0 { if (!ts.CoroutineDone %h) ts.CoroutineResume %h } else { ts.Call @next__coro(%this) }
+//      ts.Store (ts.Load (ts.CoroutinePromise %h)), %0
+//      ts.Exit %0
+//    }
+class GeneratorToCoroutinePass : public mlir::PassWrapper<GeneratorToCoroutinePass, TypeScriptModulePass>
+{
+  public:
+    void runOnModule() override
+    {
+        auto module = getModule();
+
+        llvm::SmallVector<mlir_ts::FuncOp> generators;
+        module.walk([&](mlir_ts::FuncOp funcOp) {
+            auto switchStateOp = findOp<mlir_ts::SwitchStateOp>(funcOp);
+            if (switchStateOp && switchStateOp.coroutine())
+            {
+                generators.push_back(funcOp);
+            }
+        });
+
+        for (auto funcOp : generators)
+        {
+            auto coroFuncOp = createCoroutine(funcOp);
+            createResumer(funcOp, coroFuncOp);
+        }
+    }
+
+    template <typename TyOp> TyOp findOp(mlir_ts::FuncOp funcOp)
+    {
+        TyOp found;
+        funcOp.walk([&](TyOp op) {
+            found = op;
+            return mlir::WalkResult::interrupt();
+        });
+
+        return found;
+    }
+
+    mlir_ts::FuncOp createCoroutine(mlir_ts::FuncOp funcOp)
+    {
+        auto *context = funcOp.getContext();
+
+        auto coroFuncOp = funcOp.clone();
+        mlir::SymbolTable::setSymbolName(coroFuncOp, (funcOp.getName() + "__coro").str());
+        mlir::SymbolTable::setSymbolVisibility(coroFuncOp, mlir::SymbolTable::Visibility::Private);
+
+        // result is returned via promise
+        auto funcType = funcOp.getType();
+        auto coroFuncType = mlir_ts::FunctionType::get(context, funcType.getInputs(), {}, funcType.isVarArg());
+        coroFuncOp->setAttr(mlir_ts::FuncOp::getTypeAttrName(), mlir::TypeAttr::get(coroFuncType));
+
+        mlir::OpBuilder builder(funcOp);
+        builder.setInsertionPointAfter(funcOp);
+        builder.insert(coroFuncOp);
+
+        auto entryOp = findOp<mlir_ts::EntryOp>(coroFuncOp);
+        auto loc = entryOp->getLoc();
+        auto promiseType = entryOp.reference().getType();
+
+        builder.setInsertionPoint(entryOp);
+        builder.create<mlir_ts::EntryOp>(loc, mlir::Type());
+        auto promise = builder.create<mlir_ts::VariableOp>(loc, promiseType, mlir::Value(), builder.getBoolAttr(false));
+        auto handle =
+            builder.create<mlir_ts::CoroutineBeginOp>(loc, mlir_ts::OpaqueType::get(context), promise).getResult();
+
+        entryOp.reference().replaceAllUsesWith(promise);
+        entryOp->erase();
+
+        llvm::SmallVector<mlir::Operation *> workSet;
+        coroFuncOp.walk([&](mlir::Operation *op) {
+            if (isa<mlir_ts::SwitchStateOp>(op) || isa<mlir_ts::StateLabelOp>(op) ||
+                isa<mlir_ts::YieldReturnValOp>(op) || isa<mlir_ts::ReturnValOp>(op) || isa<mlir_ts::ReturnOp>(op) ||
+                isa<mlir_ts::ExitOp>(op))
+            {
+                workSet.push_back(op);
+            }
+        });
+
+        for (auto op : workSet)
+        {
+            builder.setInsertionPoint(op);
+            auto loc = op->getLoc();
+            if (auto switchStateOp = dyn_cast<mlir_ts::SwitchStateOp>(op))
+            {
+                // save handle to resume coroutine in next calls
+                builder.create<mlir_ts::StoreOp>(loc, handle, switchStateOp.coroutine());
+                builder.create<mlir::BranchOp>(loc, switchStateOp.defaultDest());
+            }
+            else if (auto yieldReturnValOp = dyn_cast<mlir_ts::YieldReturnValOp>(op))
+            {
+                builder.create<mlir_ts::StoreOp>(loc, yieldReturnValOp.operand(), yieldReturnValOp.reference());
+                builder.create<mlir_ts::CoroutineSuspendOp>(loc, handle, builder.getBoolAttr(false));
+            }
+            else if (auto returnValOp = dyn_cast<mlir_ts::ReturnValOp>(op))
+            {
+                builder.create<mlir_ts::StoreOp>(loc, returnValOp.operand(), returnValOp.reference());
+                builder.create<mlir_ts::CoroutineSuspendOp>(loc, handle, builder.getBoolAttr(true));
+                builder.create<mlir_ts::ReturnOp>(loc);
+            }
+            else if (isa<mlir_ts::ReturnOp>(op))
+            {
+                builder.create<mlir_ts::CoroutineSuspendOp>(loc, handle, builder.getBoolAttr(true));
+                continue;
+            }
+            else if (isa<mlir_ts::ExitOp>(op))
+            {
+                builder.create<mlir_ts::CoroutineSuspendOp>(loc, handle, builder.getBoolAttr(true));
+                builder.create<mlir_ts::ExitOp>(loc, mlir::Value());
+            }
+
+            op->erase();
+        }
+
+        return coroFuncOp;
+    }
+
+    void createResumer(mlir_ts::FuncOp funcOp, mlir_ts::FuncOp coroFuncOp)
+    {
+        auto *context = funcOp.getContext();
+
+        auto entryOp = findOp<mlir_ts::EntryOp>(funcOp);
+        auto switchStateOp = findOp<mlir_ts::SwitchStateOp>(funcOp);
+        auto loc = switchStateOp->getLoc();
+
+        auto retRef = entryOp.reference();
+        auto coroutineRef = switchStateOp.coroutine();
+        auto opaqueType = mlir_ts::OpaqueType::get(context);
+        auto booleanType = mlir_ts::BooleanType::get(context);
+
+        mlir::OpBuilder builder(switchStateOp);
+
+        // step is not 0 when coroutine is started
+        auto started = builder.create<mlir_ts::CastOp>(loc, booleanType, switchStateOp.state());
+        auto ifOp = builder.create<mlir_ts::IfOp>(loc, started, true);
+
+        auto thenBuilder = ifOp.getThenBodyBuilder();
+        auto handle = thenBuilder.create<mlir_ts::LoadOp>(loc, opaqueType, coroutineRef);
+        auto done = thenBuilder.create<mlir_ts::CoroutineDoneOp>(loc, booleanType, handle);
+        auto ifDoneOp = thenBuilder.create<mlir_ts::IfOp>(loc, done, true);
+        ifDoneOp.getElseBodyBuilder().create<mlir_ts::CoroutineResumeOp>(loc, handle);
+
+        ifOp.getElseBodyBuilder().create<mlir_ts::CallOp>(loc, coroFuncOp.getName(), mlir::TypeRange{},
+                                                          funcOp.getArguments());
+
+        auto resumedHandle = builder.create<mlir_ts::LoadOp>(loc, opaqueType, coroutineRef);
+        auto promise = builder.create<mlir_ts::CoroutinePromiseOp>(loc, retRef.getType(), resumedHandle);
+        auto value =
+            builder.create<mlir_ts::LoadOp>(loc, retRef.getType().cast<mlir_ts::RefType>().getElementType(), promise);
+        builder.create<mlir_ts::StoreOp>(loc, value, retRef);
+        builder.create<mlir_ts::ExitOp>(loc, retRef);
+
+        // body of generator is in coroutine now
+        auto *switchBlock = switchStateOp->getBlock();
+        switchStateOp->erase();
+
+        auto &region = funcOp.getBody();
+        llvm::SmallVector<mlir::Block *> bodyBlocks;
+        for (auto it = std::next(switchBlock->getIterator()); it != region.end(); ++it)
+        {
+            bodyBlocks.push_back(&*it);
+        }
+
+        for (auto *block : bodyBlocks)
+        {
+            block->dropAllReferences();
+        }
+
+        for (auto *block : bodyBlocks)
+        {
+            block->erase();
+        }
+    }
+};
+} // end anonymous namespace
+
+/// Create a pass to lower generators into LLVM coroutines.
+std::unique_ptr<mlir::Pass> mlir_ts::createGeneratorToCoroutinePass()
+{
+    return std::make_unique<GeneratorToCoroutinePass>();
+}
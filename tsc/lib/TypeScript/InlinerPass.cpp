@@ -0,0 +1,312 @@
+#define DEBUG_TYPE "pass"
+
+#include "mlir/Pass/Pass.h"
+
+#include "TypeScript/Config.h"
+#include "TypeScript/Defines.h"
+#include "TypeScript/TypeScriptDialect.h"
+#include "TypeScript/TypeScriptOps.h"
+#include "TypeScript/Passes.h"
+#include "TypeScript/TypeScriptModulePass.h"
+
+#include "mlir/IR/BlockAndValueMapping.h"
+#include "mlir/IR/BuiltinOps.h"
+#include "mlir/IR/SymbolTable.h"
+#include "mlir/Transforms/InliningUtils.h"
+
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/Support/Debug.h"
+#include "llvm/Support/raw_ostream.h"
+
+namespace mlir_ts = mlir::typescript;
+
+namespace
+{
+
+// Inlines direct calls (ts.Call, calls of getters by ts.Accessor/ts.ThisAccessor) of TypeScript functions before they
+// are lowered, so escape analysis and scalar replacement see the body of callee (class instance passed to small
+// method does not escape anymore). Indirect calls of known functions, bound functions and static methods are turned
+// into ts.Call by canonicalizer which runs before.
+//
+// Callee can be inlined when it has one block with returning value only at the end and its ops are legal to inline
+// according to the inliner interfaces of dialects (no try/throw, no coroutine etc.):
+//
+//    func @Vector.dot(%this, %v) -> number {
+//      %0 = ts.Entry : !ts.ref<number>
+//      %1 = ts.Param(%v)
+//      ...
+//      ts.ReturnVal %5, %0
+//      ts.Exit %0
+//    }
+//
+// Entry and Exit are dropped, value of ReturnVal replaces result of the call. Cost of function is the number of its ops,
+// callees up to INLINE_ALWAYS_COST (getters, setters and small helpers) are always inlined, callees up to
+// INLINE_COST_THRESHOLD are inlined while caller does not grow over INLINE_CALLER_BUDGET.
+class InlinerPass : public mlir::PassWrapper<InlinerPass, TypeScriptModulePass>
+{
+    llvm::DenseMap<mlir::Operation *, int> sizes;
+
+  public:
+    void runOnModule() override
+    {
+        auto module = getModule();
+
+        mlir::SymbolTable symbolTable(module);
+        mlir::InlinerInterface interface(module.getContext());
+
+        llvm::SmallVector<mlir::Operation *> calls;
+        module.walk([&](mlir::Operation *op) {
+            if (isa<mlir_ts::CallOp>(op) || isa<mlir_ts::AccessorOp>(op) || isa<mlir_ts::ThisAccessorOp>(op))
+            {
+                calls.push_back(op);
+            }
+        });
+
+        for (auto *op : calls)
+        {
+            auto calleeName = getCalleeName(op);
+            if (!calleeName)
+            {
+                continue;
+            }
+
+            auto callee = symbolTable.lookup<mlir_ts::FuncOp>(calleeName.getValue());
+            auto caller = op->getParentOfType<mlir_ts::FuncOp>();
+            if (!callee || !caller || callee == caller || !canInline(op, callee, caller, interface))
+            {
+                continue;
+            }
+
+            auto cost = getSize(callee);
+            auto callerSize = getSize(caller);
+            if (cost > INLINE_ALWAYS_COST && (cost > INLINE_COST_THRESHOLD || callerSize + cost > INLINE_CALLER_BUDGET))
+            {
+                continue;
+            }
+
+            LLVM_DEBUG(llvm::dbgs() << "\n!! inline: " << callee.getName() << " into " << caller.getName()
+                                    << " cost: " << cost << "\n";);
+
+            inlineCall(op, callee);
+            sizes[caller] = callerSize + cost;
+        }
+    }
+
+  private:
+    mlir::FlatSymbolRefAttr getCalleeName(mlir::Operation *op)
+    {
+        if (auto callOp = dyn_cast<mlir_ts::CallOp>(op))
+        {
+            return callOp.calleeAttr();
+        }
+
+        // getters only, setters are called by ts.Call
+        if (op->use_empty())
+        {
+            return mlir::FlatSymbolRefAttr();
+        }
+
+        if (auto accessorOp = dyn_cast<mlir_ts::AccessorOp>(op))
+        {
+            return accessorOp.getAccessorAttr();
+        }
+
+        if (auto thisAccessorOp = dyn_cast<mlir_ts::ThisAccessorOp>(op))
+        {
+            return thisAccessorOp.getAccessorAttr();
+        }
+
+        return mlir::FlatSymbolRefAttr();
+    }
+
+    mlir::SmallVector<mlir::Value> getArgs(mlir::Operation *op)
+    {
+        if (auto callOp = dyn_cast<mlir_ts::CallOp>(op))
+        {
+            auto args = callOp.getArgOperands();
+            return {args.begin(), args.end()};
+        }
+
+        if (auto thisAccessorOp = dyn_cast<mlir_ts::ThisAccessorOp>(op))
+        {
+            return {thisAccessorOp.thisVal()};
+        }
+
+        return {};
+    }
+
+    int getSize(mlir_ts::FuncOp funcOp)
+    {
+        auto it = sizes.find(funcOp);
+        if (it != sizes.end())
+        {
+            return it->second;
+        }
+
+        auto size = 0;
+        funcOp.walk([&](mlir::Operation *op) {
+            if (!isa<mlir_ts::FuncOp>(op) && !isa<mlir_ts::EntryOp>(op) && !isa<mlir_ts::ExitOp>(op) &&
+                !isa<mlir_ts::ParamOp>(op) && !isa<mlir_ts::ConstantOp>(op))
+            {
+                size++;
+            }
+        });
+
+        sizes[funcOp] = size;
+        return size;
+    }
+
+    bool canInline(mlir::Operation *op, mlir_ts::FuncOp callee, mlir_ts::FuncOp caller,
+                   mlir::InlinerInterface &interface)
+    {
+        if (callee.isExternal() || callee.getType().isVarArg() || callee->hasAttr(GENERIC_ATTR_NAME) ||
+            !callee.getBody().hasOneBlock())
+        {
+            return false;
+        }
+
+        auto args = getArgs(op);
+        if (args.size() != callee.getNumArguments() || op->getNumResults() != callee.getNumResults())
+        {
+            return false;
+        }
+
+        mlir::BlockAndValueMapping mapper;
+        if (!interface.isLegalToInline(op, callee, true) ||
+            !interface.isLegalToInline(&caller.getBody(), &callee.getBody(), true, mapper))
+        {
+            return false;
+        }
+
+        auto &block = callee.getBody().front();
+        auto exitOp = dyn_cast<mlir_ts::ExitOp>(block.getTerminator());
+        if (!exitOp)
+        {
+            return false;
+        }
+
+        // value is returned only by the op before ts.Exit
+        auto *lastOp = exitOp->getPrevNode();
+        auto returnValOp = dyn_cast_or_null<mlir_ts::ReturnValOp>(lastOp);
+        if (callee.getNumResults() > 0 && !returnValOp)
+        {
+            return false;
+        }
+
+        // return value is referenced only by ts.ReturnVal and ts.Exit
+        auto entryOp = dyn_cast<mlir_ts::EntryOp>(&block.front());
+        if (!entryOp)
+        {
+            return false;
+        }
+
+        if (auto returnRef = entryOp.reference())
+        {
+            for (auto *user : returnRef.getUsers())
+            {
+                if (user != returnValOp.getOperation() && user != exitOp.getOperation())
+                {
+                    return false;
+                }
+            }
+        }
+
+        auto result = callee.walk([&](mlir::Operation *calleeOp) {
+            if ((isa<mlir_ts::ReturnValOp>(calleeOp) || isa<mlir_ts::ReturnOp>(calleeOp)) && calleeOp != lastOp)
+            {
+                return mlir::WalkResult::interrupt();
+            }
+
+            // captured variables are allocated in heap and referenced by closures
+            if (isa<mlir_ts::CaptureOp>(calleeOp) || isCaptured(calleeOp))
+            {
+                return mlir::WalkResult::interrupt();
+            }
+
+            if (calleeOp != callee && calleeOp != exitOp &&
+                !interface.isLegalToInline(calleeOp, &caller.getBody(), true, mapper))
+            {
+                return mlir::WalkResult::interrupt();
+            }
+
+            return mlir::WalkResult::advance();
+        });
+
+        return !result.wasInterrupted();
+    }
+
+    bool isCaptured(mlir::Operation *op)
+    {
+        if (auto paramOp = dyn_cast<mlir_ts::ParamOp>(op))
+        {
+            return paramOp.captured().hasValue() && paramOp.captured().getValue();
+        }
+
+        if (auto variableOp = dyn_cast<mlir_ts::VariableOp>(op))
+        {
+            return variableOp.captured().hasValue() && variableOp.captured().getValue();
+        }
+
+        return false;
+    }
+
+    void inlineCall(mlir::Operation *op, mlir_ts::FuncOp callee)
+    {
+        mlir::OpBuilder builder(op);
+        auto loc = op->getLoc();
+
+        auto args = getArgs(op);
+
+        mlir::BlockAndValueMapping mapper;
+        for (auto arg : llvm::zip(callee.getArguments(), args))
+        {
+            auto calleeArg = std::get<0>(arg);
+            auto value = std::get<1>(arg);
+            if (value.getType() != calleeArg.getType())
+            {
+                value = builder.create<mlir_ts::CastOp>(loc, calleeArg.getType(), value);
+            }
+
+            mapper.map(calleeArg, value);
+        }
+
+        mlir::Value result;
+        for (auto &calleeOp : callee.getBody().front())
+        {
+            if (isa<mlir_ts::EntryOp>(calleeOp) || isa<mlir_ts::ExitOp>(calleeOp) ||
+                isa<mlir_ts::ReturnOp>(calleeOp))
+            {
+                continue;
+            }
+
+            if (auto returnValOp = dyn_cast<mlir_ts::ReturnValOp>(calleeOp))
+            {
+                result = mapper.lookupOrDefault(returnValOp.operand());
+                continue;
+            }
+
+            builder.clone(calleeOp, mapper);
+        }
+
+        if (op->getNumResults() > 0)
+        {
+            auto resultType = op->getResult(0).getType();
+            if (result.getType() != resultType)
+            {
+                result = builder.create<mlir_ts::CastOp>(loc, resultType, result);
+            }
+
+            op->getResult(0).replaceAllUsesWith(result);
+        }
+
+        op->erase();
+    }
+};
+} // end anonymous namespace
+
+/// Create a pass to inline small TypeScript functions.
+std::unique_ptr<mlir::Pass> mlir_ts::createInlinerPass()
+{
+    return std::make_unique<InlinerPass>();
+}
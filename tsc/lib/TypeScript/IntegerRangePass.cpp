@@ -0,0 +1,671 @@
+#define DEBUG_TYPE "pass"
+
+#include "mlir/Pass/Pass.h"
+
+#include "TypeScript/Config.h"
+#include "TypeScript/TypeScriptDialect.h"
+#include "TypeScript/TypeScriptOps.h"
+#include "TypeScript/TypeScriptFunctionPass.h"
+#include "TypeScript/Passes.h"
+
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/Support/Debug.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include "scanner_enums.h"
+
+#include <cmath>
+#include <functional>
+#include <limits>
+
+namespace mlir_ts = mlir::typescript;
+
+namespace
+{
+
+// Narrows local 'number' variables to integers when all values stored into them are proven to be integers in a small
+// range, for example loop counters or results of bitwise operators:
+//
+//    for (let i: number = 0; i < arr.length; i++) { ... arr[i] ... }
+//    let h: number = (h * 31 + c) | 0;
+//
+// Accepted stores are:
+//  - integral constants in the range of i32 (-0 is not allowed)
+//  - integers of 32 bits or less casted to 'number', for example result of x | 0, x & m, x ^ y, x << n, x >> n
+//  - i + c/i - c/++i/--i/i++/i-- in the 'incr' region of ForOp, when the 'cond' region compares i against a bound
+//    which is in the range of i32 in the direction of the step (i < bound for i++, i > bound for i--)
+//
+// Variable without updates is narrowed to i32 as all stored values are in its range. Between two runs of the same
+// 'incr' region the 'cond' is always checked, so the value of updated variable can't leave the range
+// [INT32_MIN - sum(steps), INT32_MAX + sum(steps)]; such variable is narrowed to i64 and it stays far below 2^53, which
+// means that the integer result is exactly the same as the result of f64 arithmetic. All other users of the variable
+// receive the value casted back to 'number', casts 'number' -> int (used by ElementRefOp and bitwise operators) are
+// folded into int -> int.
+//
+// Other arithmetic (x * y, x / y, i + j of two variables, x + 0.5) is not narrowed, such variables stay 'number'.
+class IntegerRangePass : public mlir::PassWrapper<IntegerRangePass, TypeScriptFunctionPass>
+{
+  public:
+    void runOnFunction() override
+    {
+        auto f = getFunction();
+
+        mlir::SmallVector<mlir_ts::VariableOp, 4> workList;
+        f.walk([&](mlir_ts::VariableOp variableOp) {
+            if (canBeNarrowed(variableOp))
+            {
+                workList.push_back(variableOp);
+            }
+        });
+
+        for (auto variableOp : workList)
+        {
+            LLVM_DEBUG(llvm::dbgs() << "\n!! narrowing to integer: " << variableOp << "\n";);
+
+            narrow(variableOp);
+        }
+
+        LLVM_DEBUG(llvm::dbgs() << "\n!! AFTER INTEGER RANGE FUNC DUMP: \n" << *getFunction() << "\n";);
+    }
+
+    bool canBeNarrowed(mlir_ts::VariableOp variableOp)
+    {
+        auto refType = variableOp.reference().getType().dyn_cast<mlir_ts::RefType>();
+        if (!refType || !refType.getElementType().isa<mlir_ts::NumberType>())
+        {
+            return false;
+        }
+
+        if (variableOp.captured().hasValue() && variableOp.captured().getValue())
+        {
+            return false;
+        }
+
+        int64_t value;
+        if (variableOp.initializer() && !getIntegralConstant(variableOp.initializer(), value))
+        {
+            return false;
+        }
+
+        // value of not initialized variable is 'undefined' which can't be stored in integer
+        if (!variableOp.initializer() && !isStoredBeforeUse(variableOp))
+        {
+            return false;
+        }
+
+        auto reference = variableOp.reference();
+        for (auto &use : reference.getUses())
+        {
+            auto *user = use.getOwner();
+            if (auto loadOp = dyn_cast<mlir_ts::LoadOp>(user))
+            {
+                for (auto *loadUser : loadOp.result().getUsers())
+                {
+                    if (isa<mlir_ts::PrefixUnaryOp>(loadUser) || isa<mlir_ts::PostfixUnaryOp>(loadUser))
+                    {
+                        // ++/-- stores the result back into the variable
+                        if (!isGuardedUpdate(loadUser, reference))
+                        {
+                            return false;
+                        }
+                    }
+                }
+
+                continue;
+            }
+
+            if (auto storeOp = dyn_cast<mlir_ts::StoreOp>(user))
+            {
+                if (storeOp.reference() != reference || storeOp.value() == reference)
+                {
+                    return false;
+                }
+
+                auto *valueOp = storeOp.value().getDefiningOp();
+                if (valueOp && isUpdateOf(valueOp, reference) && !isGuardedUpdate(valueOp, reference))
+                {
+                    return false;
+                }
+
+                if (valueOp && isUpdateOf(valueOp, reference) &&
+                    valueOp->getParentRegion() != storeOp->getParentRegion())
+                {
+                    return false;
+                }
+
+                if (!canNarrowStore(storeOp, reference))
+                {
+                    return false;
+                }
+
+                continue;
+            }
+
+            // address is taken, captured etc.
+            return false;
+        }
+
+        return true;
+    }
+
+    // first user of variable in its block is store and no load can be executed before it
+    bool isStoredBeforeUse(mlir_ts::VariableOp variableOp)
+    {
+        auto reference = variableOp.reference();
+        for (auto *op = variableOp->getNextNode(); op; op = op->getNextNode())
+        {
+            if (auto storeOp = dyn_cast<mlir_ts::StoreOp>(op))
+            {
+                if (storeOp.reference() == reference)
+                {
+                    return storeOp.value() != reference;
+                }
+            }
+
+            auto usesReference = false;
+            op->walk([&](mlir::Operation *nested) {
+                if (llvm::is_contained(nested->getOperands(), reference))
+                {
+                    usesReference = true;
+                }
+            });
+
+            if (usesReference)
+            {
+                return false;
+            }
+        }
+
+        return false;
+    }
+
+    // stored value is integral constant, integer casted to 'number' or update of variable which is narrowed together
+    // with its load
+    bool canNarrowStore(mlir_ts::StoreOp storeOp, mlir::Value reference)
+    {
+        auto *valueOp = storeOp.value().getDefiningOp();
+        if (valueOp && isUpdateOf(valueOp, reference))
+        {
+            return true;
+        }
+
+        if (getCastedInteger(storeOp.value()))
+        {
+            return true;
+        }
+
+        int64_t value;
+        return getIntegralConstant(storeOp.value(), value);
+    }
+
+    // i32 is enough when variable is not updated by ++/--/+= c in loop
+    mlir::Type getNarrowType(mlir::OpBuilder &builder, mlir::Value reference)
+    {
+        for (auto *user : reference.getUsers())
+        {
+            auto storeOp = dyn_cast<mlir_ts::StoreOp>(user);
+            auto *valueOp = storeOp ? storeOp.value().getDefiningOp() : nullptr;
+            if (valueOp && isUpdateOf(valueOp, reference))
+            {
+                return builder.getI64Type();
+            }
+        }
+
+        return builder.getI32Type();
+    }
+
+    // signed integer of 32 bits or less casted to 'number', its value is exact
+    mlir::Value getCastedInteger(mlir::Value value)
+    {
+        auto castOp = value.getDefiningOp<mlir_ts::CastOp>();
+        if (!castOp || !castOp.res().getType().isa<mlir_ts::NumberType>())
+        {
+            return mlir::Value();
+        }
+
+        auto intType = castOp.in().getType().dyn_cast<mlir::IntegerType>();
+        if (!intType || intType.isUnsigned() || intType.getWidth() <= 1 || intType.getWidth() > 32)
+        {
+            return mlir::Value();
+        }
+
+        // constants are narrowed by value
+        if (castOp.in().getDefiningOp<mlir_ts::ConstantOp>())
+        {
+            return mlir::Value();
+        }
+
+        return castOp.in();
+    }
+
+    // i + c, i - c, ++i, --i, i++, i--
+    bool isUpdateOf(mlir::Operation *op, mlir::Value reference, int64_t *step = nullptr)
+    {
+        auto isLoadOf = [&](mlir::Value value) {
+            auto loadOp = value.getDefiningOp<mlir_ts::LoadOp>();
+            return loadOp && loadOp.reference() == reference;
+        };
+
+        auto unaryStep = [&](SyntaxKind opCode) {
+            if (step)
+            {
+                *step = opCode == SyntaxKind::PlusPlusToken ? 1 : -1;
+            }
+
+            return true;
+        };
+
+        if (auto prefixOp = dyn_cast<mlir_ts::PrefixUnaryOp>(op))
+        {
+            return isLoadOf(prefixOp.operand1()) && unaryStep((SyntaxKind)prefixOp.opCode());
+        }
+
+        if (auto postfixOp = dyn_cast<mlir_ts::PostfixUnaryOp>(op))
+        {
+            return isLoadOf(postfixOp.operand1()) && unaryStep((SyntaxKind)postfixOp.opCode());
+        }
+
+        if (auto arithmeticBinaryOp = dyn_cast<mlir_ts::ArithmeticBinaryOp>(op))
+        {
+            auto opCode = (SyntaxKind)arithmeticBinaryOp.opCode();
+            if (opCode != SyntaxKind::PlusToken && opCode != SyntaxKind::MinusToken)
+            {
+                return false;
+            }
+
+            if (!arithmeticBinaryOp.getType().isa<mlir_ts::NumberType>() || !isLoadOf(arithmeticBinaryOp.operand1()))
+            {
+                return false;
+            }
+
+            int64_t value;
+            if (!getIntegralConstant(arithmeticBinaryOp.operand2(), value))
+            {
+                return false;
+            }
+
+            if (step)
+            {
+                *step = opCode == SyntaxKind::PlusToken ? value : -value;
+            }
+
+            return true;
+        }
+
+        return false;
+    }
+
+    bool isGuardedUpdate(mlir::Operation *op, mlir::Value reference)
+    {
+        int64_t step;
+        if (!isUpdateOf(op, reference, &step) || step == 0)
+        {
+            return false;
+        }
+
+        auto forOp = dyn_cast_or_null<mlir_ts::ForOp>(op->getParentOp());
+        if (!forOp || op->getParentRegion() != &forOp.incr())
+        {
+            return false;
+        }
+
+        // value must be loaded after 'cond' is checked
+        if (op->getOperand(0).getDefiningOp()->getParentRegion() != op->getParentRegion())
+        {
+            return false;
+        }
+
+        auto conditionOp = dyn_cast<mlir_ts::ConditionOp>(forOp.cond().front().getTerminator());
+        if (!conditionOp)
+        {
+            return false;
+        }
+
+        auto logicalBinaryOp = conditionOp.condition().getDefiningOp<mlir_ts::LogicalBinaryOp>();
+        if (!logicalBinaryOp)
+        {
+            return false;
+        }
+
+        bool isUpperBound;
+        if (!getBound(logicalBinaryOp, reference, isUpperBound))
+        {
+            return false;
+        }
+
+        return isUpperBound ? step > 0 : step < 0;
+    }
+
+    // i < bound, i <= bound, bound > i, bound >= i are upper bounds
+    bool getBound(mlir_ts::LogicalBinaryOp logicalBinaryOp, mlir::Value reference, bool &isUpperBound)
+    {
+        auto isLoadOf = [&](mlir::Value value) {
+            auto loadOp = value.getDefiningOp<mlir_ts::LoadOp>();
+            return loadOp && loadOp.reference() == reference;
+        };
+
+        auto opCode = (SyntaxKind)logicalBinaryOp.opCode();
+        auto isLess = opCode == SyntaxKind::LessThanToken || opCode == SyntaxKind::LessThanEqualsToken;
+        auto isGreater = opCode == SyntaxKind::GreaterThanToken || opCode == SyntaxKind::GreaterThanEqualsToken;
+        if (!isLess && !isGreater)
+        {
+            return false;
+        }
+
+        int64_t value;
+        if (isLoadOf(logicalBinaryOp.operand1()) && isIntegralBound(logicalBinaryOp.operand2(), value))
+        {
+            isUpperBound = isLess;
+            return true;
+        }
+
+        if (isLoadOf(logicalBinaryOp.operand2()) && isIntegralBound(logicalBinaryOp.operand1(), value))
+        {
+            isUpperBound = isGreater;
+            return true;
+        }
+
+        return false;
+    }
+
+    // value which is integer in range of i32
+    bool isIntegralBound(mlir::Value value, int64_t &constValue)
+    {
+        if (getIntegralConstant(value, constValue))
+        {
+            return true;
+        }
+
+        return getLengthValue(value) != mlir::Value();
+    }
+
+    // length of array or string casted to 'number', it is never negative
+    mlir::Value getLengthValue(mlir::Value value)
+    {
+        if (auto castOp = value.getDefiningOp<mlir_ts::CastOp>())
+        {
+            auto in = castOp.in();
+            if (in.getDefiningOp<mlir_ts::LengthOfOp>() || in.getDefiningOp<mlir_ts::StringLengthOp>())
+            {
+                return in;
+            }
+        }
+
+        return mlir::Value();
+    }
+
+    bool getIntegralConstant(mlir::Value value, int64_t &constValue)
+    {
+        if (auto castOp = value.getDefiningOp<mlir_ts::CastOp>())
+        {
+            value = castOp.in();
+        }
+
+        auto constantOp = value.getDefiningOp<mlir_ts::ConstantOp>();
+        if (!constantOp)
+        {
+            return false;
+        }
+
+        auto attr = constantOp.getValue();
+        if (auto intAttr = attr.dyn_cast_or_null<mlir::IntegerAttr>())
+        {
+            auto intType = intAttr.getType().dyn_cast<mlir::IntegerType>();
+            if (!intType || intType.isUnsigned() || intType.getWidth() <= 1 || intType.getWidth() > 64)
+            {
+                return false;
+            }
+
+            constValue = intAttr.getValue().getSExtValue();
+        }
+        else if (auto floatAttr = attr.dyn_cast_or_null<mlir::FloatAttr>())
+        {
+            auto doubleValue = floatAttr.getValueAsDouble();
+            if (std::isnan(doubleValue) || std::isinf(doubleValue) || std::trunc(doubleValue) != doubleValue ||
+                (doubleValue == 0 && std::signbit(doubleValue)))
+            {
+                return false;
+            }
+
+            if (doubleValue < std::numeric_limits<int32_t>::min() || doubleValue > std::numeric_limits<int32_t>::max())
+            {
+                return false;
+            }
+
+            constValue = static_cast<int64_t>(doubleValue);
+        }
+        else
+        {
+            return false;
+        }
+
+        return constValue >= std::numeric_limits<int32_t>::min() && constValue <= std::numeric_limits<int32_t>::max();
+    }
+
+    void narrow(mlir_ts::VariableOp variableOp)
+    {
+        mlir::OpBuilder builder(variableOp);
+        auto reference = variableOp.reference();
+
+        // nothing is changed yet, leave variable as 'number' if any store can't be narrowed
+        for (auto *user : reference.getUsers())
+        {
+            auto storeOp = dyn_cast<mlir_ts::StoreOp>(user);
+            if (storeOp && !canNarrowStore(storeOp, reference))
+            {
+                LLVM_DEBUG(llvm::dbgs() << "\n!! store can't be narrowed: " << storeOp << "\n";);
+                return;
+            }
+        }
+
+        auto intType = getNarrowType(builder, reference);
+
+        int64_t value;
+        if (variableOp.initializer() && getIntegralConstant(variableOp.initializer(), value))
+        {
+            variableOp->setOperand(0, createConstant(builder, variableOp->getLoc(), intType, value));
+        }
+
+        reference.setType(mlir_ts::RefType::get(intType));
+
+        mlir::SmallVector<mlir::Operation *, 8> users(reference.getUsers().begin(), reference.getUsers().end());
+        for (auto *user : users)
+        {
+            if (auto loadOp = dyn_cast<mlir_ts::LoadOp>(user))
+            {
+                narrowLoad(loadOp, reference, intType);
+            }
+        }
+
+        for (auto *user : users)
+        {
+            if (auto storeOp = dyn_cast<mlir_ts::StoreOp>(user))
+            {
+                narrowStore(storeOp, intType);
+            }
+        }
+    }
+
+    void narrowLoad(mlir_ts::LoadOp loadOp, mlir::Value reference, mlir::Type intType)
+    {
+        mlir::OpBuilder builder(loadOp);
+        auto loadValue = loadOp.result();
+        loadValue.setType(intType);
+
+        mlir::SmallVector<mlir::Operation *, 2> updates;
+        mlir::SmallVector<mlir_ts::LogicalBinaryOp, 2> compares;
+        for (auto *user : loadValue.getUsers())
+        {
+            if (isUpdateOf(user, reference))
+            {
+                updates.push_back(user);
+            }
+            else if (auto logicalBinaryOp = dyn_cast<mlir_ts::LogicalBinaryOp>(user))
+            {
+                compares.push_back(logicalBinaryOp);
+            }
+        }
+
+        builder.setInsertionPointAfter(loadOp);
+        auto numberValue = castToNumber(builder, loadOp->getLoc(), loadValue, [&](mlir::Operation *op) {
+            return llvm::is_contained(updates, op);
+        });
+
+        for (auto *update : updates)
+        {
+            narrowUpdate(update, reference, intType);
+        }
+
+        for (auto logicalBinaryOp : compares)
+        {
+            narrowCompare(logicalBinaryOp, numberValue, loadValue);
+        }
+
+        // fold number -> int casts, for example index of ElementRefOp
+        for (auto *user : llvm::make_early_inc_range(numberValue.getUsers()))
+        {
+            if (auto castOp = dyn_cast<mlir_ts::CastOp>(user))
+            {
+                auto resType = castOp.res().getType();
+                if (resType == intType)
+                {
+                    castOp.res().replaceAllUsesWith(loadValue);
+                    castOp->erase();
+                }
+                else if (resType.isa<mlir::IntegerType>() && resType.getIntOrFloatBitWidth() > 1)
+                {
+                    mlir::OpBuilder castBuilder(castOp);
+                    auto newCastOp = castBuilder.create<mlir_ts::CastOp>(castOp->getLoc(), resType, loadValue);
+                    castOp.res().replaceAllUsesWith(newCastOp.res());
+                    castOp->erase();
+                }
+            }
+        }
+
+        if (numberValue.use_empty())
+        {
+            numberValue.getDefiningOp()->erase();
+        }
+    }
+
+    void narrowUpdate(mlir::Operation *update, mlir::Value reference, mlir::Type intType)
+    {
+        mlir::OpBuilder builder(update);
+
+        if (auto arithmeticBinaryOp = dyn_cast<mlir_ts::ArithmeticBinaryOp>(update))
+        {
+            int64_t value;
+            getIntegralConstant(arithmeticBinaryOp.operand2(), value);
+            arithmeticBinaryOp->setOperand(1, createConstant(builder, update->getLoc(), intType, value));
+        }
+
+        auto result = update->getResult(0);
+        result.setType(intType);
+
+        builder.setInsertionPointAfter(update);
+        castToNumber(builder, update->getLoc(), result, [&](mlir::Operation *op) {
+            auto storeOp = dyn_cast<mlir_ts::StoreOp>(op);
+            return storeOp && storeOp.reference() == reference;
+        });
+    }
+
+    void narrowStore(mlir_ts::StoreOp storeOp, mlir::Type intType)
+    {
+        if (storeOp.value().getType().isa<mlir::IntegerType>())
+        {
+            // already narrowed update
+            return;
+        }
+
+        mlir::OpBuilder builder(storeOp);
+        if (auto intValue = getCastedInteger(storeOp.value()))
+        {
+            auto *numberCastOp = storeOp.value().getDefiningOp();
+            if (intValue.getType() != intType)
+            {
+                intValue = builder.create<mlir_ts::CastOp>(storeOp->getLoc(), intType, intValue);
+            }
+
+            storeOp->setOperand(0, intValue);
+            if (numberCastOp->use_empty())
+            {
+                numberCastOp->erase();
+            }
+
+            return;
+        }
+
+        // only integral constants are left, see canNarrowStore
+        int64_t value;
+        if (getIntegralConstant(storeOp.value(), value))
+        {
+            storeOp->setOperand(0, createConstant(builder, storeOp->getLoc(), intType, value));
+        }
+    }
+
+    // compare in integers when other side is integral as well
+    void narrowCompare(mlir_ts::LogicalBinaryOp logicalBinaryOp, mlir::Value numberValue, mlir::Value intValue)
+    {
+        auto operandIndex = logicalBinaryOp.operand1() == numberValue ? 1 : 0;
+        auto other = logicalBinaryOp->getOperand(operandIndex);
+
+        mlir::OpBuilder builder(logicalBinaryOp);
+        auto intType = intValue.getType();
+
+        mlir::Value otherInt;
+        int64_t value;
+        if (getIntegralConstant(other, value))
+        {
+            otherInt = createConstant(builder, logicalBinaryOp->getLoc(), intType, value);
+        }
+        else if (auto lengthValue = getLengthValue(other))
+        {
+            otherInt = builder.create<mlir_ts::CastOp>(logicalBinaryOp->getLoc(), intType, lengthValue);
+        }
+        else if (auto castedValue = getCastedInteger(other))
+        {
+            otherInt = castedValue.getType() == intType
+                           ? castedValue
+                           : builder.create<mlir_ts::CastOp>(logicalBinaryOp->getLoc(), intType, castedValue).res();
+        }
+        else
+        {
+            return;
+        }
+
+        logicalBinaryOp->setOperand(operandIndex, otherInt);
+        logicalBinaryOp->setOperand(1 - operandIndex, intValue);
+    }
+
+    mlir::Value createConstant(mlir::OpBuilder &builder, mlir::Location location, mlir::Type intType, int64_t value)
+    {
+        return builder.create<mlir_ts::ConstantOp>(location, intType, builder.getIntegerAttr(intType, value));
+    }
+
+    // all users except filtered receive 'number' value
+    mlir::Value castToNumber(mlir::OpBuilder &builder, mlir::Location location, mlir::Value intValue,
+                             std::function<bool(mlir::Operation *)> skip)
+    {
+        auto castOp = builder.create<mlir_ts::CastOp>(location, mlir_ts::NumberType::get(builder.getContext()), intValue);
+        for (auto &use : llvm::make_early_inc_range(intValue.getUses()))
+        {
+            auto *owner = use.getOwner();
+            if (owner == castOp || skip(owner))
+            {
+                continue;
+            }
+
+            use.set(castOp.res());
+        }
+
+        return castOp.res();
+    }
+};
+} // end anonymous namespace
+
+/// Create pass.
+std::unique_ptr<mlir::Pass> mlir_ts::createIntegerRangePass()
+{
+    return std::make_unique<IntegerRangePass>();
+}
@@ -1,6 +1,7 @@
 #define DEBUG_TYPE "affine"
 
 #include "TypeScript/Config.h"
+#include "TypeScript/Defines.h"
 #include "TypeScript/DataStructs.h"
 #include "TypeScript/Passes.h"
 #include "TypeScript/TypeScriptDialect.h"
@@ -21,6 +22,8 @@
 #include "mlir/Dialect/SCF/SCF.h"
 #include "mlir/Dialect/StandardOps/IR/Ops.h"
 #include "mlir/Dialect/Async/IR/Async.h"
+#include "mlir/IR/BlockAndValueMapping.h"
+#include "mlir/Interfaces/CallInterfaces.h"
 #include "mlir/Pass/Pass.h"
 #include "mlir/Transforms/DialectConversion.h"
 #include "llvm/ADT/STLExtras.h"
@@ -554,6 +557,17 @@ struct DoWhileOpLowering : public TsPattern<mlir_ts::DoWhileOp>
     }
 };
 
+// for (...; i < bound; i += step) where 'i' is integer local variable (see IntegerRangePass) which is changed only
+// in 'incr' region and 'bound' is not changed by loop
+struct CountedLoop
+{
+    mlir::Value reference;
+    mlir::Value counter;
+    mlir::Value bound;
+    bool inclusive;
+    int64_t step;
+};
+
 struct ForOpLowering : public TsPattern<mlir_ts::ForOp>
 {
     using TsPattern<mlir_ts::ForOp>::TsPattern;
@@ -563,6 +577,16 @@ struct ForOpLowering : public TsPattern<mlir_ts::ForOp>
         OpBuilder::InsertionGuard guard(rewriter);
         Location loc = forOp.getLoc();
 
+        // counted loop is lowered into scf.for to be visible for loop optimizations, otherwise into branches
+        CountedLoop countedLoop;
+        if (matchCountedLoop(forOp, countedLoop))
+        {
+            LLVM_DEBUG(llvm::dbgs() << "\n!! counted loop: " << forOp << "\n";);
+
+            lowerCountedLoop(forOp, countedLoop, rewriter);
+            return success();
+        }
+
         auto labelAttr = forOp->getAttrOfType<StringAttr>(LABEL_ATTR_NAME);
 
         // Split the current block before the WhileOp to create the inlining point.
@@ -639,6 +663,398 @@ struct ForOpLowering : public TsPattern<mlir_ts::ForOp>
 
         return success();
     }
+
+  private:
+    bool matchCountedLoop(mlir_ts::ForOp forOp, CountedLoop &countedLoop) const
+    {
+        if (!forOp.inits().empty() || forOp.getNumResults() > 0 || !llvm::hasSingleElement(forOp.body()))
+        {
+            return false;
+        }
+
+        auto conditionOp = dyn_cast<mlir_ts::ConditionOp>(forOp.cond().front().getTerminator());
+        if (!conditionOp || !conditionOp.args().empty())
+        {
+            return false;
+        }
+
+        auto logicalBinaryOp = conditionOp.condition().getDefiningOp<mlir_ts::LogicalBinaryOp>();
+        if (!logicalBinaryOp || !logicalBinaryOp->hasOneUse())
+        {
+            return false;
+        }
+
+        // i < bound, i <= bound, bound > i, bound >= i
+        switch ((SyntaxKind)logicalBinaryOp.opCode())
+        {
+        case SyntaxKind::LessThanToken:
+        case SyntaxKind::LessThanEqualsToken:
+            countedLoop.counter = logicalBinaryOp.operand1();
+            countedLoop.bound = logicalBinaryOp.operand2();
+            break;
+        case SyntaxKind::GreaterThanToken:
+        case SyntaxKind::GreaterThanEqualsToken:
+            countedLoop.counter = logicalBinaryOp.operand2();
+            countedLoop.bound = logicalBinaryOp.operand1();
+            break;
+        default:
+            return false;
+        }
+
+        countedLoop.inclusive = (SyntaxKind)logicalBinaryOp.opCode() == SyntaxKind::LessThanEqualsToken ||
+                                (SyntaxKind)logicalBinaryOp.opCode() == SyntaxKind::GreaterThanEqualsToken;
+
+        // upper bound of inclusive loop is 'bound + 1', it must not overflow
+        if (countedLoop.inclusive && !isLessThanMaxInt64(countedLoop.bound))
+        {
+            return false;
+        }
+
+        auto counterLoadOp = countedLoop.counter.getDefiningOp<mlir_ts::LoadOp>();
+        if (!counterLoadOp || !countedLoop.counter.getType().isInteger(64) ||
+            countedLoop.bound.getType() != countedLoop.counter.getType())
+        {
+            return false;
+        }
+
+        countedLoop.reference = counterLoadOp.reference();
+        if (!isLocalVariable(countedLoop.reference) || !getStep(forOp, countedLoop.reference, countedLoop.step))
+        {
+            return false;
+        }
+
+        // counter is changed only by 'incr'
+        for (auto *user : countedLoop.reference.getUsers())
+        {
+            if (!forOp->isAncestor(user) || user->getParentRegion() == &forOp.incr())
+            {
+                continue;
+            }
+
+            auto loadOp = dyn_cast<mlir_ts::LoadOp>(user);
+            if (!loadOp || llvm::any_of(loadOp.result().getUsers(), [](Operation *op) {
+                    return isa<mlir_ts::PrefixUnaryOp>(op) || isa<mlir_ts::PostfixUnaryOp>(op);
+                }))
+            {
+                return false;
+            }
+        }
+
+        // 'cond' is computed once before loop
+        for (auto &op : forOp.cond().front())
+        {
+            if (auto loadOp = dyn_cast<mlir_ts::LoadOp>(op))
+            {
+                if (loadOp.reference() != countedLoop.reference && !isUnchangedVariable(loadOp.reference(), forOp))
+                {
+                    return false;
+                }
+
+                continue;
+            }
+
+            // length of array is changed by push/pop in body or by any call
+            if (auto lengthOfOp = dyn_cast<mlir_ts::LengthOfOp>(op))
+            {
+                if (mayChangeLength(forOp.body(), lengthOfOp.op().getType()))
+                {
+                    return false;
+                }
+
+                continue;
+            }
+
+            if (!isa<mlir_ts::ConstantOp>(op) && !isa<mlir_ts::CastOp>(op) &&
+                !isa<mlir_ts::StringLengthOp>(op) && &op != logicalBinaryOp.getOperation() &&
+                &op != conditionOp.getOperation())
+            {
+                return false;
+            }
+        }
+
+        return canBeStructured(forOp.body());
+    }
+
+    // i++, ++i, i = i + c, i += c
+    bool getStep(mlir_ts::ForOp forOp, mlir::Value reference, int64_t &step) const
+    {
+        auto isLoadOf = [&](mlir::Value value) {
+            auto loadOp = value.getDefiningOp<mlir_ts::LoadOp>();
+            return loadOp && loadOp.reference() == reference;
+        };
+
+        auto updates = 0;
+        for (auto &op : forOp.incr().front())
+        {
+            if (isa<mlir_ts::LoadOp>(op) || isa<mlir_ts::ConstantOp>(op) || isa<mlir_ts::CastOp>(op) ||
+                isa<mlir_ts::ArithmeticBinaryOp>(op) || isa<mlir_ts::ResultOp>(op))
+            {
+                continue;
+            }
+
+            // ++ stores result into loaded variable
+            if (auto prefixUnaryOp = dyn_cast<mlir_ts::PrefixUnaryOp>(op))
+            {
+                if ((SyntaxKind)prefixUnaryOp.opCode() != SyntaxKind::PlusPlusToken ||
+                    !isLoadOf(prefixUnaryOp.operand1()))
+                {
+                    return false;
+                }
+
+                step = 1;
+                updates++;
+                continue;
+            }
+
+            if (auto postfixUnaryOp = dyn_cast<mlir_ts::PostfixUnaryOp>(op))
+            {
+                if ((SyntaxKind)postfixUnaryOp.opCode() != SyntaxKind::PlusPlusToken ||
+                    !isLoadOf(postfixUnaryOp.operand1()))
+                {
+                    return false;
+                }
+
+                step = 1;
+                updates++;
+                continue;
+            }
+
+            auto storeOp = dyn_cast<mlir_ts::StoreOp>(op);
+            if (!storeOp || storeOp.reference() != reference)
+            {
+                return false;
+            }
+
+            auto arithmeticBinaryOp = storeOp.value().getDefiningOp<mlir_ts::ArithmeticBinaryOp>();
+            if (!arithmeticBinaryOp || (SyntaxKind)arithmeticBinaryOp.opCode() != SyntaxKind::PlusToken ||
+                !isLoadOf(arithmeticBinaryOp.operand1()))
+            {
+                return false;
+            }
+
+            auto constantOp = arithmeticBinaryOp.operand2().getDefiningOp<mlir_ts::ConstantOp>();
+            auto stepAttr = constantOp ? constantOp.getValue().dyn_cast_or_null<IntegerAttr>() : IntegerAttr();
+            if (!stepAttr)
+            {
+                return false;
+            }
+
+            step = stepAttr.getValue().getSExtValue();
+            updates++;
+        }
+
+        return updates == 1 && step > 0;
+    }
+
+    bool isLocalVariable(mlir::Value reference) const
+    {
+        if (auto variableOp = reference.getDefiningOp<mlir_ts::VariableOp>())
+        {
+            return !variableOp.captured().hasValue() || !variableOp.captured().getValue();
+        }
+
+        // parameter which is not lowered yet
+        if (auto paramOp = reference.getDefiningOp<mlir_ts::ParamOp>())
+        {
+            return !paramOp.captured().hasValue() || !paramOp.captured().getValue();
+        }
+
+        return false;
+    }
+
+    // variable is only loaded in loop and its reference is not sent anywhere
+    bool isUnchangedVariable(mlir::Value reference, mlir_ts::ForOp forOp) const
+    {
+        if (!isLocalVariable(reference))
+        {
+            return false;
+        }
+
+        for (auto *user : reference.getUsers())
+        {
+            if (isa<mlir_ts::LoadOp>(user))
+            {
+                continue;
+            }
+
+            if (forOp->isAncestor(user))
+            {
+                return false;
+            }
+
+            auto storeOp = dyn_cast<mlir_ts::StoreOp>(user);
+            if ((storeOp && storeOp.reference() == reference) || isa<mlir_ts::PushOp>(user) ||
+                isa<mlir_ts::PopOp>(user) || isa<mlir_ts::ReserveOp>(user))
+            {
+                continue;
+            }
+
+            return false;
+        }
+
+        return true;
+    }
+
+    // value is constant less than INT64_MAX or length of array or string
+    bool isLessThanMaxInt64(mlir::Value value) const
+    {
+        while (auto castOp = value.getDefiningOp<mlir_ts::CastOp>())
+        {
+            value = castOp.in();
+        }
+
+        if (value.getDefiningOp<mlir_ts::LengthOfOp>() || value.getDefiningOp<mlir_ts::StringLengthOp>())
+        {
+            return true;
+        }
+
+        if (auto constantOp = value.getDefiningOp<mlir_ts::ConstantOp>())
+        {
+            if (auto intAttr = constantOp.getValue().dyn_cast_or_null<IntegerAttr>())
+            {
+                return intAttr.getValue().slt(APInt::getSignedMaxValue(intAttr.getValue().getBitWidth()));
+            }
+        }
+
+        return false;
+    }
+
+    // array of type 'arrayLikeType' can be resized in region: by push/pop/reserve of any array of the same type (it can
+    // be alias of the bound array) or by any call (getters and setters are calls too)
+    bool mayChangeLength(mlir::Region &region, mlir::Type arrayLikeType) const
+    {
+        if (!arrayLikeType.isa<mlir_ts::ArrayType>())
+        {
+            return false;
+        }
+
+        auto isSameArray = [&](mlir::Value arrayRef) {
+            return arrayRef.getType().cast<mlir_ts::RefType>().getElementType() == arrayLikeType;
+        };
+
+        auto result = region.walk([&](mlir::Operation *op) {
+            if (isa<mlir::CallOpInterface>(op) || isa<mlir_ts::AccessorOp>(op) || isa<mlir_ts::ThisAccessorOp>(op))
+            {
+                return WalkResult::interrupt();
+            }
+
+            if (auto pushOp = dyn_cast<mlir_ts::PushOp>(op))
+            {
+                return isSameArray(pushOp.op()) ? WalkResult::interrupt() : WalkResult::advance();
+            }
+
+            if (auto popOp = dyn_cast<mlir_ts::PopOp>(op))
+            {
+                return isSameArray(popOp.op()) ? WalkResult::interrupt() : WalkResult::advance();
+            }
+
+            if (auto reserveOp = dyn_cast<mlir_ts::ReserveOp>(op))
+            {
+                return isSameArray(reserveOp.op()) ? WalkResult::interrupt() : WalkResult::advance();
+            }
+
+            return WalkResult::advance();
+        });
+
+        return result.wasInterrupted();
+    }
+
+    // body stays in one block after lowering of all its operations
+    bool canBeStructured(mlir::Region &region) const
+    {
+        for (auto &op : region.front())
+        {
+            if (auto innerForOp = dyn_cast<mlir_ts::ForOp>(op))
+            {
+                CountedLoop innerCountedLoop;
+                if (!matchCountedLoop(innerForOp, innerCountedLoop))
+                {
+                    return false;
+                }
+
+                continue;
+            }
+
+            if (op.getNumRegions() > 0 || isa<mlir_ts::BreakOp>(op) || isa<mlir_ts::ContinueOp>(op) ||
+                isa<mlir_ts::ReturnOp>(op) || isa<mlir_ts::ReturnValOp>(op) || isa<mlir_ts::ThrowOp>(op) ||
+                isa<mlir_ts::YieldReturnValOp>(op) || isa<mlir_ts::StateLabelOp>(op) ||
+                isa<mlir_ts::SwitchStateOp>(op) || isa<mlir_ts::CoroutineSuspendOp>(op))
+            {
+                return false;
+            }
+
+            // call in 'try' is lowered into invoke which splits block
+            if ((isa<mlir_ts::CallOp>(op) || isa<mlir_ts::CallIndirectOp>(op)) && tsContext->unwind.lookup(&op))
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    void lowerCountedLoop(mlir_ts::ForOp forOp, CountedLoop &countedLoop, PatternRewriter &rewriter) const
+    {
+        auto loc = forOp.getLoc();
+        auto counterType = countedLoop.counter.getType();
+
+        rewriter.setInsertionPoint(forOp);
+
+        // bounds
+        BlockAndValueMapping mapping;
+        for (auto &op : forOp.cond().front().without_terminator())
+        {
+            if (!isa<mlir_ts::LogicalBinaryOp>(op))
+            {
+                rewriter.clone(op, mapping);
+            }
+        }
+
+        mlir::Value lowerBound = mapping.lookup(countedLoop.counter);
+        mlir::Value upperBound = mapping.lookupOrDefault(countedLoop.bound);
+        if (countedLoop.inclusive)
+        {
+            upperBound = rewriter.create<AddIOp>(loc, upperBound, rewriter.create<ConstantIntOp>(loc, 1, 64));
+        }
+
+        auto lowerIndex = rewriter.create<IndexCastOp>(loc, lowerBound, rewriter.getIndexType());
+        auto upperIndex = rewriter.create<IndexCastOp>(loc, upperBound, rewriter.getIndexType());
+        auto stepIndex = rewriter.create<ConstantIndexOp>(loc, countedLoop.step);
+        auto scfForOp = rewriter.create<scf::ForOp>(loc, lowerIndex, upperIndex, stepIndex);
+
+        // counter in body is induction variable
+        rewriter.setInsertionPointToStart(scfForOp.getBody());
+        mlir::Value inductionVar = rewriter.create<IndexCastOp>(loc, scfForOp.getInductionVar(), counterType);
+
+        SmallVector<Operation *> users(countedLoop.reference.getUsers().begin(), countedLoop.reference.getUsers().end());
+        for (auto *user : users)
+        {
+            if (forOp.body().isAncestor(user->getParentRegion()))
+            {
+                rewriter.replaceOp(user, inductionVar);
+            }
+        }
+
+        auto *body = &forOp.body().front();
+        auto *resultOp = body->getTerminator();
+        rewriter.mergeBlockBefore(body, scfForOp.getBody()->getTerminator());
+        rewriter.eraseOp(resultOp);
+
+        // value of counter after loop: lowerBound + ceil(max(upperBound - lowerBound, 0) / step) * step
+        rewriter.setInsertionPointAfter(scfForOp);
+        auto zero = rewriter.create<ConstantIntOp>(loc, 0, 64);
+        auto step = rewriter.create<ConstantIntOp>(loc, countedLoop.step, 64);
+        mlir::Value distance = rewriter.create<SubIOp>(loc, upperBound, lowerBound);
+        auto isPositive = rewriter.create<CmpIOp>(loc, CmpIPredicate::sgt, distance, zero);
+        distance = rewriter.create<SelectOp>(loc, isPositive, distance, zero);
+        auto roundUp =
+            rewriter.create<AddIOp>(loc, distance, rewriter.create<ConstantIntOp>(loc, countedLoop.step - 1, 64));
+        auto trips = rewriter.create<SignedDivIOp>(loc, roundUp, step);
+        auto last = rewriter.create<AddIOp>(loc, lowerBound, rewriter.create<MulIOp>(loc, trips, step));
+        rewriter.create<mlir_ts::StoreOp>(loc, last, countedLoop.reference);
+
+        rewriter.eraseOp(forOp);
+    }
 };
 
 struct LabelOpLowering : public TsPattern<mlir_ts::LabelOp>
@@ -1219,7 +1635,9 @@ struct CallOpLowering : public TsPattern<mlir_ts::CallOp>
 
     LogicalResult matchAndRewrite(mlir_ts::CallOp op, PatternRewriter &rewriter) const final
     {
-        if (auto unwind = tsContext->unwind[op])
+        // callee can not throw, landing pad is not needed
+        auto unwind = op->hasAttr(NOUNWIND_ATTR_NAME) ? nullptr : tsContext->unwind[op];
+        if (unwind)
         {
             {
                 OpBuilder::InsertionGuard guard(rewriter);
@@ -1254,7 +1672,8 @@ struct CallIndirectOpLowering : public TsPattern<mlir_ts::CallIndirectOp>
 
     LogicalResult matchAndRewrite(mlir_ts::CallIndirectOp op, PatternRewriter &rewriter) const final
     {
-        if (auto unwind = tsContext->unwind[op])
+        auto unwind = op->hasAttr(NOUNWIND_ATTR_NAME) ? nullptr : tsContext->unwind[op];
+        if (unwind)
         {
             {
                 OpBuilder::InsertionGuard guard(rewriter);
@@ -1451,7 +1870,8 @@ struct CaptureOpLowering : public TsPattern<mlir_ts::CaptureOp>
 
         // true => we need to allocate capture in heap memory
 #ifdef ALLOC_CAPTURE_IN_HEAP
-        auto inHeapMemory = true;
+        // capture which does not outlive function (see EscapeAnalysisPass) stays in stack
+        auto inHeapMemory = !captureOp->hasAttr(STACK_ALLOC_ATTR_NAME);
 #else
         auto inHeapMemory = false;
 #endif
@@ -1487,9 +1907,6 @@ struct CaptureOpLowering : public TsPattern<mlir_ts::CaptureOp>
             index++;
         }
 
-        // mlir::Value newFunc = rewriter.create<mlir_ts::TrampolineOp>(location, captureOp.getType(),
-        // captureOp.callee(), allocTempStorage); rewriter.replaceOp(captureOp, newFunc);
-
         rewriter.replaceOp(captureOp, allocTempStorage);
 
         return success();
@@ -1513,6 +1930,7 @@ struct TypeScriptToAffineLoweringTSFuncPass : public PassWrapper<TypeScriptToAff
     void getDependentDialects(DialectRegistry &registry) const override
     {
         registry.insert<StandardOpsDialect>();
+        registry.insert<scf::SCFDialect>();
     }
 
     void runOnFunction() final;
@@ -1528,6 +1946,7 @@ struct TypeScriptToAffineLoweringFuncPass : public PassWrapper<TypeScriptToAffin
     void getDependentDialects(DialectRegistry &registry) const override
     {
         registry.insert<StandardOpsDialect>();
+        registry.insert<scf::SCFDialect>();
     }
 
     void runOnFunction() final;
@@ -1543,6 +1962,7 @@ struct TypeScriptToAffineLoweringModulePass : public PassWrapper<TypeScriptToAff
     void getDependentDialects(DialectRegistry &registry) const override
     {
         registry.insert<StandardOpsDialect>();
+        registry.insert<scf::SCFDialect>();
     }
 
     void runOnOperation() final;
@@ -1649,6 +2069,8 @@ void AddTsAffineLegalOps(ConversionTarget &target)
     // this lowering. In our case, we are lowering to a combination of the
     // `Affine` and `Standard` dialects.
     target.addLegalDialect<StandardOpsDialect>();
+    // counted loops
+    target.addLegalDialect<scf::SCFDialect>();
 
     // We also define the TypeScript dialect as Illegal so that the conversion will fail
     // if any of these operations are *not* converted. Given that we actually want
@@ -1661,21 +2083,24 @@ void AddTsAffineLegalOps(ConversionTarget &target)
         mlir_ts::PointerOffsetRefOp, mlir_ts::FuncOp, mlir_ts::GlobalOp, mlir_ts::GlobalResultOp, mlir_ts::HasValueOp,
         mlir_ts::ValueOp, mlir_ts::NullOp, mlir_ts::ParseFloatOp, mlir_ts::ParseIntOp, mlir_ts::IsNaNOp,
         mlir_ts::PrintOp, mlir_ts::SizeOfOp, mlir_ts::StoreOp, mlir_ts::SymbolRefOp, mlir_ts::LengthOfOp,
-        mlir_ts::StringLengthOp, mlir_ts::StringConcatOp, mlir_ts::StringCompareOp, mlir_ts::LoadOp, mlir_ts::NewOp,
+        mlir_ts::StringLengthOp, mlir_ts::StringConcatOp, mlir_ts::StringAppendOp, mlir_ts::StringCompareOp,
+        mlir_ts::StringHashOp, mlir_ts::LoadOp, mlir_ts::NewOp,
         mlir_ts::CreateTupleOp, mlir_ts::DeconstructTupleOp, mlir_ts::CreateArrayOp, mlir_ts::NewEmptyArrayOp,
         mlir_ts::NewArrayOp, mlir_ts::DeleteOp, mlir_ts::PropertyRefOp, mlir_ts::InsertPropertyOp,
         mlir_ts::ExtractPropertyOp, mlir_ts::LogicalBinaryOp, mlir_ts::UndefOp, mlir_ts::VariableOp, mlir_ts::AllocaOp,
-        mlir_ts::TrampolineOp, mlir_ts::InvokeOp, /*mlir_ts::ResultOp,*/ mlir_ts::VirtualSymbolRefOp,
+        mlir_ts::InvokeOp, /*mlir_ts::ResultOp,*/ mlir_ts::VirtualSymbolRefOp,
         mlir_ts::ThisVirtualSymbolRefOp, mlir_ts::InterfaceSymbolRefOp, mlir_ts::ExtractInterfaceThisOp,
-        mlir_ts::ExtractInterfaceVTableOp, mlir_ts::PushOp, mlir_ts::PopOp, mlir_ts::NewInterfaceOp,
+        mlir_ts::ExtractInterfaceVTableOp, mlir_ts::PushOp, mlir_ts::PopOp, mlir_ts::ReserveOp, mlir_ts::NewInterfaceOp,
         mlir_ts::VTableOffsetRefOp, mlir_ts::GetThisOp, mlir_ts::GetMethodOp, mlir_ts::DebuggerOp,
         mlir_ts::LandingPadOp, mlir_ts::CompareCatchTypeOp, mlir_ts::BeginCatchOp, mlir_ts::SaveCatchVarOp,
         mlir_ts::EndCatchOp, mlir_ts::BeginCleanupOp, mlir_ts::EndCleanupOp, mlir_ts::ThrowUnwindOp,
         mlir_ts::ThrowCallOp, mlir_ts::SymbolCallInternalOp, mlir_ts::CallInternalOp, mlir_ts::ReturnInternalOp,
-        mlir_ts::NoOp, mlir_ts::SwitchStateInternalOp, mlir_ts::UnreachableOp, mlir_ts::GlobalConstructorOp,
+        mlir_ts::NoOp, mlir_ts::SwitchStateInternalOp, mlir_ts::SwitchInternalOp, mlir_ts::UnreachableOp,
+        mlir_ts::GlobalConstructorOp,
         mlir_ts::CreateBoundFunctionOp, mlir_ts::TypeOfAnyOp, mlir_ts::BoxOp, mlir_ts::UnboxOp,
         mlir_ts::CreateUnionInstanceOp, mlir_ts::GetValueFromUnionOp, mlir_ts::GetTypeInfoFromUnionOp,
-        mlir_ts::CreateOptionalOp, mlir_ts::UndefOptionalOp>();
+        mlir_ts::CreateOptionalOp, mlir_ts::UndefOptionalOp, mlir_ts::CoroutineBeginOp, mlir_ts::CoroutineSuspendOp,
+        mlir_ts::CoroutineResumeOp, mlir_ts::CoroutineDoneOp, mlir_ts::CoroutinePromiseOp>();
 #ifdef ENABLE_TYPED_GC
     target.addLegalOp<
         mlir_ts::GCMakeDescriptorOp, GCNewExplicitlyTypedOp>();
@@ -28,6 +28,7 @@
 #include "mlir/Transforms/DialectConversion.h"
 #include "llvm/ADT/ScopedHashTable.h"
 #include "llvm/ADT/Sequence.h"
+#include "llvm/ADT/StringSet.h"
 #include "llvm/ADT/TypeSwitch.h"
 #include "llvm/Support/Debug.h"
 
@@ -51,6 +52,9 @@ namespace
 struct TsLlvmContext
 {
     TsLlvmContext() = default;
+
+    // declared functions without body, strings returned by them do not have header
+    llvm::StringSet<> externalFunctions;
 };
 
 template <typename OpTy> class TsLlvmPattern : public OpConversionPattern<OpTy>
@@ -66,6 +70,12 @@ template <typename OpTy> class TsLlvmPattern : public OpConversionPattern<OpTy>
     }
 
   protected:
+    bool isExternalStringResult(StringRef callee, TypeRange resultTypes) const
+    {
+        return resultTypes.size() == 1 && resultTypes.front().isa<mlir_ts::StringType>() &&
+               tsLlvmContext->externalFunctions.contains(callee);
+    }
+
     TsLlvmContext *tsLlvmContext;
 };
 
@@ -230,50 +240,62 @@ class PrintOpLowering : public TsLlvmPattern<mlir_ts::PrintOp>
         LLVMCodeHelper ch(op, rewriter, getTypeConverter());
         TypeConverterHelper tch(getTypeConverter());
 
-        CastLogicHelper castLogic(op, rewriter, tch);
+        StringLogicHelper slh(op, rewriter, tch);
 
         auto loc = op->getLoc();
 
+        ConvertLogic cl(op, rewriter, tch, loc);
+
         auto i8PtrType = th.getI8PtrType();
 
-        // Get a symbol reference to the printf function, inserting it if necessary.
-        auto putsFuncOp = ch.getOrInsertFunction("puts", th.getFunctionType(rewriter.getI32Type(), i8PtrType, false));
+        // buffered output is defined by OutputBufferPass
+        auto writeFuncOp = ch.getOrInsertFunction(
+            OUTPUT_WRITE_NAME, th.getFunctionType(th.getVoidType(), {i8PtrType, th.getI64Type()}));
+        auto lineFuncOp =
+            ch.getOrInsertFunction(OUTPUT_LINE_NAME, th.getFunctionType(th.getVoidType(), ArrayRef<mlir::Type>{}));
 
-        auto strType = mlir_ts::StringType::get(rewriter.getContext());
+        auto write = [&](std::pair<mlir::Value, mlir::Value> chars) {
+            rewriter.create<LLVM::CallOp>(loc, writeFuncOp, ValueRange{chars.first, chars.second});
+        };
 
-        SmallVector<mlir::Value> values;
-        mlir::Value spaceString;
-        for (auto item : transformed.inputs())
+        auto writeString = [&](mlir::Value str) { write({str, slh.length(str)}); };
+
+        for (auto it : llvm::enumerate(llvm::zip(op.inputs(), transformed.inputs())))
         {
-            assert(item.getType() == i8PtrType);
-            if (values.size() > 0)
+            if (it.index() > 0)
             {
-                if (!spaceString)
-                {
-                    spaceString = rewriter.create<mlir_ts::ConstantOp>(loc, strType, rewriter.getStringAttr(" "));
-                }
-
-                values.push_back(spaceString);
+                writeString(ch.getOrCreateGlobalString("__space__", std::string(" ")));
             }
 
-            values.push_back(item);
+            auto type = std::get<0>(it.value()).getType();
+            auto item = std::get<1>(it.value());
+            if (type.isa<mlir_ts::NumberType>())
+            {
+                write(cl.f32OrF64ToChars(item));
+            }
+            else if (type.isa<mlir_ts::BooleanType>())
+            {
+                writeString(rewriter.create<LLVM::SelectOp>(
+                    loc, item, ch.getOrCreateGlobalString("__true__", std::string("true")),
+                    ch.getOrCreateGlobalString("__false__", std::string("false"))));
+            }
+            else if (type.isInteger(32))
+            {
+                write(cl.intToChars(item));
+            }
+            else if (type.isInteger(64))
+            {
+                write(cl.int64ToChars(item));
+            }
+            else
+            {
+                assert(item.getType() == i8PtrType);
+                writeString(item);
+            }
         }
 
-        if (values.size() > 1)
-        {
-            auto stack = rewriter.create<LLVM::StackSaveOp>(loc, i8PtrType);
-
-            mlir::Value result =
-                rewriter.create<mlir_ts::StringConcatOp>(loc, strType, values, rewriter.getBoolAttr(true));
-
-            rewriter.create<LLVM::CallOp>(loc, putsFuncOp, result);
-
-            rewriter.create<LLVM::StackRestoreOp>(loc, stack);
-        }
-        else
-        {
-            rewriter.create<LLVM::CallOp>(loc, putsFuncOp, values.front());
-        }
+        writeString(ch.getOrCreateGlobalString("__new_line__", std::string("\n")));
+        rewriter.create<LLVM::CallOp>(loc, lineFuncOp, ValueRange{});
 
         // Notify the rewriter that this operation has been removed.
         rewriter.eraseOp(op);
@@ -295,13 +317,12 @@ class ParseIntOpLowering : public TsLlvmPattern<mlir_ts::ParseIntOp>
 
         TypeHelper th(rewriter);
         LLVMCodeHelper ch(op, rewriter, getTypeConverter());
+        TypeConverterHelper tch(getTypeConverter());
 
-        // Insert the `atoi` declaration if necessary.
-        auto i8PtrTy = th.getI8PtrType();
-        LLVM::LLVMFuncOp parseIntFuncOp;
         if (transformed.base())
         {
-            parseIntFuncOp = ch.getOrInsertFunction(
+            auto i8PtrTy = th.getI8PtrType();
+            auto parseIntFuncOp = ch.getOrInsertFunction(
                 "strtol",
                 th.getFunctionType(rewriter.getI32Type(), {i8PtrTy, th.getI8PtrPtrType(), rewriter.getI32Type()}));
             auto nullOp = rewriter.create<LLVM::NullOp>(op->getLoc(), th.getI8PtrPtrType());
@@ -310,8 +331,8 @@ class ParseIntOpLowering : public TsLlvmPattern<mlir_ts::ParseIntOp>
         }
         else
         {
-            parseIntFuncOp = ch.getOrInsertFunction("atoi", th.getFunctionType(rewriter.getI32Type(), {i8PtrTy}));
-            rewriter.replaceOpWithNewOp<LLVM::CallOp>(op, parseIntFuncOp, ValueRange{transformed.arg()});
+            ConvertLogic cl(op, rewriter, tch, op->getLoc());
+            rewriter.replaceOp(op, ValueRange{cl.parseInt(transformed.arg())});
         }
 
         return success();
@@ -328,20 +349,17 @@ class ParseFloatOpLowering : public TsLlvmPattern<mlir_ts::ParseFloatOp>
     {
         Adaptor transformed(operands);
 
-        TypeHelper th(rewriter);
-        LLVMCodeHelper ch(op, rewriter, getTypeConverter());
+        TypeConverterHelper tch(getTypeConverter());
 
         auto loc = op->getLoc();
 
-        // Insert the `atof` declaration if necessary.
-        auto i8PtrTy = th.getI8PtrType();
-        auto parseFloatFuncOp = ch.getOrInsertFunction("atof", th.getFunctionType(rewriter.getF64Type(), {i8PtrTy}));
+        ConvertLogic cl(op, rewriter, tch, loc);
+        auto parsed = cl.parseFloat(transformed.arg());
 
 #ifdef NUMBER_F64
-        auto funcCall = rewriter.replaceOpWithNewOp<LLVM::CallOp>(op, parseFloatFuncOp, ValueRange{transformed.arg()});
+        rewriter.replaceOp(op, ValueRange{parsed});
 #else
-        auto funcCall = rewriter.create<LLVM::CallOp>(loc, parseFloatFuncOp, ValueRange{transformed.arg()});
-        rewriter.replaceOpWithNewOp<LLVM::FPTruncOp>(op, rewriter.getF32Type(), funcCall.getResult(0));
+        rewriter.replaceOpWithNewOp<LLVM::FPTruncOp>(op, rewriter.getF32Type(), parsed);
 #endif
 
         return success();
@@ -447,16 +465,32 @@ class StringLengthOpLowering : public TsLlvmPattern<mlir_ts::StringLengthOp>
         Adaptor transformed(operands);
 
         TypeHelper th(rewriter);
-        LLVMCodeHelper ch(op, rewriter, getTypeConverter());
+        TypeConverterHelper tch(getTypeConverter());
+        StringLogicHelper slh(op, rewriter, tch);
 
-        auto loc = op->getLoc();
-        auto i8PtrTy = th.getI8PtrType();
+        // length is stored in header of string
+        auto size = slh.length(transformed.op());
+        rewriter.replaceOpWithNewOp<LLVM::TruncOp>(op, th.getI32Type(), size);
 
-        auto strlenFuncOp = ch.getOrInsertFunction("strlen", th.getFunctionType(th.getI64Type(), {i8PtrTy}));
+        return success();
+    }
+};
 
-        // calc size
-        auto size = rewriter.create<LLVM::CallOp>(loc, strlenFuncOp, ValueRange{transformed.op()});
-        rewriter.replaceOpWithNewOp<LLVM::TruncOp>(op, th.getI32Type(), size.getResult(0));
+class StringHashOpLowering : public TsLlvmPattern<mlir_ts::StringHashOp>
+{
+  public:
+    using TsLlvmPattern<mlir_ts::StringHashOp>::TsLlvmPattern;
+
+    LogicalResult matchAndRewrite(mlir_ts::StringHashOp op, ArrayRef<mlir::Value> operands,
+                                  ConversionPatternRewriter &rewriter) const final
+    {
+        Adaptor transformed(operands);
+
+        TypeConverterHelper tch(getTypeConverter());
+        StringLogicHelper slh(op, rewriter, tch);
+
+        auto hash = slh.hash(transformed.op());
+        rewriter.replaceOp(op, hash);
 
         return success();
     }
@@ -472,53 +506,76 @@ class StringConcatOpLowering : public TsLlvmPattern<mlir_ts::StringConcatOp>
     {
         Adaptor transformed(operands);
 
+        TypeConverterHelper tch(getTypeConverter());
+        StringLogicHelper slh(op, rewriter, tch);
+
+        // calc size
+        SmallVector<mlir::Value> lengths;
+        auto totalLength = slh.totalLength(transformed.ops(), lengths);
+
+        auto allocInStack = op.allocInStack().hasValue() && op.allocInStack().getValue();
+
+        auto newStringValue = slh.allocate(totalLength, allocInStack);
+
+        // copy
+        slh.copy(newStringValue, transformed.ops(), lengths);
+
+        rewriter.replaceOp(op, ValueRange{newStringValue});
+
+        return success();
+    }
+};
+
+class StringAppendOpLowering : public TsLlvmPattern<mlir_ts::StringAppendOp>
+{
+  public:
+    using TsLlvmPattern<mlir_ts::StringAppendOp>::TsLlvmPattern;
+
+    LogicalResult matchAndRewrite(mlir_ts::StringAppendOp op, ArrayRef<mlir::Value> operands,
+                                  ConversionPatternRewriter &rewriter) const final
+    {
+        Adaptor transformed(operands);
+
         TypeHelper th(rewriter);
         CodeLogicHelper clh(op, rewriter);
-        LLVMCodeHelper ch(op, rewriter, getTypeConverter());
+        TypeConverterHelper tch(getTypeConverter());
+        StringLogicHelper slh(op, rewriter, tch);
 
         auto loc = op->getLoc();
 
-        // TODO implement str concat
         auto i8PtrTy = th.getI8PtrType();
-        auto i8PtrPtrTy = th.getI8PtrPtrType();
+        auto i64Ty = th.getI64Type();
 
-        auto strlenFuncOp = ch.getOrInsertFunction("strlen", th.getFunctionType(rewriter.getI64Type(), {i8PtrTy}));
-        auto strcpyFuncOp = ch.getOrInsertFunction("strcpy", th.getFunctionType(i8PtrTy, {i8PtrTy, i8PtrTy}));
-        auto strcatFuncOp = ch.getOrInsertFunction("strcat", th.getFunctionType(i8PtrTy, {i8PtrTy, i8PtrTy}));
+        mlir::Value buffer = rewriter.create<LLVM::LoadOp>(loc, transformed.bufferRef());
+        mlir::Value length = rewriter.create<LLVM::LoadOp>(loc, transformed.lengthRef());
+        mlir::Value capacity = rewriter.create<LLVM::LoadOp>(loc, transformed.capacityRef());
 
-        mlir::Value size = clh.createI64ConstantOf(1);
-        // calc size
-        for (auto oper : transformed.ops())
-        {
-            auto size1 = rewriter.create<LLVM::CallOp>(loc, strlenFuncOp, oper);
-            size = rewriter.create<LLVM::AddOp>(loc, rewriter.getI64Type(), ValueRange{size, size1.getResult(0)});
-        }
+        SmallVector<mlir::Value> lengths;
+        auto appendLength = slh.totalLength(transformed.ops(), lengths);
+        mlir::Value newLength = rewriter.create<LLVM::AddOp>(loc, i64Ty, ValueRange{length, appendLength});
 
-        auto allocInStack = op.allocInStack().hasValue() && op.allocInStack().getValue();
+        // grow buffer at least twice to make appending amortized O(1)
+        auto needGrow = rewriter.create<LLVM::ICmpOp>(loc, LLVM::ICmpPredicate::ugt, newLength, capacity);
+        buffer = clh.conditionalExpressionLowering(
+            i8PtrTy, needGrow,
+            [&](OpBuilder &builder, Location loc) {
+                mlir::Value doubleCapacity = rewriter.create<LLVM::AddOp>(loc, i64Ty, ValueRange{capacity, capacity});
+                auto isDoubleEnough = rewriter.create<LLVM::ICmpOp>(loc, LLVM::ICmpPredicate::uge, doubleCapacity, newLength);
+                mlir::Value newCapacity = rewriter.create<LLVM::SelectOp>(loc, isDoubleEnough, doubleCapacity, newLength);
+                rewriter.create<LLVM::StoreOp>(loc, newCapacity, transformed.capacityRef());
 
-        mlir::Value newStringValue = allocInStack ? rewriter.create<LLVM::AllocaOp>(loc, i8PtrTy, size, true)
-                                                  : ch.MemoryAllocBitcast(i8PtrTy, size);
+                return slh.reallocate(buffer, newCapacity);
+            },
+            [&](OpBuilder &builder, Location loc) { return buffer; });
 
-        // copy
-        auto concat = false;
-        auto result = newStringValue;
-        for (auto oper : transformed.ops())
-        {
-            if (concat)
-            {
-                auto callResult = rewriter.create<LLVM::CallOp>(loc, strcatFuncOp, ValueRange{result, oper});
-                result = callResult.getResult(0);
-            }
-            else
-            {
-                auto callResult = rewriter.create<LLVM::CallOp>(loc, strcpyFuncOp, ValueRange{result, oper});
-                result = callResult.getResult(0);
-            }
+        auto end = rewriter.create<LLVM::GEPOp>(loc, i8PtrTy, buffer, ValueRange{length});
+        slh.copy(end, transformed.ops(), lengths);
+        slh.setLength(buffer, newLength);
 
-            concat = true;
-        }
+        rewriter.create<LLVM::StoreOp>(loc, buffer, transformed.bufferRef());
+        rewriter.create<LLVM::StoreOp>(loc, newLength, transformed.lengthRef());
 
-        rewriter.replaceOp(op, ValueRange{newStringValue});
+        rewriter.eraseOp(op);
 
         return success();
     }
@@ -538,6 +595,8 @@ class StringCompareOpLowering : public TsLlvmPattern<mlir_ts::StringCompareOp>
         CodeLogicHelper clh(op, rewriter);
         LLVMCodeHelper ch(op, rewriter, getTypeConverter());
         LLVMTypeConverterHelper llvmtch(*(LLVMTypeConverter *)getTypeConverter());
+        TypeConverterHelper tch(getTypeConverter());
+        StringLogicHelper slh(op, rewriter, tch);
 
         auto loc = op->getLoc();
 
@@ -564,23 +623,28 @@ class StringCompareOpLowering : public TsLlvmPattern<mlir_ts::StringCompareOp>
             [&](OpBuilder &builder, Location loc) {
                 // both not null
                 auto const0 = clh.createI32ConstantOf(0);
-                auto compareResult =
-                    rewriter.create<LLVM::CallOp>(loc, strcmpFuncOp, ValueRange{transformed.op1(), transformed.op2()});
 
-                // else compare body
-                mlir::Value bodyCmpResult;
+                // equality is checked by length first, strings of the same length are compared by memcmp
                 switch ((SyntaxKind)op.code())
                 {
                 case SyntaxKind::EqualsEqualsToken:
                 case SyntaxKind::EqualsEqualsEqualsToken:
-                    bodyCmpResult =
-                        rewriter.create<LLVM::ICmpOp>(loc, LLVM::ICmpPredicate::eq, compareResult.getResult(0), const0);
-                    break;
+                    return slh.equals(transformed.op1(), transformed.op2());
                 case SyntaxKind::ExclamationEqualsToken:
                 case SyntaxKind::ExclamationEqualsEqualsToken:
-                    bodyCmpResult =
-                        rewriter.create<LLVM::ICmpOp>(loc, LLVM::ICmpPredicate::ne, compareResult.getResult(0), const0);
+                    return (mlir::Value)rewriter.create<LLVM::XOrOp>(
+                        loc, slh.equals(transformed.op1(), transformed.op2()), clh.createI1ConstantOf(true));
+                default:
                     break;
+                }
+
+                auto compareResult =
+                    rewriter.create<LLVM::CallOp>(loc, strcmpFuncOp, ValueRange{transformed.op1(), transformed.op2()});
+
+                // else compare body
+                mlir::Value bodyCmpResult;
+                switch ((SyntaxKind)op.code())
+                {
                 case SyntaxKind::GreaterThanToken:
                     bodyCmpResult = rewriter.create<LLVM::ICmpOp>(loc, LLVM::ICmpPredicate::sgt,
                                                                   compareResult.getResult(0), const0);
@@ -657,19 +721,18 @@ class CharToStringOpLowering : public TsLlvmPattern<mlir_ts::CharToStringOp>
     {
         Adaptor transformed(operands);
 
-        TypeHelper th(rewriter);
         CodeLogicHelper clh(op, rewriter);
         LLVMCodeHelper ch(op, rewriter, typeConverter);
+        TypeConverterHelper tch(getTypeConverter());
+        StringLogicHelper slh(op, rewriter, tch);
 
         auto loc = op->getLoc();
 
         auto charType = mlir_ts::CharType::get(rewriter.getContext());
         auto charRefType = mlir_ts::RefType::get(charType);
-        auto i8PtrTy = th.getI8PtrType();
 
-        auto bufferSizeValue = clh.createI64ConstantOf(2);
         // TODO: review it
-        auto newStringValue = rewriter.create<LLVM::AllocaOp>(loc, i8PtrTy, bufferSizeValue, true);
+        auto newStringValue = slh.allocate(clh.createI64ConstantOf(1), true);
 
         auto index0Value = clh.createI32ConstantOf(0);
         auto index1Value = clh.createI32ConstantOf(1);
@@ -911,11 +974,21 @@ struct FuncOpLowering : public TsLlvmPattern<mlir_ts::FuncOp>
                 continue;
             }
 
+            if (namedAttr.first == NOUNWIND_ATTR_NAME)
+            {
+                continue;
+            }
+
             newFuncOp->setAttr(namedAttr.first, namedAttr.second);
         }
 
         SmallVector<mlir::Attribute> funcAttrs;
 
+        if (funcOp->hasAttr(NOUNWIND_ATTR_NAME))
+        {
+            funcAttrs.push_back(ATTR("nounwind"));
+        }
+
         if (funcOp.personality().hasValue() && funcOp.personality().getValue())
         {
 #if WIN_EXCEPTION
@@ -990,6 +1063,16 @@ struct SymbolCallInternalOpLowering : public TsLlvmPattern<mlir_ts::SymbolCallIn
             llvmTypes.push_back(tch.convertType(type));
         }
 
+        if (isExternalStringResult(op.callee(), op.getResultTypes()))
+        {
+            auto callOp = rewriter.create<LLVM::CallOp>(
+                loc, llvmTypes, ::mlir::FlatSymbolRefAttr::get(rewriter.getContext(), op.callee()), transformed.operands());
+
+            StringLogicHelper slh(op, rewriter, tch);
+            rewriter.replaceOp(op, slh.fromExternal(callOp.getResult(0)));
+            return success();
+        }
+
         // just replace
         rewriter.replaceOpWithNewOp<LLVM::CallOp>(
             op, llvmTypes, ::mlir::FlatSymbolRefAttr::get(rewriter.getContext(), op.callee()), transformed.operands());
@@ -1152,6 +1235,19 @@ struct InvokeOpLowering : public TsLlvmPattern<mlir_ts::InvokeOp>
             llvmTypes.push_back(tch.convertType(type));
         }
 
+        if (op.callee().hasValue() && isExternalStringResult(op.callee().getValue(), op.getResultTypes()))
+        {
+            auto invokeOp = rewriter.create<LLVM::InvokeOp>(
+                op->getLoc(), llvmTypes, op.calleeAttr(), transformed.operands(), op.normalDest(),
+                transformed.normalDestOperands(), op.unwindDest(), transformed.unwindDestOperands());
+
+            // result is available only on normal path
+            rewriter.setInsertionPointToStart(op.normalDest());
+            StringLogicHelper slh(op, rewriter, tch);
+            rewriter.replaceOp(op, slh.fromExternal(invokeOp.getResult(0)));
+            return success();
+        }
+
         // just replace
         rewriter.replaceOpWithNewOp<LLVM::InvokeOp>(op, llvmTypes, op.calleeAttr(), transformed.operands(),
                                                     op.normalDest(), transformed.normalDestOperands(), op.unwindDest(),
@@ -1364,7 +1460,7 @@ struct BoxOpLowering : public TsLlvmPattern<mlir_ts::BoxOp>
         auto in = transformed.in();
 
         AnyLogic al(op, rewriter, tch, loc);
-        auto result = al.castToAny(in, transformed.typeInfo(), in.getType());
+        auto result = al.castToAny(in, transformed.typeInfo(), in.getType(), op.typeInfo());
 
         rewriter.replaceOp(op, result);
 
@@ -1414,15 +1510,15 @@ struct CreateUnionInstanceOpLowering : public TsLlvmPattern<mlir_ts::CreateUnion
         MLIRTypeHelper mth(rewriter.getContext());
 
         CastLogicHelper castLogic(op, rewriter, tch);
+        TypeIdLogicHelper tilh(op, rewriter, tch);
 
         auto in = transformed.in();
 
-        auto i8PtrTy = th.getI8PtrType();
         auto valueType = transformed.in().getType();
         auto resType = tch.convertType(op.getType());
 
         mlir::SmallVector<mlir::Type> types;
-        types.push_back(i8PtrTy);
+        types.push_back(tilh.getTypeIdType());
         types.push_back(valueType);
         auto unionPartialType = LLVM::LLVMStructType::getLiteral(rewriter.getContext(), types, false);
         if (!mth.isUnionTypeNeedsTag(op.getType().cast<mlir_ts::UnionType>()))
@@ -1435,9 +1531,9 @@ struct CreateUnionInstanceOpLowering : public TsLlvmPattern<mlir_ts::CreateUnion
         else
         {
             // create tagged union
+            auto typeId = tilh.typeIdFromTypeInfo(op.typeInfo(), transformed.typeInfo());
             auto udefVal = rewriter.create<LLVM::UndefOp>(loc, unionPartialType);
-            auto val0 =
-                rewriter.create<LLVM::InsertValueOp>(loc, udefVal, transformed.typeInfo(), clh.getStructIndexAttr(0));
+            auto val0 = rewriter.create<LLVM::InsertValueOp>(loc, udefVal, typeId, clh.getStructIndexAttr(0));
             auto val1 = rewriter.create<LLVM::InsertValueOp>(loc, val0, in, clh.getStructIndexAttr(1));
 
             auto casted = castLogic.castLLVMTypes(val1, unionPartialType, op.getType(), resType);
@@ -1468,13 +1564,12 @@ struct GetValueFromUnionOpLowering : public TsLlvmPattern<mlir_ts::GetValueFromU
         bool needTag = mth.isUnionTypeNeedsTag(op.in().getType().cast<mlir_ts::UnionType>());
         if (needTag)
         {
-            auto in = transformed.in();
+            TypeIdLogicHelper tilh(op, rewriter, tch);
 
-            auto i8PtrTy = th.getI8PtrType();
             auto valueType = tch.convertType(op.getType());
 
             mlir::SmallVector<mlir::Type> types;
-            types.push_back(i8PtrTy);
+            types.push_back(tilh.getTypeIdType());
             types.push_back(valueType);
             auto unionPartialType = LLVM::LLVMStructType::getLiteral(rewriter.getContext(), types, false);
 
@@ -1514,14 +1609,18 @@ struct GetTypeInfoFromUnionOpLowering : public TsLlvmPattern<mlir_ts::GetTypeInf
         bool needTag = mth.isUnionTypeNeedsTag(op.in().getType().cast<mlir_ts::UnionType>(), baseType);
         if (needTag)
         {
-            auto val0 = rewriter.create<LLVM::ExtractValueOp>(loc, tch.convertType(op.getType()), transformed.in(),
-                                                              clh.getStructIndexAttr(0));
+            TypeIdLogicHelper tilh(op, rewriter, tch);
+            auto typeId =
+                rewriter.create<LLVM::ExtractValueOp>(loc, tilh.getTypeIdType(), transformed.in(), clh.getStructIndexAttr(0));
+            auto typeInfo = tilh.typeInfoFromTypeId(typeId);
 
-            rewriter.replaceOp(op, ValueRange{val0});
+            rewriter.replaceOp(op, ValueRange{typeInfo});
         }
         else
         {
-            auto typeOfValue = rewriter.create<mlir_ts::TypeOfOp>(loc, baseType, transformed.in());
+            // value is stored as value of base type, typeof is known
+            TypeOfOpHelper toh(rewriter);
+            auto typeOfValue = toh.typeOfLogic(loc, baseType);
 
             rewriter.replaceOp(op, ValueRange{typeOfValue});
         }
@@ -1552,7 +1651,9 @@ struct VariableOpLowering : public TsLlvmPattern<mlir_ts::VariableOp>
 #ifdef ALLOC_ALL_VARS_IN_HEAP
         auto isCaptured = true;
 #elif ALLOC_CAPTURED_VARS_IN_HEAP
-        auto isCaptured = varOp.captured().hasValue() && varOp.captured().getValue();
+        // captured variable which does not outlive function (see EscapeAnalysisPass) stays in stack
+        auto isCaptured = varOp.captured().hasValue() && varOp.captured().getValue() &&
+                          !varOp->hasAttr(STACK_ALLOC_ATTR_NAME);
 #else
         auto isCaptured = false;
 #endif
@@ -1691,7 +1792,20 @@ struct NewOpLowering : public TsLlvmPattern<mlir_ts::NewOp>
         mlir::Value value;
         if (newOp.stackAlloc().hasValue() && newOp.stackAlloc().getValue())
         {
-            value = rewriter.create<LLVM::AllocaOp>(loc, resultType, clh.createI32ConstantOf(1));
+            // put alloc at 'func' top, so instance created in loop reuses the same memory
+            auto parentFuncOp = newOp->getParentOfType<LLVM::LLVMFuncOp>();
+            if (parentFuncOp)
+            {
+                mlir::OpBuilder::InsertionGuard insertGuard(rewriter);
+                rewriter.setInsertionPoint(&parentFuncOp.getBody().front().front());
+                value = rewriter.create<LLVM::AllocaOp>(loc, resultType, clh.createI32ConstantOf(1));
+            }
+            else
+            {
+                value = rewriter.create<LLVM::AllocaOp>(loc, resultType, clh.createI32ConstantOf(1));
+            }
+
+            ch.MemoryZero(value, storageType);
         }
         else
         {
@@ -1877,7 +1991,10 @@ struct CreateArrayOpLowering : public TsLlvmPattern<mlir_ts::CreateArrayOp>
         auto structValue3 = rewriter.create<LLVM::InsertValueOp>(loc, llvmRtArrayStructType, structValue2,
                                                                  newCountAsI32Type, clh.getStructIndexAttr(1));
 
-        rewriter.replaceOp(createArrayOp, ValueRange{structValue3});
+        auto structValue4 = rewriter.create<LLVM::InsertValueOp>(loc, llvmRtArrayStructType, structValue3,
+                                                                 newCountAsI32Type, clh.getStructIndexAttr(2));
+
+        rewriter.replaceOp(createArrayOp, ValueRange{structValue4});
         return success();
     }
 };
@@ -1922,7 +2039,10 @@ struct NewEmptyArrayOpLowering : public TsLlvmPattern<mlir_ts::NewEmptyArrayOp>
         auto structValue3 = rewriter.create<LLVM::InsertValueOp>(loc, llvmRtArrayStructType, structValue2, size0,
                                                                  clh.getStructIndexAttr(1));
 
-        rewriter.replaceOp(newEmptyArrOp, ValueRange{structValue3});
+        auto structValue4 = rewriter.create<LLVM::InsertValueOp>(loc, llvmRtArrayStructType, structValue3, size0,
+                                                                 clh.getStructIndexAttr(2));
+
+        rewriter.replaceOp(newEmptyArrOp, ValueRange{structValue4});
         return success();
     }
 };
@@ -1971,7 +2091,10 @@ struct NewArrayOpLowering : public TsLlvmPattern<mlir_ts::NewArrayOp>
         auto structValue3 = rewriter.create<LLVM::InsertValueOp>(loc, llvmRtArrayStructType, structValue2,
                                                                  transformed.count(), clh.getStructIndexAttr(1));
 
-        rewriter.replaceOp(newArrOp, ValueRange{structValue3});
+        auto structValue4 = rewriter.create<LLVM::InsertValueOp>(loc, llvmRtArrayStructType, structValue3,
+                                                                 transformed.count(), clh.getStructIndexAttr(2));
+
+        rewriter.replaceOp(newArrOp, ValueRange{structValue4});
         return success();
     }
 };
@@ -1985,10 +2108,10 @@ struct PushOpLowering : public TsLlvmPattern<mlir_ts::PushOp>
     {
         Adaptor transformed(operands);
 
-        LLVMCodeHelper ch(pushOp, rewriter, getTypeConverter());
         CodeLogicHelper clh(pushOp, rewriter);
         TypeConverterHelper tch(getTypeConverter());
         TypeHelper th(rewriter);
+        ArrayLogicHelper alh(pushOp, rewriter, tch);
 
         auto loc = pushOp.getLoc();
 
@@ -1997,27 +2120,15 @@ struct PushOpLowering : public TsLlvmPattern<mlir_ts::PushOp>
         auto llvmElementType = tch.convertType(elementType);
         auto llvmPtrElementType = th.getPointerType(llvmElementType);
 
-        auto ind0 = clh.createI32ConstantOf(0);
-        auto currentPtrPtr = rewriter.create<LLVM::GEPOp>(loc, th.getPointerType(llvmPtrElementType), transformed.op(),
-                                                          ValueRange{ind0, ind0});
-        auto currentPtr = rewriter.create<LLVM::LoadOp>(loc, llvmPtrElementType, currentPtrPtr);
-
-        auto ind1 = clh.createI32ConstantOf(1);
-        auto countAsI32TypePtr = rewriter.create<LLVM::GEPOp>(loc, th.getPointerType(th.getI32Type()), transformed.op(),
-                                                              ValueRange{ind0, ind1});
-        auto countAsI32Type = rewriter.create<LLVM::LoadOp>(loc, th.getI32Type(), countAsI32TypePtr);
-
-        auto countAsIndexType = rewriter.create<ZeroExtendIOp>(loc, countAsI32Type, th.getIndexType());
+        auto countAsI32TypePtr = alh.lengthRef(transformed.op());
+        auto countAsIndexType = alh.loadAsIndex(countAsI32TypePtr);
 
         auto incSize = clh.createIndexConstantOf(transformed.items().size());
         auto newCountAsIndexType =
             rewriter.create<LLVM::AddOp>(loc, th.getIndexType(), ValueRange{countAsIndexType, incSize});
 
-        auto sizeOfTypeValue = rewriter.create<mlir_ts::SizeOfOp>(loc, th.getIndexType(), elementType);
-        auto multSizeOfTypeValue =
-            rewriter.create<LLVM::MulOp>(loc, th.getIndexType(), ValueRange{sizeOfTypeValue, newCountAsIndexType});
-
-        auto allocated = ch.MemoryReallocBitcast(llvmPtrElementType, currentPtr, multSizeOfTypeValue);
+        // data is reallocated only when capacity is not enough
+        auto allocated = alh.ensureCapacity(transformed.op(), arrayType, newCountAsIndexType);
 
         mlir::Value index = countAsIndexType;
         auto next = false;
@@ -2053,11 +2164,7 @@ struct PushOpLowering : public TsLlvmPattern<mlir_ts::PushOp>
             next = true;
         }
 
-        rewriter.create<LLVM::StoreOp>(loc, allocated, currentPtrPtr);
-
-        auto newCountAsI32Type = rewriter.create<TruncateIOp>(loc, newCountAsIndexType, th.getI32Type());
-
-        rewriter.create<LLVM::StoreOp>(loc, newCountAsI32Type, countAsI32TypePtr);
+        alh.storeAsI32(newCountAsIndexType, countAsI32TypePtr);
 
         rewriter.replaceOp(pushOp, ValueRange{newCountAsIndexType});
         return success();
@@ -2073,10 +2180,10 @@ struct PopOpLowering : public TsLlvmPattern<mlir_ts::PopOp>
     {
         Adaptor transformed(operands);
 
-        LLVMCodeHelper ch(popOp, rewriter, getTypeConverter());
         CodeLogicHelper clh(popOp, rewriter);
         TypeConverterHelper tch(getTypeConverter());
         TypeHelper th(rewriter);
+        ArrayLogicHelper alh(popOp, rewriter, tch);
 
         auto loc = popOp.getLoc();
 
@@ -2085,23 +2192,10 @@ struct PopOpLowering : public TsLlvmPattern<mlir_ts::PopOp>
         auto llvmElementType = tch.convertType(elementType);
         auto llvmPtrElementType = th.getPointerType(llvmElementType);
 
-        mlir::Type storageType;
-        mlir::TypeSwitch<mlir::Type>(popOp.op().getType())
-            .Case<mlir_ts::ClassType>([&](auto classType) { storageType = classType.getStorageType(); })
-            .Case<mlir_ts::ValueRefType>([&](auto valueRefType) { storageType = valueRefType.getElementType(); })
-            .Default([&](auto type) { storageType = type; });
+        auto currentPtr = rewriter.create<LLVM::LoadOp>(loc, llvmPtrElementType, alh.dataRef(transformed.op(), arrayType));
 
-        auto ind0 = clh.createI32ConstantOf(0);
-        auto currentPtrPtr = rewriter.create<LLVM::GEPOp>(loc, th.getPointerType(llvmPtrElementType), transformed.op(),
-                                                          ValueRange{ind0, ind0});
-        auto currentPtr = rewriter.create<LLVM::LoadOp>(loc, llvmPtrElementType, currentPtrPtr);
-
-        auto ind1 = clh.createI32ConstantOf(1);
-        auto countAsI32TypePtr = rewriter.create<LLVM::GEPOp>(loc, th.getPointerType(th.getI32Type()), transformed.op(),
-                                                              ValueRange{ind0, ind1});
-        auto countAsI32Type = rewriter.create<LLVM::LoadOp>(loc, th.getI32Type(), countAsI32TypePtr);
-
-        auto countAsIndexType = rewriter.create<ZeroExtendIOp>(loc, countAsI32Type, th.getIndexType());
+        auto countAsI32TypePtr = alh.lengthRef(transformed.op());
+        auto countAsIndexType = alh.loadAsIndex(countAsI32TypePtr);
 
         auto incSize = clh.createIndexConstantOf(1);
         auto newCountAsIndexType =
@@ -2112,19 +2206,33 @@ struct PopOpLowering : public TsLlvmPattern<mlir_ts::PopOp>
             rewriter.create<LLVM::GEPOp>(loc, llvmPtrElementType, currentPtr, ValueRange{newCountAsIndexType});
         auto loadedElement = rewriter.create<LLVM::LoadOp>(loc, llvmElementType, offset);
 
-        auto sizeOfTypeValue = rewriter.create<mlir_ts::SizeOfOp>(loc, th.getIndexType(), storageType);
-        auto multSizeOfTypeValue =
-            rewriter.create<LLVM::MulOp>(loc, th.getIndexType(), ValueRange{sizeOfTypeValue, newCountAsIndexType});
+        // memory is kept as capacity of array
+        alh.storeAsI32(newCountAsIndexType, countAsI32TypePtr);
 
-        auto allocated = ch.MemoryReallocBitcast(llvmPtrElementType, currentPtr, multSizeOfTypeValue);
+        rewriter.replaceOp(popOp, ValueRange{loadedElement});
+        return success();
+    }
+};
+
+struct ReserveOpLowering : public TsLlvmPattern<mlir_ts::ReserveOp>
+{
+    using TsLlvmPattern<mlir_ts::ReserveOp>::TsLlvmPattern;
+
+    LogicalResult matchAndRewrite(mlir_ts::ReserveOp reserveOp, ArrayRef<mlir::Value> operands,
+                                  ConversionPatternRewriter &rewriter) const final
+    {
+        Adaptor transformed(operands);
 
-        rewriter.create<LLVM::StoreOp>(loc, allocated, currentPtrPtr);
+        TypeConverterHelper tch(getTypeConverter());
+        TypeHelper th(rewriter);
+        ArrayLogicHelper alh(reserveOp, rewriter, tch);
 
-        auto newCountAsI32Type = rewriter.create<TruncateIOp>(loc, newCountAsIndexType, th.getI32Type());
+        auto arrayType = reserveOp.op().getType().cast<mlir_ts::RefType>().getElementType().cast<mlir_ts::ArrayType>();
 
-        rewriter.create<LLVM::StoreOp>(loc, newCountAsI32Type, countAsI32TypePtr);
+        auto countAsIndexType = rewriter.create<LLVM::ZExtOp>(reserveOp.getLoc(), th.getIndexType(), transformed.count());
+        alh.ensureCapacity(transformed.op(), arrayType, countAsIndexType);
 
-        rewriter.replaceOp(popOp, ValueRange{loadedElement});
+        rewriter.eraseOp(reserveOp);
         return success();
     }
 };
@@ -2332,6 +2440,44 @@ struct LogicalBinaryOpLowering : public TsLlvmPattern<mlir_ts::LogicalBinaryOp>
                                                                              *(LLVMTypeConverter *)getTypeConverter());
     }
 
+    mlir::Value compareUnionTypeId(mlir_ts::LogicalBinaryOp logicalBinaryOp, SyntaxKind op,
+                                   ConversionPatternRewriter &rewriter) const
+    {
+        if (op != SyntaxKind::EqualsEqualsToken && op != SyntaxKind::EqualsEqualsEqualsToken &&
+            op != SyntaxKind::ExclamationEqualsToken && op != SyntaxKind::ExclamationEqualsEqualsToken)
+        {
+            return mlir::Value();
+        }
+
+        auto typeInfoOp = logicalBinaryOp.operand1().getDefiningOp<mlir_ts::GetTypeInfoFromUnionOp>();
+        auto constTypeInfo = logicalBinaryOp.operand2();
+        if (!typeInfoOp)
+        {
+            typeInfoOp = logicalBinaryOp.operand2().getDefiningOp<mlir_ts::GetTypeInfoFromUnionOp>();
+            constTypeInfo = logicalBinaryOp.operand1();
+        }
+
+        if (!typeInfoOp || TypeIdLogicHelper::constTypeId(constTypeInfo) < 0)
+        {
+            return mlir::Value();
+        }
+
+        MLIRTypeHelper mth(rewriter.getContext());
+        if (!mth.isUnionTypeNeedsTag(typeInfoOp.in().getType().cast<mlir_ts::UnionType>()))
+        {
+            return mlir::Value();
+        }
+
+        TypeConverterHelper tch(getTypeConverter());
+        CodeLogicHelper clh(logicalBinaryOp, rewriter);
+        TypeIdLogicHelper tilh(logicalBinaryOp, rewriter, tch);
+
+        auto unionValue = rewriter.getRemappedValue(typeInfoOp.in());
+        auto typeId = rewriter.create<LLVM::ExtractValueOp>(logicalBinaryOp->getLoc(), tilh.getTypeIdType(), unionValue,
+                                                            clh.getStructIndexAttr(0));
+        return tilh.compareTypeId(op, typeId, constTypeInfo);
+    }
+
     LogicalResult matchAndRewrite(mlir_ts::LogicalBinaryOp logicalBinaryOp, ArrayRef<mlir::Value> operands,
                                   ConversionPatternRewriter &rewriter) const final
     {
@@ -2344,6 +2490,13 @@ struct LogicalBinaryOpLowering : public TsLlvmPattern<mlir_ts::LogicalBinaryOp>
         auto opType1 = logicalBinaryOp.operand1().getType();
         auto opType2 = logicalBinaryOp.operand2().getType();
 
+        // typeof of union value vs const string, compare type ids
+        if (auto typeIdCmp = compareUnionTypeId(logicalBinaryOp, op, rewriter))
+        {
+            rewriter.replaceOp(logicalBinaryOp, typeIdCmp);
+            return success();
+        }
+
         // int and float
         mlir::Value value;
         switch (op)
@@ -3410,89 +3563,6 @@ struct EndCleanupOpLowering : public TsLlvmPattern<mlir_ts::EndCleanupOp>
 };
 
 #endif
-struct TrampolineOpLowering : public TsLlvmPattern<mlir_ts::TrampolineOp>
-{
-    using TsLlvmPattern<mlir_ts::TrampolineOp>::TsLlvmPattern;
-
-    LogicalResult matchAndRewrite(mlir_ts::TrampolineOp trampolineOp, ArrayRef<mlir::Value> operands,
-                                  ConversionPatternRewriter &rewriter) const final
-    {
-        Adaptor transformed(operands);
-
-        // TODO: missing attribute "nest" on parameter
-        auto location = trampolineOp->getLoc();
-
-        TypeHelper th(rewriter);
-        TypeConverterHelper tch(getTypeConverter());
-        CodeLogicHelper clh(trampolineOp, rewriter);
-        LLVMCodeHelper ch(trampolineOp, rewriter, getTypeConverter());
-        CastLogicHelper castLogic(trampolineOp, rewriter, tch);
-
-        auto i8PtrTy = th.getI8PtrType();
-
-        auto initTrampolineFuncOp = ch.getOrInsertFunction(
-            "llvm.init.trampoline", th.getFunctionType(th.getVoidType(), {i8PtrTy, i8PtrTy, i8PtrTy}));
-        auto adjustTrampolineFuncOp =
-            ch.getOrInsertFunction("llvm.adjust.trampoline", th.getFunctionType(i8PtrTy, {i8PtrTy}));
-        // Win32 specifics
-        auto enableExecuteStackFuncOp =
-            ch.getOrInsertFunction("__enable_execute_stack", th.getFunctionType(th.getVoidType(), {i8PtrTy}));
-
-        // allocate temp trampoline
-        auto bufferType = th.getPointerType(th.getI8Array(TRAMPOLINE_SIZE));
-
-#ifdef ALLOC_TRAMPOLINE_IN_HEAP
-        auto allocInHeap = true;
-#else
-        auto allocInHeap = trampolineOp.allocInHeap().hasValue() && trampolineOp.allocInHeap().getValue();
-#endif
-
-        mlir::Value trampolinePtr;
-        if (allocInHeap)
-        {
-            trampolinePtr = ch.MemoryAlloc(bufferType);
-        }
-        else
-        {
-            mlir::Value trampoline;
-            {
-                // we can't reallocate alloc for trampolines
-                /*
-                // put all allocs at 'func' top
-                auto parentFuncOp = trampolineOp->getParentOfType<LLVM::LLVMFuncOp>();
-                assert(parentFuncOp);
-                mlir::OpBuilder::InsertionGuard insertGuard(rewriter);
-                rewriter.setInsertionPoint(&parentFuncOp.getBody().front().front());
-                */
-
-                trampoline = rewriter.create<LLVM::AllocaOp>(location, bufferType, clh.createI32ConstantOf(1));
-            }
-
-            auto const0 = clh.createI32ConstantOf(0);
-            trampolinePtr = rewriter.create<LLVM::GEPOp>(location, i8PtrTy, ValueRange{trampoline, const0, const0});
-        }
-
-        // init trampoline
-        rewriter.create<LLVM::CallOp>(location, initTrampolineFuncOp,
-                                      ValueRange{trampolinePtr, clh.castToI8Ptr(transformed.callee()),
-                                                 clh.castToI8Ptr(transformed.data_reference())});
-
-        auto callAdjustedTrampoline =
-            rewriter.create<LLVM::CallOp>(location, adjustTrampolineFuncOp, ValueRange{trampolinePtr});
-        auto adjustedTrampolinePtr = callAdjustedTrampoline.getResult(0);
-
-        rewriter.create<LLVM::CallOp>(location, enableExecuteStackFuncOp, ValueRange{adjustedTrampolinePtr});
-
-        // mlir::Value castFunc = rewriter.create<mlir_ts::CastOp>(location, trampolineOp.getType(),
-        // adjustedTrampolinePtr); replacement
-        auto castFunc = castLogic.cast(adjustedTrampolinePtr, adjustedTrampolinePtr.getType(), trampolineOp.getType());
-
-        rewriter.replaceOp(trampolineOp, castFunc);
-
-        return success();
-    }
-};
-
 struct VTableOffsetRefOpLowering : public TsLlvmPattern<mlir_ts::VTableOffsetRefOp>
 {
     using TsLlvmPattern<mlir_ts::VTableOffsetRefOp>::TsLlvmPattern;
@@ -4223,6 +4293,207 @@ class SwitchStateInternalOpLowering : public TsLlvmPattern<mlir_ts::SwitchStateI
     }
 };
 
+// frame of coroutine is allocated in GC memory and it is not destroyed explicitly, it is released with generator object
+struct CoroutineBeginOpLowering : public TsLlvmPattern<mlir_ts::CoroutineBeginOp>
+{
+    using TsLlvmPattern<mlir_ts::CoroutineBeginOp>::TsLlvmPattern;
+
+    LogicalResult matchAndRewrite(mlir_ts::CoroutineBeginOp coroutineBeginOp, ArrayRef<mlir::Value> operands,
+                                  ConversionPatternRewriter &rewriter) const final
+    {
+        Adaptor transformed(operands);
+
+        TypeHelper th(rewriter);
+        LLVMCodeHelper ch(coroutineBeginOp, rewriter, getTypeConverter());
+        CodeLogicHelper clh(coroutineBeginOp, rewriter);
+
+        auto loc = coroutineBeginOp->getLoc();
+
+        auto i8PtrTy = th.getI8PtrType();
+        auto tokenTy = LLVM::LLVMTokenType::get(rewriter.getContext());
+
+        auto coroIdFuncOp = ch.getOrInsertFunction(
+            "llvm.coro.id", th.getFunctionType(tokenTy, {th.getI32Type(), i8PtrTy, i8PtrTy, i8PtrTy}));
+        auto coroSizeFuncOp =
+            ch.getOrInsertFunction("llvm.coro.size.i64", th.getFunctionType(th.getI64Type(), ArrayRef<mlir::Type>{}));
+        auto coroBeginFuncOp =
+            ch.getOrInsertFunction("llvm.coro.begin", th.getFunctionType(i8PtrTy, {tokenTy, i8PtrTy}));
+
+        auto promise = rewriter.create<LLVM::BitcastOp>(loc, i8PtrTy, transformed.promise());
+        auto nullPtr = rewriter.create<LLVM::NullOp>(loc, i8PtrTy);
+        auto coroId = rewriter.create<LLVM::CallOp>(
+            loc, coroIdFuncOp, ValueRange{clh.createI32ConstantOf(0), promise, nullPtr, nullPtr});
+        auto coroSize = rewriter.create<LLVM::CallOp>(loc, coroSizeFuncOp, ValueRange{});
+        auto frame = ch.MemoryAlloc(coroSize.getResult(0));
+
+        rewriter.replaceOpWithNewOp<LLVM::CallOp>(coroutineBeginOp, coroBeginFuncOp,
+                                                  ValueRange{coroId.getResult(0), frame});
+
+        return success();
+    }
+};
+
+struct CoroutineSuspendOpLowering : public TsLlvmPattern<mlir_ts::CoroutineSuspendOp>
+{
+    using TsLlvmPattern<mlir_ts::CoroutineSuspendOp>::TsLlvmPattern;
+
+    LogicalResult matchAndRewrite(mlir_ts::CoroutineSuspendOp coroutineSuspendOp, ArrayRef<mlir::Value> operands,
+                                  ConversionPatternRewriter &rewriter) const final
+    {
+        Adaptor transformed(operands);
+
+        TypeHelper th(rewriter);
+        LLVMCodeHelper ch(coroutineSuspendOp, rewriter, getTypeConverter());
+        CodeLogicHelper clh(coroutineSuspendOp, rewriter);
+
+        auto loc = coroutineSuspendOp->getLoc();
+
+        auto i8PtrTy = th.getI8PtrType();
+        auto tokenTy = LLVM::LLVMTokenType::get(rewriter.getContext());
+        auto isFinal = coroutineSuspendOp.final();
+
+        auto coroSaveFuncOp = ch.getOrInsertFunction("llvm.coro.save", th.getFunctionType(tokenTy, {i8PtrTy}));
+        auto coroSuspendFuncOp = ch.getOrInsertFunction(
+            "llvm.coro.suspend", th.getFunctionType(th.getI8Type(), {tokenTy, th.getLLVMBoolType()}));
+        auto coroEndFuncOp = ch.getOrInsertFunction(
+            "llvm.coro.end", th.getFunctionType(th.getLLVMBoolType(), {i8PtrTy, th.getLLVMBoolType()}));
+
+        auto handle = transformed.handle();
+        auto saveToken = rewriter.create<LLVM::CallOp>(loc, coroSaveFuncOp, ValueRange{handle});
+        auto suspendResult = rewriter.create<LLVM::CallOp>(
+            loc, coroSuspendFuncOp, ValueRange{saveToken.getResult(0), clh.createI1ConstantOf(isFinal)});
+        auto suspendResultI32 = rewriter.create<LLVM::SExtOp>(loc, th.getI32Type(), suspendResult.getResult(0));
+
+        rewriter.eraseOp(coroutineSuspendOp);
+
+        auto *opBlock = rewriter.getInsertionBlock();
+        auto *continuationBlock = clh.CutBlock();
+
+        // -1: coroutine is suspended, return control to the caller
+        auto *suspendBlock = rewriter.createBlock(continuationBlock);
+        rewriter.create<LLVM::CallOp>(loc, coroEndFuncOp, ValueRange{handle, clh.createI1ConstantOf(false)});
+        rewriter.create<LLVM::ReturnOp>(loc, ValueRange{});
+
+        // 1: coroutine is destroyed, nothing to clean up as frame is released by GC
+        auto *cleanupBlock = rewriter.createBlock(continuationBlock);
+        rewriter.create<mlir::BranchOp>(loc, suspendBlock);
+
+        // 0: coroutine is resumed, can't happen after final suspend
+        auto *resumeBlock = isFinal ? clh.FindUnreachableBlockOrCreate() : continuationBlock;
+
+        rewriter.setInsertionPointToEnd(opBlock);
+
+        SmallVector<int32_t> caseValues{0, 1};
+        SmallVector<mlir::Block *> caseDestinations{resumeBlock, cleanupBlock};
+        rewriter.create<LLVM::SwitchOp>(loc, suspendResultI32, suspendBlock, ValueRange{}, caseValues,
+                                        caseDestinations);
+
+        rewriter.setInsertionPointToStart(continuationBlock);
+
+        return success();
+    }
+};
+
+struct CoroutineResumeOpLowering : public TsLlvmPattern<mlir_ts::CoroutineResumeOp>
+{
+    using TsLlvmPattern<mlir_ts::CoroutineResumeOp>::TsLlvmPattern;
+
+    LogicalResult matchAndRewrite(mlir_ts::CoroutineResumeOp coroutineResumeOp, ArrayRef<mlir::Value> operands,
+                                  ConversionPatternRewriter &rewriter) const final
+    {
+        Adaptor transformed(operands);
+
+        TypeHelper th(rewriter);
+        LLVMCodeHelper ch(coroutineResumeOp, rewriter, getTypeConverter());
+
+        auto coroResumeFuncOp =
+            ch.getOrInsertFunction("llvm.coro.resume", th.getFunctionType({th.getI8PtrType()}));
+
+        rewriter.replaceOpWithNewOp<LLVM::CallOp>(coroutineResumeOp, coroResumeFuncOp,
+                                                  ValueRange{transformed.handle()});
+
+        return success();
+    }
+};
+
+struct CoroutineDoneOpLowering : public TsLlvmPattern<mlir_ts::CoroutineDoneOp>
+{
+    using TsLlvmPattern<mlir_ts::CoroutineDoneOp>::TsLlvmPattern;
+
+    LogicalResult matchAndRewrite(mlir_ts::CoroutineDoneOp coroutineDoneOp, ArrayRef<mlir::Value> operands,
+                                  ConversionPatternRewriter &rewriter) const final
+    {
+        Adaptor transformed(operands);
+
+        TypeHelper th(rewriter);
+        LLVMCodeHelper ch(coroutineDoneOp, rewriter, getTypeConverter());
+
+        auto coroDoneFuncOp = ch.getOrInsertFunction(
+            "llvm.coro.done", th.getFunctionType(th.getLLVMBoolType(), {th.getI8PtrType()}));
+
+        rewriter.replaceOpWithNewOp<LLVM::CallOp>(coroutineDoneOp, coroDoneFuncOp, ValueRange{transformed.handle()});
+
+        return success();
+    }
+};
+
+struct CoroutinePromiseOpLowering : public TsLlvmPattern<mlir_ts::CoroutinePromiseOp>
+{
+    using TsLlvmPattern<mlir_ts::CoroutinePromiseOp>::TsLlvmPattern;
+
+    LogicalResult matchAndRewrite(mlir_ts::CoroutinePromiseOp coroutinePromiseOp, ArrayRef<mlir::Value> operands,
+                                  ConversionPatternRewriter &rewriter) const final
+    {
+        Adaptor transformed(operands);
+
+        TypeHelper th(rewriter);
+        LLVMCodeHelper ch(coroutinePromiseOp, rewriter, getTypeConverter());
+        CodeLogicHelper clh(coroutinePromiseOp, rewriter);
+        TypeConverterHelper tch(getTypeConverter());
+
+        auto loc = coroutinePromiseOp->getLoc();
+
+        auto i8PtrTy = th.getI8PtrType();
+        auto coroPromiseFuncOp = ch.getOrInsertFunction(
+            "llvm.coro.promise", th.getFunctionType(i8PtrTy, {i8PtrTy, th.getI32Type(), th.getLLVMBoolType()}));
+
+        // alignment must be the same as alignment of promise alloca passed to llvm.coro.id
+        auto promiseRefType = tch.convertType(coroutinePromiseOp.getType());
+        auto promiseType = promiseRefType.cast<LLVM::LLVMPointerType>().getElementType();
+        LLVMTypeConverterHelper llvmtch(*(LLVMTypeConverter *)getTypeConverter());
+        auto alignment = llvmtch.getTypeAlignment(promiseType);
+
+        auto promise = rewriter.create<LLVM::CallOp>(
+            loc, coroPromiseFuncOp,
+            ValueRange{transformed.handle(), clh.createI32ConstantOf(alignment), clh.createI1ConstantOf(false)});
+
+        rewriter.replaceOpWithNewOp<LLVM::BitcastOp>(coroutinePromiseOp, promiseRefType, promise.getResult(0));
+
+        return success();
+    }
+};
+
+class SwitchInternalOpLowering : public TsLlvmPattern<mlir_ts::SwitchInternalOp>
+{
+  public:
+    using TsLlvmPattern<mlir_ts::SwitchInternalOp>::TsLlvmPattern;
+
+    LogicalResult matchAndRewrite(mlir_ts::SwitchInternalOp switchOp, ArrayRef<mlir::Value> operands,
+                                  ConversionPatternRewriter &rewriter) const final
+    {
+        Adaptor transformed(operands);
+
+        auto caseValuesAttr = switchOp.caseValues().getValues<int32_t>();
+        SmallVector<int32_t> caseValues(caseValuesAttr.begin(), caseValuesAttr.end());
+        SmallVector<mlir::Block *> caseDestinations(switchOp.caseDests().begin(), switchOp.caseDests().end());
+
+        rewriter.replaceOpWithNewOp<LLVM::SwitchOp>(switchOp, transformed.value(), switchOp.defaultDest(),
+                                                    ValueRange{}, caseValues, caseDestinations);
+
+        return success();
+    }
+};
+
 struct GlobalConstructorOpLowering : public TsLlvmPattern<mlir_ts::GlobalConstructorOp>
 {
     using TsLlvmPattern<mlir_ts::GlobalConstructorOp>::TsLlvmPattern;
@@ -4519,6 +4790,8 @@ static void populateTypeScriptConversionPatterns(LLVMTypeConverter &converter, m
         rtArrayType.push_back(LLVM::LLVMPointerType::get(converter.convertType(type.getElementType())));
         // field which store length of array
         rtArrayType.push_back(th.getI32Type());
+        // field which store capacity of array (0 when data is not owned by array)
+        rtArrayType.push_back(th.getI32Type());
 
         return LLVM::LLVMStructType::getLiteral(type.getContext(), rtArrayType, false);
     });
@@ -4713,7 +4986,8 @@ static void populateTypeScriptConversionPatterns(LLVMTypeConverter &converter, m
         SmallVector<mlir::Type> convertedTypes;
         if (needTag)
         {
-            convertedTypes.push_back(th.getI8PtrType());
+            // type id, see TypeIdLogicHelper
+            convertedTypes.push_back(th.getI32Type());
         }
 
         convertedTypes.push_back(selectedType);
@@ -4925,6 +5199,13 @@ void TypeScriptToLLVMLoweringPass::runOnOperation()
 
     // The only remaining operation to lower from the `typescript` dialect, is the PrintOp.
     TsLlvmContext tsLlvmContext{};
+    m.walk([&](mlir_ts::FuncOp funcOp) {
+        if (funcOp.isExternal())
+        {
+            tsLlvmContext.externalFunctions.insert(funcOp.getName());
+        }
+    });
+
     patterns.insert<
         AddressOfOpLowering, AddressOfConstStringOpLowering, ArithmeticUnaryOpLowering, ArithmeticBinaryOpLowering,
         AssertOpLowering, CastOpLowering, ConstantOpLowering, CreateOptionalOpLowering, UndefOptionalOpLowering,
@@ -4932,10 +5213,11 @@ void TypeScriptToLLVMLoweringPass::runOnOperation()
         FuncOpLowering, LoadOpLowering, ElementRefOpLowering, PropertyRefOpLowering, ExtractPropertyOpLowering,
         PointerOffsetRefOpLowering, LogicalBinaryOpLowering, NullOpLowering, NewOpLowering, CreateTupleOpLowering,
         DeconstructTupleOpLowering, CreateArrayOpLowering, NewEmptyArrayOpLowering, NewArrayOpLowering, PushOpLowering,
-        PopOpLowering, DeleteOpLowering, ParseFloatOpLowering, ParseIntOpLowering, IsNaNOpLowering, PrintOpLowering,
+        PopOpLowering, ReserveOpLowering, DeleteOpLowering, ParseFloatOpLowering, ParseIntOpLowering, IsNaNOpLowering,
+        PrintOpLowering,
         StoreOpLowering, SizeOfOpLowering, InsertPropertyOpLowering, LengthOfOpLowering, StringLengthOpLowering,
-        StringConcatOpLowering, StringCompareOpLowering, CharToStringOpLowering, UndefOpLowering, MemoryCopyOpLowering,
-        LoadSaveValueLowering, ThrowUnwindOpLowering, ThrowCallOpLowering, TrampolineOpLowering, VariableOpLowering,
+        StringConcatOpLowering, StringAppendOpLowering, StringCompareOpLowering, StringHashOpLowering,
+        CharToStringOpLowering, UndefOpLowering, MemoryCopyOpLowering, LoadSaveValueLowering, ThrowUnwindOpLowering, ThrowCallOpLowering, VariableOpLowering,
         AllocaOpLowering, InvokeOpLowering, InvokeHybridOpLowering, VirtualSymbolRefOpLowering,
         ThisVirtualSymbolRefOpLowering, InterfaceSymbolRefOpLowering, NewInterfaceOpLowering, VTableOffsetRefOpLowering,
         LoadBoundRefOpLowering, StoreBoundRefOpLowering, CreateBoundRefOpLowering, CreateBoundFunctionOpLowering,
@@ -4953,7 +5235,8 @@ void TypeScriptToLLVMLoweringPass::runOnOperation()
         SwitchStateOpLowering, StateLabelOpLowering, YieldReturnValOpLowering
 #endif
         ,
-        SwitchStateInternalOpLowering>(typeConverter, &getContext(), &tsLlvmContext);
+        SwitchStateInternalOpLowering, SwitchInternalOpLowering, CoroutineBeginOpLowering, CoroutineSuspendOpLowering,
+        CoroutineResumeOpLowering, CoroutineDoneOpLowering, CoroutinePromiseOpLowering>(typeConverter, &getContext(), &tsLlvmContext);
 
 #ifdef ENABLE_TYPED_GC
     patterns.insert<
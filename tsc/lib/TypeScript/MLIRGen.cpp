@@ -51,7 +51,10 @@
 #include "mlir/Dialect/Async/IR/Async.h"
 #endif
 
+#include "llvm/ADT/DenseSet.h"
+#include "llvm/ADT/MapVector.h"
 #include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/Sequence.h"
 #include "llvm/ADT/TypeSwitch.h"
 #include "llvm/Support/Debug.h"
 #include "llvm/Support/MemoryBuffer.h"
@@ -60,6 +63,7 @@
 
 #include <algorithm>
 #include <iterator>
+#include <limits>
 #include <numeric>
 
 using namespace ::typescript;
@@ -220,7 +224,7 @@ class MLIRGenImpl
             fullNameGenericInterfacesMap);
 
         if (mlir::succeeded(mlirDiscoverAllDependencies(module, includeFiles)) &&
-            mlir::succeeded(mlirCodeGenModule(module, includeFiles)))
+            mlir::succeeded(mlirGenClassIds()) && mlir::succeeded(mlirCodeGenModule(module, includeFiles)))
         {
             return theModule;
         }
@@ -360,6 +364,57 @@ class MLIRGenImpl
         return mlir::success();
     }
 
+    // number classes of module in preorder of hierarchy (all classes are known after discovery), so 'instanceof' can
+    // be checked by range of ids, see ClassInfo::classId
+    mlir::LogicalResult mlirGenClassIds()
+    {
+#ifdef ENABLE_RTTI
+        // ids of different modules overlap, address of internal marker tells which module class belongs to
+        {
+            mlir::OpBuilder::InsertionGuard guard(builder);
+            builder.setInsertionPointToStart(theModule.getBody());
+
+            SmallVector<mlir::NamedAttribute> attrs;
+            attrs.push_back(
+                {mlir::Identifier::get("Linkage", builder.getContext()), builder.getStringAttr("Internal")});
+            builder.create<mlir_ts::GlobalOp>(theModule.getLoc(), builder.getI8Type(), false, MODULE_MARKER_NAME,
+                                              builder.getI8IntegerAttr(0), attrs);
+        }
+
+        llvm::DenseMap<ClassInfo *, SmallVector<ClassInfo::TypePtr>> derivedClasses;
+        for (auto &classInfo : moduleClasses)
+        {
+            if (classInfo->isDeclaration || classInfo->baseClasses.size() != 1)
+            {
+                continue;
+            }
+
+            derivedClasses[classInfo->baseClasses.front().get()].push_back(classInfo);
+        }
+
+        auto nextId = 0;
+        std::function<void(ClassInfo::TypePtr)> numberClass = [&](ClassInfo::TypePtr classInfo) {
+            classInfo->classId = nextId++;
+            for (auto &derivedClass : derivedClasses[classInfo.get()])
+            {
+                numberClass(derivedClass);
+            }
+
+            classInfo->lastDescendantClassId = nextId - 1;
+        };
+
+        for (auto &classInfo : moduleClasses)
+        {
+            if (!classInfo->isDeclaration && classInfo->baseClasses.empty())
+            {
+                numberClass(classInfo);
+            }
+        }
+#endif
+
+        return mlir::success();
+    }
+
     mlir::LogicalResult mlirCodeGenModule(SourceFile module, std::vector<SourceFile> includeFiles = {},
                                           bool validate = true)
     {
@@ -1898,7 +1953,7 @@ class MLIRGenImpl
                 return mlir::failure();
             }
 
-            return resolveFunctionWithCapture(location, StringRef(funcSymbolName), funcType, false, false, genContext);
+            return resolveFunctionWithCapture(location, StringRef(funcSymbolName), funcType, false, genContext);
         }
 
         if (auto classOp = genResult.getDefiningOp<mlir_ts::ClassRefOp>())
@@ -3114,8 +3169,8 @@ class MLIRGenImpl
             {
                 auto genericFunctionInfo = getGenericFunctionMap().lookup(funcName);
                 // info: it will not take any capture now
-                return resolveFunctionWithCapture(location, genericFunctionInfo->name, genericFunctionInfo->funcType,
-                                                  false, true, genContext);
+                return resolveFunctionWithCapture(location, genericFunctionInfo->name, genericFunctionInfo->funcType, true,
+                                                  genContext);
             }
             else
             {
@@ -3128,7 +3183,7 @@ class MLIRGenImpl
             }
         }
 
-        return resolveFunctionWithCapture(location, funcOp.getName(), funcOp.getType(), false, false, genContext);
+        return resolveFunctionWithCapture(location, funcOp.getName(), funcOp.getType(), false, genContext);
     }
 
     ValueOrLogicalResult mlirGen(ArrowFunction arrowFunctionAST, const GenContext &genContext)
@@ -3166,8 +3221,8 @@ class MLIRGenImpl
             {
                 auto genericFunctionInfo = getGenericFunctionMap().lookup(funcName);
                 // info: it will not take any capture now
-                return resolveFunctionWithCapture(location, genericFunctionInfo->name, genericFunctionInfo->funcType,
-                                                  false, true, genContext);
+                return resolveFunctionWithCapture(location, genericFunctionInfo->name, genericFunctionInfo->funcType, true,
+                                                  genContext);
             }
             else
             {
@@ -3182,7 +3237,7 @@ class MLIRGenImpl
 
         assert(funcOp);
 
-        return resolveFunctionWithCapture(location, funcOp.getName(), funcOp.getType(), false, isGeneric, genContext);
+        return resolveFunctionWithCapture(location, funcOp.getName(), funcOp.getType(), isGeneric, genContext);
     }
 
     std::tuple<mlir::LogicalResult, mlir_ts::FuncOp, std::string, bool> mlirGenFunctionGenerator(
@@ -3214,6 +3269,15 @@ class MLIRGenImpl
 
         nextStatements.push_back(callStat);
 
+        if (compileOptions.generatorsAsCoroutines)
+        {
+            // coroutine keeps position of 'yield' itself, step only tells that generator is started
+            auto setStartedStat = nf.createExpressionStatement(nf.createBinaryExpression(
+                nf.createPropertyAccessExpression(nf.createToken(SyntaxKind::ThisKeyword), stepIdent),
+                nf.createToken(SyntaxKind::EqualsToken), nf.createNumericLiteral(S("1"), TokenFlags::None)));
+            nextStatements.push_back(setStartedStat);
+        }
+
         // add function body to statements to first step
         if (functionLikeDeclarationBaseAST->body == SyntaxKind::Block)
         {
@@ -3241,7 +3305,11 @@ class MLIRGenImpl
         auto nextMethodDecl =
             nf.createMethodDeclaration(undefined, undefined, undefined, nf.createIdentifier(S("next")), undefined,
                                        undefined, undefined, undefined, nextBody);
-        nextMethodDecl->internalFlags |= InternalFlags::VarsInObjectContext;
+        if (!compileOptions.generatorsAsCoroutines)
+        {
+            // local variables of coroutine are kept in its frame
+            nextMethodDecl->internalFlags |= InternalFlags::VarsInObjectContext;
+        }
 
         // copy location info, to fix issue with names of anonymous functions
         nextMethodDecl->pos = functionLikeDeclarationBaseAST->pos;
@@ -3955,6 +4023,21 @@ class MLIRGenImpl
         return mlirGen(forOfStat, genContext);
     }
 
+    // current insertion point is in 'try' of current function
+    bool isInsideTry()
+    {
+        for (auto *op = builder.getInsertionBlock()->getParentOp(); op && !isa<mlir_ts::FuncOp>(op);
+             op = op->getParentOp())
+        {
+            if (isa<mlir_ts::TryOp>(op))
+            {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
     ValueOrLogicalResult mlirGen(YieldExpression yieldExpressionAST, const GenContext &genContext)
     {
         if (yieldExpressionAST->asteriskToken)
@@ -3964,6 +4047,13 @@ class MLIRGenImpl
 
         auto location = loc(yieldExpressionAST);
 
+        // landing pads of 'try' are not restored when coroutine is resumed
+        if (compileOptions.generatorsAsCoroutines && isInsideTry())
+        {
+            emitError(location) << "'yield' inside of 'try' is not supported with --coroutines";
+            return mlir::failure();
+        }
+
         if (genContext.passResult)
         {
             genContext.passResult->functionReturnTypeShouldBeProvided = true;
@@ -3986,12 +4076,16 @@ class MLIRGenImpl
 
         NodeFactory nf(NodeFactoryFlags::None);
 
-        // save return point - state
-        auto setStateExpr = nf.createBinaryExpression(
-            nf.createPropertyAccessExpression(nf.createToken(SyntaxKind::ThisKeyword), nf.createIdentifier(S("step"))),
-            nf.createToken(SyntaxKind::EqualsToken), nf.createNumericLiteral(num.str(), TokenFlags::None));
+        // save return point - state (coroutine saves it in its frame)
+        if (!compileOptions.generatorsAsCoroutines)
+        {
+            auto setStateExpr = nf.createBinaryExpression(
+                nf.createPropertyAccessExpression(nf.createToken(SyntaxKind::ThisKeyword),
+                                                  nf.createIdentifier(S("step"))),
+                nf.createToken(SyntaxKind::EqualsToken), nf.createNumericLiteral(num.str(), TokenFlags::None));
 
-        mlirGen(setStateExpr, genContext);
+            mlirGen(setStateExpr, genContext);
+        }
 
         // return value
         auto yieldRetValue = getYieldReturnObject(nf, yieldExpressionAST->expression, false);
@@ -4904,6 +4998,7 @@ class MLIRGenImpl
                                           SmallVector<mlir::CondBranchOp> &pendingConditions,
                                           SmallVector<mlir::BranchOp> &pendingBranches,
                                           mlir::Operation *&previousConditionOrFirstBranchOp,
+                                          SmallVector<std::pair<mlir::Value, mlir::CondBranchOp>> &caseConditions,
                                           std::function<void(Expression, mlir::Value)> extraCode,
                                           const GenContext &genContext)
     {
@@ -4984,6 +5079,7 @@ class MLIRGenImpl
             previousConditionOrFirstBranchOp = condBranchOp;
 
             pendingConditions.push_back(condBranchOp);
+            caseConditions.push_back({caseValue, condBranchOp});
         }
         else if (isDefaultAsFirstCase)
         {
@@ -5067,6 +5163,208 @@ class MLIRGenImpl
         return mlir::success();
     }
 
+    // FNV-1a hash of string, the same hash is computed by ts.StringHash
+    static int32_t getStringHash(StringRef str)
+    {
+        uint32_t hash = 2166136261u;
+        for (unsigned char c : str)
+        {
+            hash ^= c;
+            hash *= 16777619u;
+        }
+
+        return (int32_t)hash;
+    }
+
+    // when all cases are constants of the same type the chain of compares is replaced with one multiway branch:
+    //  - integer cases: branch by value of switch to case, compare of case is removed
+    //  - number cases with integer values: branch by value of switch converted to integer when it is in range of i32,
+    //    compare of case is kept (value can have fraction) and jumps to default
+    //  - string cases: branch by hash of value of switch to first case with the same hash, compare of case is kept
+    //    and jumps to next case with the same hash (or to default)
+    void mlirGenSwitchDispatch(mlir::Location location, mlir::Value switchValue, mlir_ts::SwitchOp switchOp,
+                               ArrayRef<std::pair<mlir::Value, mlir::CondBranchOp>> caseConditions,
+                               const GenContext &genContext)
+    {
+        enum
+        {
+            falseIndex = 1
+        };
+
+        if (caseConditions.size() < MIN_CASES_TO_DISPATCH_SWITCH)
+        {
+            return;
+        }
+
+        mlir::Type caseType;
+        SmallVector<mlir::Attribute> caseAttrs;
+        for (auto &caseCondition : caseConditions)
+        {
+            auto constantOp = caseCondition.first.getDefiningOp<mlir_ts::ConstantOp>();
+            if (!constantOp)
+            {
+                return;
+            }
+
+            auto constType = mth.stripLiteralType(constantOp.getType());
+            if (caseType && caseType != constType)
+            {
+                return;
+            }
+
+            caseType = constType;
+            caseAttrs.push_back(constantOp.getValue());
+        }
+
+        auto isStringCase = caseType.isa<mlir_ts::StringType>();
+        auto isNumberCase = caseType.isa<mlir_ts::NumberType>();
+        if (!isStringCase && !isNumberCase && !caseType.isInteger(32))
+        {
+            return;
+        }
+
+        if (isNumberCase && !llvm::all_of(caseAttrs, [](mlir::Attribute caseAttr) {
+                auto value = caseAttr.cast<mlir::FloatAttr>().getValue();
+                auto doubleValue = caseAttr.cast<mlir::FloatAttr>().getValueAsDouble();
+                return value.isInteger() && doubleValue >= std::numeric_limits<int32_t>::min() &&
+                       doubleValue <= std::numeric_limits<int32_t>::max();
+            }))
+        {
+            return;
+        }
+
+        // typeof of union is compared with cases by tag of union which is cheaper than hash of string
+        if (auto typeOfOp = switchValue.getDefiningOp<mlir_ts::TypeOfOp>())
+        {
+            if (typeOfOp.value().getType().isa<mlir_ts::UnionType>())
+            {
+                return;
+            }
+        }
+
+        // the last case jumps to default or to exit of switch
+        auto *fallbackBlock = caseConditions.back().second.getFalseDest();
+
+        mlir::OpBuilder::InsertionGuard guard(builder);
+
+        auto &casesRegion = switchOp.casesRegion();
+        auto *firstBlock = &casesRegion.front();
+        builder.createBlock(&casesRegion, casesRegion.begin());
+
+        // value is converted into type of cases the same way as in compare of case
+        auto switchValueEffective = cast(location, caseType, switchValue, genContext);
+
+        SmallVector<int32_t> caseValues;
+        SmallVector<mlir::Block *> caseDests;
+        if (isStringCase)
+        {
+            auto hashValue = builder.create<mlir_ts::StringHashOp>(location, builder.getI32Type(), switchValueEffective);
+
+            llvm::MapVector<int32_t, SmallVector<mlir::CondBranchOp>> casesByHash;
+            for (auto it : llvm::zip(caseAttrs, caseConditions))
+            {
+                auto hash = getStringHash(std::get<0>(it).cast<mlir::StringAttr>().getValue());
+                casesByHash[hash].push_back(std::get<1>(it).second);
+            }
+
+            for (auto &hashCases : casesByHash)
+            {
+                auto &condBranchOps = hashCases.second;
+                for (auto index : llvm::seq<size_t>(0, condBranchOps.size()))
+                {
+                    auto *nextDest =
+                        index + 1 < condBranchOps.size() ? condBranchOps[index + 1]->getBlock() : fallbackBlock;
+                    condBranchOps[index]->setSuccessor(nextDest, falseIndex);
+                }
+
+                caseValues.push_back(hashCases.first);
+                caseDests.push_back(condBranchOps.front()->getBlock());
+            }
+
+            builder.create<mlir_ts::SwitchInternalOp>(location, hashValue, builder.getI32VectorAttr(caseValues),
+                                                      fallbackBlock, caseDests);
+        }
+        else if (isNumberCase)
+        {
+            llvm::SmallDenseSet<int32_t> knownValues;
+            for (auto it : llvm::zip(caseAttrs, caseConditions))
+            {
+                auto condBranchOp = std::get<1>(it).second;
+                condBranchOp->setSuccessor(fallbackBlock, falseIndex);
+
+                auto caseValue = (int32_t)std::get<0>(it).cast<mlir::FloatAttr>().getValueAsDouble();
+                if (knownValues.insert(caseValue).second)
+                {
+                    caseValues.push_back(caseValue);
+                    caseDests.push_back(condBranchOp->getBlock());
+                }
+            }
+
+            // conversion of value out of range of i32 (or NaN) to integer is undefined, such value is not equal to
+            // any case
+            auto floatType = caseAttrs.front().cast<mlir::FloatAttr>().getType();
+            auto compareWith = [&](SyntaxKind opCode, double bound) {
+                auto boundValue = builder.create<mlir_ts::ConstantOp>(location, caseType,
+                                                                      builder.getFloatAttr(floatType, bound));
+                auto condition = builder.create<mlir_ts::LogicalBinaryOp>(
+                    location, getBooleanType(), builder.getI32IntegerAttr((int)opCode), switchValueEffective,
+                    boundValue);
+                return cast(location, builder.getI1Type(), condition, genContext);
+            };
+
+            auto *checkUpperBlock = builder.createBlock(firstBlock);
+            auto *dispatchBlock = builder.createBlock(firstBlock);
+
+            builder.setInsertionPointToEnd(&casesRegion.front());
+            builder.create<mlir::CondBranchOp>(
+                location, compareWith(SyntaxKind::GreaterThanEqualsToken, std::numeric_limits<int32_t>::min()),
+                checkUpperBlock, fallbackBlock);
+
+            builder.setInsertionPointToEnd(checkUpperBlock);
+            builder.create<mlir::CondBranchOp>(
+                location, compareWith(SyntaxKind::LessThanToken, -(double)std::numeric_limits<int32_t>::min()),
+                dispatchBlock, fallbackBlock);
+
+            builder.setInsertionPointToEnd(dispatchBlock);
+            auto intValue = cast(location, builder.getI32Type(), switchValueEffective, genContext);
+            builder.create<mlir_ts::SwitchInternalOp>(location, intValue, builder.getI32VectorAttr(caseValues),
+                                                      fallbackBlock, caseDests);
+        }
+        else
+        {
+            llvm::SmallDenseSet<int32_t> knownValues;
+            for (auto it : llvm::zip(caseAttrs, caseConditions))
+            {
+                auto condBranchOp = std::get<1>(it).second;
+                auto caseValue = (int32_t)std::get<0>(it).cast<mlir::IntegerAttr>().getInt();
+                // the first case with the value is selected as in compares one by one
+                if (knownValues.insert(caseValue).second)
+                {
+                    caseValues.push_back(caseValue);
+                    caseDests.push_back(condBranchOp->getBlock());
+                }
+            }
+
+            builder.create<mlir_ts::SwitchInternalOp>(location, switchValueEffective,
+                                                      builder.getI32VectorAttr(caseValues), fallbackBlock, caseDests);
+
+            for (auto &caseCondition : caseConditions)
+            {
+                auto condBranchOp = caseCondition.second;
+                builder.setInsertionPoint(condBranchOp);
+                builder.create<mlir::BranchOp>(location, condBranchOp.getTrueDest());
+                condBranchOp->erase();
+            }
+        }
+
+        // jump to first case (when 'default' is the first clause) is not used anymore
+        if (firstBlock->hasNoPredecessors() && llvm::hasSingleElement(*firstBlock) &&
+            isa<mlir::BranchOp>(firstBlock->front()))
+        {
+            firstBlock->erase();
+        }
+    }
+
     mlir::LogicalResult mlirGen(SwitchStatement switchStatementAST, const GenContext &genContext)
     {
         SymbolTableScopeT varScope(symbolTable);
@@ -5095,6 +5393,7 @@ class MLIRGenImpl
         SmallVector<mlir::BranchOp> pendingBranches;
         mlir::Operation *previousConditionOrFirstBranchOp = nullptr;
         mlir::Block *defaultBlock = nullptr;
+        SmallVector<std::pair<mlir::Value, mlir::CondBranchOp>> caseConditions;
 
         // to support safe cast
         std::function<void(Expression, mlir::Value)> safeCastLogic;
@@ -5127,12 +5426,15 @@ class MLIRGenImpl
         {
             if (mlir::failed(mlirGenSwitchCase(location, switchExpr, switchValue, clauses, index, mergeBlock,
                                                defaultBlock, pendingConditions, pendingBranches,
-                                               previousConditionOrFirstBranchOp, safeCastLogic, switchGenContext)))
+                                               previousConditionOrFirstBranchOp, caseConditions, safeCastLogic,
+                                               switchGenContext)))
             {
                 return mlir::failure();
             }
         }
 
+        mlirGenSwitchDispatch(location, switchValue, switchOp, caseConditions, switchGenContext);
+
         LLVM_DEBUG(llvm::dbgs() << "\n!! SWITCH: " << switchOp << "\n");
 
         return mlir::success();
@@ -5619,6 +5921,57 @@ class MLIRGenImpl
         return mlirGen(callLogic, genContext);
     }
 
+#ifdef ENABLE_RTTI
+    // id of class of object is in range of ids of classInfo and its descendants, objects without id or of other module
+    // (class is declared in other module etc.) are checked by RTTI method
+    mlir::Value mlirGenInstanceOfByClassId(mlir::Location location, mlir::Value thisPtrValue, ClassInfo::TypePtr classInfo,
+                                           mlir::function_ref<mlir::Value(mlir::OpBuilder &, mlir::Location)> fallback)
+    {
+        // get VTable we can use VTableOffset
+        auto vtablePtr =
+            builder.create<mlir_ts::VTableOffsetRefOp>(location, getOpaqueType(), thisPtrValue, 0 /*VTABLE index*/);
+
+        // class id is 0 index in vtable
+        auto classIdPtr =
+            builder.create<mlir_ts::VTableOffsetRefOp>(location, getOpaqueType(), vtablePtr, 0 /*ClassId index*/);
+        auto classIdValue = builder.create<mlir_ts::CastOp>(location, builder.getI32Type(), classIdPtr);
+
+        auto compareClassId = [&](mlir::OpBuilder &builder, mlir::Location location, SyntaxKind opCode, int value) {
+            auto valueConst =
+                builder.create<mlir_ts::ConstantOp>(location, builder.getI32Type(), builder.getI32IntegerAttr(value));
+            return builder.create<mlir_ts::LogicalBinaryOp>(location, getBooleanType(),
+                                                            builder.getI32IntegerAttr((int)opCode), classIdValue,
+                                                            valueConst);
+        };
+
+        // ids are unique only inside of module, module of class is 1 index in vtable
+        auto classModulePtr =
+            builder.create<mlir_ts::VTableOffsetRefOp>(location, getOpaqueType(), vtablePtr, 1 /*ClassModule index*/);
+        auto moduleMarkerPtr = builder.create<mlir_ts::AddressOfOp>(location, getOpaqueType(), MODULE_MARKER_NAME,
+                                                                     ::mlir::IntegerAttr());
+        auto sameModule = builder.create<mlir_ts::LogicalBinaryOp>(
+            location, getBooleanType(), builder.getI32IntegerAttr((int)SyntaxKind::EqualsEqualsToken), classModulePtr,
+            moduleMarkerPtr);
+        auto hasClassId = builder.create<mlir_ts::ArithmeticBinaryOp>(
+            location, getBooleanType(), builder.getI32IntegerAttr((int)SyntaxKind::AmpersandToken), sameModule,
+            compareClassId(builder, location, SyntaxKind::GreaterThanEqualsToken, 0));
+
+        MLIRCodeLogicHelper mclh(builder, location);
+        return mclh.conditionalExpression(
+            getBooleanType(), hasClassId,
+            [&](mlir::OpBuilder &builder, mlir::Location location) {
+                auto afterFirst =
+                    compareClassId(builder, location, SyntaxKind::GreaterThanEqualsToken, classInfo->classId);
+                auto beforeLast =
+                    compareClassId(builder, location, SyntaxKind::LessThanEqualsToken, classInfo->lastDescendantClassId);
+                return builder.create<mlir_ts::ArithmeticBinaryOp>(
+                    location, getBooleanType(), builder.getI32IntegerAttr((int)SyntaxKind::AmpersandToken), afterFirst,
+                    beforeLast);
+            },
+            fallback);
+    }
+#endif
+
     ValueOrLogicalResult mlirGenInstanceOfLogic(BinaryExpression binaryExpressionAST, const GenContext &genContext)
     {
         auto location = loc(binaryExpressionAST);
@@ -5660,7 +6013,18 @@ class MLIRGenImpl
                 NodeFactory nf(NodeFactoryFlags::None);
                 NodeArray<Expression> argumentsArray;
                 argumentsArray.push_back(nf.createIdentifier(stows(fullNameClassRtti.str())));
-                return mlirGenCallThisMethod(location, result, INSTANCEOF_NAME, undefined, argumentsArray, genContext);
+                if (classInfo->classId < 0)
+                {
+                    return mlirGenCallThisMethod(location, result, INSTANCEOF_NAME, undefined, argumentsArray,
+                                                 genContext);
+                }
+
+                auto thisPtrValue = cast(location, getOpaqueType(), result, genContext);
+                return mlirGenInstanceOfByClassId(
+                    location, thisPtrValue, classInfo, [&](mlir::OpBuilder &builder, mlir::Location location) {
+                        return V(mlirGenCallThisMethod(location, result, INSTANCEOF_NAME, undefined, argumentsArray,
+                                                       genContext));
+                    });
             }
 
             if (resultType.isa<mlir_ts::AnyType>())
@@ -5678,30 +6042,39 @@ class MLIRGenImpl
                     [&](mlir::OpBuilder &builder, mlir::Location location) {
                         auto thisPtrValue = cast(location, getOpaqueType(), result, genContext);
 
-                        // get VTable we can use VTableOffset
-                        auto vtablePtr = builder.create<mlir_ts::VTableOffsetRefOp>(location, getOpaqueType(),
-                                                                                    thisPtrValue, 0 /*VTABLE index*/);
+                        auto callInstanceOfMethod = [&](mlir::OpBuilder &builder, mlir::Location location) {
+                            // get VTable we can use VTableOffset
+                            auto vtablePtr = builder.create<mlir_ts::VTableOffsetRefOp>(
+                                location, getOpaqueType(), thisPtrValue, 0 /*VTABLE index*/);
+
+                            // get InstanceOf method, this is 2 index in vtable (after class id and its module)
+                            auto instanceOfPtr = builder.create<mlir_ts::VTableOffsetRefOp>(
+                                location, getOpaqueType(), vtablePtr, 2 /*InstanceOf index*/);
 
-                        // get InstanceOf method, this is 0 index in vtable
-                        auto instanceOfPtr = builder.create<mlir_ts::VTableOffsetRefOp>(
-                            location, getOpaqueType(), vtablePtr, 0 /*InstanceOf index*/);
+                            auto rttiOfClassValue =
+                                resolveFullNameIdentifier(location, fullNameClassRtti, false, genContext);
 
-                        auto rttiOfClassValue =
-                            resolveFullNameIdentifier(location, fullNameClassRtti, false, genContext);
+                            assert(rttiOfClassValue);
 
-                        assert(rttiOfClassValue);
+                            auto instanceOfFuncType = mlir_ts::FunctionType::get(
+                                builder.getContext(), SmallVector<mlir::Type>{getOpaqueType(), getStringType()},
+                                SmallVector<mlir::Type>{getBooleanType()});
 
-                        auto instanceOfFuncType = mlir_ts::FunctionType::get(
-                            builder.getContext(), SmallVector<mlir::Type>{getOpaqueType(), getStringType()},
-                            SmallVector<mlir::Type>{getBooleanType()});
+                            auto funcPtr = cast(location, instanceOfFuncType, instanceOfPtr, genContext);
 
-                        auto funcPtr = cast(location, instanceOfFuncType, instanceOfPtr, genContext);
+                            // call methos, we need to send, this, and rtti info
+                            auto callResult = builder.create<mlir_ts::CallIndirectOp>(
+                                location, funcPtr, mlir::ValueRange{thisPtrValue, rttiOfClassValue});
 
-                        // call methos, we need to send, this, and rtti info
-                        auto callResult = builder.create<mlir_ts::CallIndirectOp>(
-                            location, funcPtr, mlir::ValueRange{thisPtrValue, rttiOfClassValue});
+                            return callResult.getResult(0);
+                        };
+
+                        if (classInfo->classId < 0)
+                        {
+                            return callInstanceOfMethod(builder, location);
+                        }
 
-                        return callResult.getResult(0);
+                        return mlirGenInstanceOfByClassId(location, thisPtrValue, classInfo, callInstanceOfMethod);
                     },
                     [&](mlir::OpBuilder &builder, mlir::Location location) { // default false value
                                                                              // compare typeOfValue
@@ -6119,6 +6492,26 @@ class MLIRGenImpl
             }
 
             break;
+        case SyntaxKind::AmpersandToken:
+        case SyntaxKind::BarToken:
+        case SyntaxKind::CaretToken:
+            // operands of 'number' are converted to 32-bit integers, x | 0 is integer
+            if (leftExpressionValue.getType() == getNumberType() || rightExpressionValue.getType() == getNumberType())
+            {
+                if (leftExpressionValue.getType() != builder.getI32Type())
+                {
+                    leftExpressionValue = cast(leftLoc, builder.getI32Type(), leftExpressionValue, genContext);
+                }
+
+                if (rightExpressionValue.getType() != builder.getI32Type())
+                {
+                    rightExpressionValue = cast(rightLoc, builder.getI32Type(), rightExpressionValue, genContext);
+                }
+
+                break;
+            }
+
+            // other types are the same as in default
         default:
             auto resultType = leftExpressionValue.getType();
             if (rightExpressionValue.getType().isa<mlir_ts::StringType>())
@@ -6947,6 +7340,13 @@ class MLIRGenImpl
 
     ValueOrLogicalResult mlirGen(CallExpression callExpression, const GenContext &genContext)
     {
+        // a.map(f).filter(g).reduce(h, 0) is generated as one loop over 'a'
+        SmallVector<CallExpression> chain;
+        if (getArrayMethodChain(callExpression, chain))
+        {
+            return mlirGenArrayMethodChain(chain, genContext);
+        }
+
         auto location = loc(callExpression);
 
         auto callExpr = callExpression->expression.as<Expression>();
@@ -6955,6 +7355,12 @@ class MLIRGenImpl
         EXIT_IF_FAILED_OR_NO_VALUE(result)
         auto funcResult = V(result);
 
+        return mlirGenCallExpression(location, funcResult, callExpression, genContext);
+    }
+
+    ValueOrLogicalResult mlirGenCallExpression(mlir::Location location, mlir::Value funcResult,
+                                               CallExpression callExpression, const GenContext &genContext)
+    {
         LLVM_DEBUG(llvm::dbgs() << "\n!! evaluate function: " << funcResult << "\n";);
 
         SmallVector<mlir::Value, 4> operands;
@@ -6978,249 +7384,408 @@ class MLIRGenImpl
         return mlirGenCallExpression(location, funcResult, callExpression->typeArguments, operands, genContext);
     }
 
-    mlir::LogicalResult mlirGenArrayForEach(mlir::Location location, ArrayRef<mlir::Value> operands,
-                                            const GenContext &genContext)
+    // collects calls of array methods in order of execution, only 'map' and 'filter' can be followed by other call
+    bool getArrayMethodChain(CallExpression callExpression, SmallVector<CallExpression> &chain)
     {
-        SymbolTableScopeT varScope(symbolTable);
-
-        auto arraySrc = operands[0];
-        auto funcSrc = operands[1];
-
-        // register vals
-        auto srcArrayVarDecl = std::make_shared<VariableDeclarationDOM>("_src_array_", arraySrc.getType(), location);
-        declare(srcArrayVarDecl, arraySrc, genContext);
-
-        auto funcVarDecl = std::make_shared<VariableDeclarationDOM>("_func_", funcSrc.getType(), location);
-        declare(funcVarDecl, funcSrc, genContext);
+        auto current = callExpression;
+        while (true)
+        {
+            auto callee = current->expression;
+            if (current->questionDotToken || current->typeArguments || callee != SyntaxKind::PropertyAccessExpression)
+            {
+                break;
+            }
 
-        NodeFactory nf(NodeFactoryFlags::None);
+            auto propertyAccessExpression = callee.as<PropertyAccessExpression>();
+            if (propertyAccessExpression->questionDotToken)
+            {
+                break;
+            }
 
-        auto _src_array_ident = nf.createIdentifier(S("_src_array_"));
-        auto _func_ident = nf.createIdentifier(S("_func_"));
+            auto name = MLIRHelper::getName(propertyAccessExpression->name);
+            if (!MLIRCodeLogic::isArrayCustomMethod(name))
+            {
+                break;
+            }
 
-        auto _v_ident = nf.createIdentifier(S("_v_"));
+            if (chain.size() > 0 && name != "map" && name != "filter")
+            {
+                break;
+            }
 
-        NodeArray<VariableDeclaration> declarations;
-        declarations.push_back(nf.createVariableDeclaration(_v_ident));
-        auto declList = nf.createVariableDeclarationList(declarations, NodeFlags::Const);
+            if (current->arguments.size() != (name == "reduce" ? 2u : 1u))
+            {
+                break;
+            }
 
-        NodeArray<Expression> argumentsArray;
-        argumentsArray.push_back(_v_ident);
+            chain.insert(chain.begin(), current);
 
-        auto forOfStat = nf.createForOfStatement(
-            undefined, declList, _src_array_ident,
-            nf.createExpressionStatement(nf.createCallExpression(_func_ident, undefined, argumentsArray)));
+            auto next = propertyAccessExpression->expression;
+            if (next != SyntaxKind::CallExpression)
+            {
+                break;
+            }
 
-        mlirGen(forOfStat, genContext);
+            current = next.as<CallExpression>();
+        }
 
-        return mlir::success();
+        return chain.size() > 0;
     }
 
-    ValueOrLogicalResult mlirGenArrayEvery(mlir::Location location, ArrayRef<mlir::Value> operands,
-                                           const GenContext &genContext)
+    // expression can't change state which is visible outside of it and can't read state changed by others: it has no
+    // calls, no assignments and no property access except 'length' (it can be getter)
+    bool isSideEffectFree(Expression expression)
     {
-        SymbolTableScopeT varScope(symbolTable);
-
-        auto varName = "_ev_";
-        auto initVal = builder.create<mlir_ts::ConstantOp>(location, getBooleanType(), builder.getBoolAttr(true));
-        registerVariable(
-            location, varName, false, VariableClass::Let,
-            [&]() -> std::pair<mlir::Type, mlir::Value> {
-                return {getBooleanType(), initVal};
-            },
-            genContext);
+        auto sideEffect = false;
+        auto check = [&](Node node) {
+            switch ((SyntaxKind)node)
+            {
+            case SyntaxKind::CallExpression:
+            case SyntaxKind::NewExpression:
+            case SyntaxKind::TaggedTemplateExpression:
+            case SyntaxKind::DeleteExpression:
+            case SyntaxKind::YieldExpression:
+            case SyntaxKind::AwaitExpression:
+            case SyntaxKind::PostfixUnaryExpression:
+                sideEffect = true;
+                break;
+            case SyntaxKind::PrefixUnaryExpression: {
+                auto opCode = node.as<PrefixUnaryExpression>()->_operator;
+                sideEffect |= opCode == SyntaxKind::PlusPlusToken || opCode == SyntaxKind::MinusMinusToken;
+                break;
+            }
+            case SyntaxKind::BinaryExpression:
+                sideEffect |= isAssignmentOperator(node.as<BinaryExpression>()->operatorToken);
+                break;
+            case SyntaxKind::PropertyAccessExpression:
+                sideEffect |= MLIRHelper::getName(node.as<PropertyAccessExpression>()->name) != "length";
+                break;
+            default:
+                break;
+            }
+        };
 
-        auto arraySrc = operands[0];
-        auto funcSrc = operands[1];
+        check(expression);
+        VisitorAST visitor(check);
+        visitor.visit(expression);
+        return !sideEffect;
+    }
 
-        // register vals
-        auto srcArrayVarDecl = std::make_shared<VariableDeclarationDOM>("_src_array_", arraySrc.getType(), location);
-        declare(srcArrayVarDecl, arraySrc, genContext);
+    struct ArrayMethodCall
+    {
+        StringRef name;
+        SmallVector<mlir::Value, 4> operands;
+        // type of values passed to next call of chain
+        mlir::Type elementType;
+    };
 
-        auto funcVarDecl = std::make_shared<VariableDeclarationDOM>("_func_", funcSrc.getType(), location);
-        declare(funcVarDecl, funcSrc, genContext);
+    // 'map' changes type of values to return type of callback, other methods pass values as is
+    mlir::Type getArrayMethodElementType(mlir::Location location, mlir::Type srcElementType,
+                                         const ArrayMethodCall &call)
+    {
+        if (call.name != "map")
+        {
+            return srcElementType;
+        }
 
-        NodeFactory nf(NodeFactoryFlags::None);
+        auto elementType = getReturnTypeFromFuncRef(call.operands.front().getType());
+        if (!elementType)
+        {
+            emitError(location) << "callback of 'map' must return value";
+            return mlir::Type();
+        }
 
-        auto _src_array_ident = nf.createIdentifier(S("_src_array_"));
-        auto _func_ident = nf.createIdentifier(S("_func_"));
+        return mth.wideStorageType(elementType);
+    }
 
-        auto _v_ident = nf.createIdentifier(S("_v_"));
-        auto _result_ident = nf.createIdentifier(stows(varName));
+    ValueOrLogicalResult mlirGenArrayMethodChain(SmallVector<CallExpression> &chain, const GenContext &genContext)
+    {
+        auto location = loc(chain.back());
 
-        NodeArray<VariableDeclaration> declarations;
-        declarations.push_back(nf.createVariableDeclaration(_v_ident));
-        auto declList = nf.createVariableDeclarationList(declarations, NodeFlags::Const);
+        auto firstCallee = chain.front()->expression.as<PropertyAccessExpression>();
+        auto result = mlirGen(firstCallee->expression.as<Expression>(), genContext);
+        EXIT_IF_FAILED_OR_NO_VALUE(result)
+        auto arraySrc = V(result);
 
-        NodeArray<Expression> argumentsArray;
-        argumentsArray.push_back(_v_ident);
+        if (arraySrc.getType().isa<mlir_ts::ConstArrayType>())
+        {
+            arraySrc = builder.create<mlir_ts::CastOp>(
+                location, mth.convertConstArrayTypeToArrayType(arraySrc.getType()), arraySrc);
+        }
 
-        auto forOfStat = nf.createForOfStatement(
-            undefined, declList, _src_array_ident,
-            nf.createIfStatement(
-                nf.createPrefixUnaryExpression(
-                    nf.createToken(SyntaxKind::ExclamationToken),
-                    nf.createBinaryExpression(_result_ident, nf.createToken(SyntaxKind::AmpersandAmpersandEqualsToken),
-                                              nf.createCallExpression(_func_ident, undefined, argumentsArray))),
-                nf.createBreakStatement(), undefined));
+        auto arrayType = arraySrc.getType().dyn_cast<mlir_ts::ArrayType>();
+        if (!arrayType)
+        {
+            // not an array, call methods one by one
+            for (auto callExpression : chain)
+            {
+                auto callee = callExpression->expression.as<PropertyAccessExpression>();
+                auto name = MLIRHelper::getName(callee->name, stringAllocator);
+                auto funcResult = mlirGenPropertyAccessExpression(loc(callee), arraySrc, name, genContext);
+                EXIT_IF_FAILED_OR_NO_VALUE(funcResult)
 
-        mlirGen(forOfStat, genContext);
+                auto callResult =
+                    mlirGenCallExpression(loc(callExpression), V(funcResult), callExpression, genContext);
+                if (callExpression == chain.back())
+                {
+                    return callResult;
+                }
 
-        return resolveIdentifier(location, varName, genContext);
-    }
+                EXIT_IF_FAILED_OR_NO_VALUE(callResult)
+                arraySrc = V(callResult);
+            }
 
-    ValueOrLogicalResult mlirGenArraySome(mlir::Location location, ArrayRef<mlir::Value> operands,
-                                          const GenContext &genContext)
-    {
-        SymbolTableScopeT varScope(symbolTable);
+            llvm_unreachable("chain can't be empty");
+        }
 
-        auto varName = "_sm_";
-        auto initVal = builder.create<mlir_ts::ConstantOp>(location, getBooleanType(), builder.getBoolAttr(false));
-        registerVariable(
-            location, varName, false, VariableClass::Let,
-            [&]() -> std::pair<mlir::Type, mlir::Value> {
-                return {getBooleanType(), initVal};
-            },
-            genContext);
+        // fused stages call callbacks per element instead of stage by stage, it is not visible only when callbacks
+        // have no side effects (body of callback passed by name is not known)
+        auto fuse = llvm::all_of(chain, [&](CallExpression callExpression) {
+            auto callback = callExpression->arguments.front();
+            return (callback == SyntaxKind::ArrowFunction || callback == SyntaxKind::FunctionExpression) &&
+                   llvm::all_of(callExpression->arguments, [&](Expression arg) { return isSideEffectFree(arg); });
+        });
 
-        auto arraySrc = operands[0];
-        auto funcSrc = operands[1];
+        SmallVector<ArrayMethodCall> calls;
+        auto elementType = arrayType.getElementType();
+        for (auto callExpression : chain)
+        {
+            auto callee = callExpression->expression.as<PropertyAccessExpression>();
+            auto name = MLIRHelper::getName(callee->name, stringAllocator);
+            auto methodLocation = loc(callExpression);
 
-        // register vals
-        auto srcArrayVarDecl = std::make_shared<VariableDeclarationDOM>("_src_array_", arraySrc.getType(), location);
-        declare(srcArrayVarDecl, arraySrc, genContext);
+            mlir::Type accumulatorType;
+            if (name == "reduce")
+            {
+                accumulatorType = evaluate(callExpression->arguments[1], genContext);
+                if (accumulatorType)
+                {
+                    accumulatorType = mth.wideStorageType(accumulatorType);
+                }
+                else
+                {
+                    if (!genContext.allowPartialResolve)
+                    {
+                        emitError(methodLocation) << "can't resolve type of initial value of 'reduce'";
+                    }
 
-        auto funcVarDecl = std::make_shared<VariableDeclarationDOM>("_func_", funcSrc.getType(), location);
-        declare(funcVarDecl, funcSrc, genContext);
+                    return mlir::failure();
+                }
+            }
 
-        NodeFactory nf(NodeFactoryFlags::None);
+            auto funcType = MLIRCodeLogic::getArrayCustomMethodType(builder.getContext(), name, elementType,
+                                                                    accumulatorType);
 
-        auto _src_array_ident = nf.createIdentifier(S("_src_array_"));
-        auto _func_ident = nf.createIdentifier(S("_func_"));
+            ArrayMethodCall call{name};
+            if (mlir::failed(mlirGenOperands(callExpression->arguments, call.operands, funcType, genContext)))
+            {
+                if (!genContext.allowPartialResolve)
+                {
+                    emitError(methodLocation) << "Call Method: can't resolve values of all parameters";
+                }
 
-        auto _v_ident = nf.createIdentifier(S("_v_"));
-        auto _result_ident = nf.createIdentifier(stows(varName));
+                return mlir::failure();
+            }
 
-        NodeArray<VariableDeclaration> declarations;
-        declarations.push_back(nf.createVariableDeclaration(_v_ident));
-        auto declList = nf.createVariableDeclarationList(declarations, NodeFlags::Const);
+            elementType = call.elementType = getArrayMethodElementType(methodLocation, elementType, call);
+            if (!elementType)
+            {
+                return mlir::failure();
+            }
 
-        NodeArray<Expression> argumentsArray;
-        argumentsArray.push_back(_v_ident);
+            calls.push_back(call);
 
-        auto forOfStat = nf.createForOfStatement(
-            undefined, declList, _src_array_ident,
-            nf.createIfStatement(
-                nf.createBinaryExpression(_result_ident, nf.createToken(SyntaxKind::BarBarEqualsToken),
-                                          nf.createCallExpression(_func_ident, undefined, argumentsArray)),
-                nf.createBreakStatement(), undefined));
+            if (!fuse)
+            {
+                // result of each stage is materialized before arguments of next one are evaluated
+                auto stageResult = mlirGenArrayMethodLoop(methodLocation, arraySrc, calls, genContext);
+                if (callExpression == chain.back())
+                {
+                    return stageResult;
+                }
 
-        mlirGen(forOfStat, genContext);
+                EXIT_IF_FAILED_OR_NO_VALUE(stageResult)
+                arraySrc = V(stageResult);
+                elementType = arraySrc.getType().cast<mlir_ts::ArrayType>().getElementType();
+                calls.clear();
+            }
+        }
 
-        return resolveIdentifier(location, varName, genContext);
+        return mlirGenArrayMethodLoop(location, arraySrc, calls, genContext);
     }
 
-    ValueOrLogicalResult mlirGenArrayMap(mlir::Location location, ArrayRef<mlir::Value> operands,
-                                         const GenContext &genContext)
+    // generates:
+    //   let _r_ = [] | init | true | false;
+    //   for (const _v0_ of _src_array_) { const _v1_ = _f0_(_v0_); if (_f1_(_v1_)) { _r_.push(_v1_); } }
+    ValueOrLogicalResult mlirGenArrayMethodLoop(mlir::Location location, mlir::Value arraySrc,
+                                                ArrayRef<ArrayMethodCall> calls, const GenContext &genContext)
     {
         SymbolTableScopeT varScope(symbolTable);
 
-        auto arraySrc = operands[0];
-        auto funcSrc = operands[1];
+        auto elementType = calls.back().elementType;
+        auto lastName = calls.back().name;
+        auto resultName = "_r_";
+        mlir::Value initVal;
+        if (lastName == "map" || lastName == "filter")
+        {
+            SmallVector<mlir::Value> emptyArrayValues;
+            initVal = builder.create<mlir_ts::CreateArrayOp>(location, getArrayType(elementType), emptyArrayValues);
+        }
+        else if (lastName == "reduce")
+        {
+            initVal = calls.back().operands[1];
+        }
+        else if (lastName == "every" || lastName == "some")
+        {
+            initVal = builder.create<mlir_ts::ConstantOp>(location, getBooleanType(),
+                                                          builder.getBoolAttr(lastName == "every"));
+        }
+
+        if (initVal)
+        {
+            registerVariable(
+                location, resultName, false, VariableClass::Let,
+                [&]() -> std::pair<mlir::Type, mlir::Value> {
+                    return {initVal.getType(), initVal};
+                },
+                genContext);
+        }
+
+        // result of 'map' has the same size as source array
+        if (llvm::all_of(calls, [](auto &call) { return call.name == "map"; }))
+        {
+            MLIRCodeLogic mcl(builder);
+            if (auto resultRef = mcl.GetReferenceOfLoadOp(resolveIdentifier(location, resultName, genContext)))
+            {
+                auto length = builder.create<mlir_ts::LengthOfOp>(location, builder.getI32Type(), arraySrc);
+                builder.create<mlir_ts::ReserveOp>(location, resultRef, length);
+            }
+        }
 
         // register vals
         auto srcArrayVarDecl = std::make_shared<VariableDeclarationDOM>("_src_array_", arraySrc.getType(), location);
         declare(srcArrayVarDecl, arraySrc, genContext);
 
-        auto funcVarDecl = std::make_shared<VariableDeclarationDOM>("_func_", funcSrc.getType(), location);
-        declare(funcVarDecl, funcSrc, genContext);
+        for (auto indexedCall : llvm::enumerate(calls))
+        {
+            auto funcName = "_f" + std::to_string(indexedCall.index()) + "_";
+            auto funcSrc = indexedCall.value().operands.front();
+            auto funcVarDecl = std::make_shared<VariableDeclarationDOM>(funcName, funcSrc.getType(), location);
+            declare(funcVarDecl, funcSrc, genContext);
+        }
 
         NodeFactory nf(NodeFactoryFlags::None);
 
-        auto _src_array_ident = nf.createIdentifier(S("_src_array_"));
-        auto _func_ident = nf.createIdentifier(S("_func_"));
-
-        auto _v_ident = nf.createIdentifier(S("_v_"));
-
-        NodeArray<VariableDeclaration> declarations;
-        declarations.push_back(nf.createVariableDeclaration(_v_ident));
-        auto declList = nf.createVariableDeclarationList(declarations, NodeFlags::Const);
-
-        NodeArray<Expression> argumentsArray;
-        argumentsArray.push_back(_v_ident);
-
-        auto forOfStat =
-            nf.createForOfStatement(undefined, declList, _src_array_ident,
-                                    nf.createExpressionStatement(nf.createYieldExpression(
-                                        undefined, nf.createCallExpression(_func_ident, undefined, argumentsArray))));
-
-        // iterator
-        NodeArray<Statement> statements;
-        statements.push_back(forOfStat);
-        auto block = nf.createBlock(statements, false);
-        auto funcIter =
-            nf.createFunctionExpression(undefined, nf.createToken(SyntaxKind::AsteriskToken),
-                                        nf.createIdentifier(S("_iter_")), undefined, undefined, undefined, block);
-        funcIter->pos.pos = 1;
-        funcIter->_end = 2;
-
-        // call
-        NodeArray<Expression> emptyArguments;
-        auto callOfIter = nf.createCallExpression(funcIter, undefined, emptyArguments);
-
-        return mlirGen(callOfIter, genContext);
-    }
-
-    ValueOrLogicalResult mlirGenArrayFilter(mlir::Location location, ArrayRef<mlir::Value> operands,
-                                            const GenContext &genContext)
-    {
-        SymbolTableScopeT varScope(symbolTable);
-
-        auto arraySrc = operands[0];
-        auto funcSrc = operands[1];
+        auto _result_ident = nf.createIdentifier(stows(resultName));
+        auto ident = [&](StringRef prefix, int index) {
+            return nf.createIdentifier(stows(prefix.str() + std::to_string(index) + "_"));
+        };
+        auto callFunc = [&](int index, Expression arg, Expression arg2 = undefined) {
+            NodeArray<Expression> argumentsArray;
+            argumentsArray.push_back(arg);
+            if (arg2)
+            {
+                argumentsArray.push_back(arg2);
+            }
 
-        // register vals
-        auto srcArrayVarDecl = std::make_shared<VariableDeclarationDOM>("_src_array_", arraySrc.getType(), location);
-        declare(srcArrayVarDecl, arraySrc, genContext);
+            return nf.createCallExpression(ident("_f", index), undefined, argumentsArray);
+        };
+        auto setResultAndBreak = [&](SyntaxKind value) {
+            NodeArray<Statement> statements;
+            statements.push_back(nf.createExpressionStatement(nf.createBinaryExpression(
+                _result_ident, nf.createToken(SyntaxKind::EqualsToken), nf.createToken<PrimaryExpression>(value))));
+            statements.push_back(nf.createBreakStatement());
+            return nf.createBlock(statements, true);
+        };
 
-        auto funcVarDecl = std::make_shared<VariableDeclarationDOM>("_func_", funcSrc.getType(), location);
-        declare(funcVarDecl, funcSrc, genContext);
+        // body of loop, from last call to first one
+        Statement body;
+        auto valueIndex = llvm::count_if(calls, [](auto &call) { return call.name == "map"; });
+        if (lastName == "map" || lastName == "filter")
+        {
+            NodeArray<Expression> argumentsArray;
+            argumentsArray.push_back(ident("_v", valueIndex));
+            body = nf.createExpressionStatement(nf.createCallExpression(
+                nf.createPropertyAccessExpression(_result_ident, nf.createIdentifier(S("push"))), undefined,
+                argumentsArray));
+        }
 
-        NodeFactory nf(NodeFactoryFlags::None);
+        for (auto index = (int)calls.size() - 1; index >= 0; index--)
+        {
+            auto name = calls[index].name;
+            if (name == "map")
+            {
+                valueIndex--;
 
-        auto _src_array_ident = nf.createIdentifier(S("_src_array_"));
-        auto _func_ident = nf.createIdentifier(S("_func_"));
+                NodeArray<VariableDeclaration> declarations;
+                declarations.push_back(nf.createVariableDeclaration(ident("_v", valueIndex + 1), undefined, undefined,
+                                                                    callFunc(index, ident("_v", valueIndex))));
 
-        auto _v_ident = nf.createIdentifier(S("_v_"));
+                NodeArray<Statement> statements;
+                statements.push_back(nf.createVariableStatement(
+                    undefined, nf.createVariableDeclarationList(declarations, NodeFlags::Const)));
+                statements.push_back(body);
+                body = nf.createBlock(statements, true);
+            }
+            else if (name == "filter")
+            {
+                body = nf.createIfStatement(callFunc(index, ident("_v", valueIndex)), body, undefined);
+            }
+            else if (name == "reduce")
+            {
+                body = nf.createExpressionStatement(
+                    nf.createBinaryExpression(_result_ident, nf.createToken(SyntaxKind::EqualsToken),
+                                              callFunc(index, _result_ident, ident("_v", valueIndex))));
+            }
+            else if (name == "forEach")
+            {
+                body = nf.createExpressionStatement(callFunc(index, ident("_v", valueIndex)));
+            }
+            else if (name == "every")
+            {
+                body = nf.createIfStatement(
+                    nf.createPrefixUnaryExpression(nf.createToken(SyntaxKind::ExclamationToken),
+                                                   callFunc(index, ident("_v", valueIndex))),
+                    setResultAndBreak(SyntaxKind::FalseKeyword), undefined);
+            }
+            else if (name == "some")
+            {
+                body = nf.createIfStatement(callFunc(index, ident("_v", valueIndex)),
+                                            setResultAndBreak(SyntaxKind::TrueKeyword), undefined);
+            }
+        }
 
         NodeArray<VariableDeclaration> declarations;
-        declarations.push_back(nf.createVariableDeclaration(_v_ident));
+        declarations.push_back(nf.createVariableDeclaration(ident("_v", 0)));
         auto declList = nf.createVariableDeclarationList(declarations, NodeFlags::Const);
 
-        NodeArray<Expression> argumentsArray;
-        argumentsArray.push_back(_v_ident);
+        auto forOfStat = nf.createForOfStatement(undefined, declList, nf.createIdentifier(S("_src_array_")), body);
+        if (mlir::failed(mlirGen(forOfStat, genContext)))
+        {
+            return mlir::failure();
+        }
 
-        auto forOfStat = nf.createForOfStatement(
-            undefined, declList, _src_array_ident,
-            nf.createIfStatement(nf.createCallExpression(_func_ident, undefined, argumentsArray),
-                                 nf.createExpressionStatement(nf.createYieldExpression(undefined, _v_ident)),
-                                 undefined));
-
-        // iterator
-        NodeArray<Statement> statements;
-        statements.push_back(forOfStat);
-        auto block = nf.createBlock(statements, false);
-        auto funcIter =
-            nf.createFunctionExpression(undefined, nf.createToken(SyntaxKind::AsteriskToken),
-                                        nf.createIdentifier(S("_iter_")), undefined, undefined, undefined, block);
-        funcIter->pos.pos = 1;
-        funcIter->_end = 2;
+        if (!initVal)
+        {
+            return mlir::success();
+        }
 
-        // call
-        NodeArray<Expression> emptyArguments;
-        auto callOfIter = nf.createCallExpression(funcIter, undefined, emptyArguments);
+        return resolveIdentifier(location, resultName, genContext);
+    }
+
+    ValueOrLogicalResult mlirGenArrayMethod(mlir::Location location, StringRef name, ArrayRef<mlir::Value> operands,
+                                            const GenContext &genContext)
+    {
+        ArrayMethodCall call{name};
+        call.operands.append(operands.begin() + 1, operands.end());
+        call.elementType = getArrayMethodElementType(
+            location, operands.front().getType().cast<mlir_ts::ArrayType>().getElementType(), call);
+        if (!call.elementType)
+        {
+            return mlir::failure();
+        }
 
-        return mlirGen(callOfIter, genContext);
+        return mlirGenArrayMethodLoop(location, operands.front(), {call}, genContext);
     }
 
     ValueOrLogicalResult mlirGenArrayReduce(mlir::Location location, SmallVector<mlir::Value, 4> &operands,
@@ -7283,28 +7848,27 @@ class MLIRGenImpl
             // temp hack
             if (functionName == "__array_foreach")
             {
-                mlirGenArrayForEach(location, operands, genContext);
-                return mlir::success();
+                return mlirGenArrayMethod(location, "forEach", operands, genContext);
             }
 
             if (functionName == "__array_every")
             {
-                return mlirGenArrayEvery(location, operands, genContext);
+                return mlirGenArrayMethod(location, "every", operands, genContext);
             }
 
             if (functionName == "__array_some")
             {
-                return mlirGenArraySome(location, operands, genContext);
+                return mlirGenArrayMethod(location, "some", operands, genContext);
             }
 
             if (functionName == "__array_map")
             {
-                return mlirGenArrayMap(location, operands, genContext);
+                return mlirGenArrayMethod(location, "map", operands, genContext);
             }
 
             if (functionName == "__array_filter")
             {
-                return mlirGenArrayFilter(location, operands, genContext);
+                return mlirGenArrayMethod(location, "filter", operands, genContext);
             }
 
             if (functionName == "__array_reduce")
@@ -7312,6 +7876,17 @@ class MLIRGenImpl
                 return mlirGenArrayReduce(location, operands, genContext);
             }
 
+            if (functionName == "switchstate" && compileOptions.generatorsAsCoroutines)
+            {
+                // field of generator object to keep handle of coroutine between calls of 'next'
+                auto result = registerVariableInThisContext(location, "_coro_", getOpaqueType(), genContext);
+                EXIT_IF_FAILED(result)
+                if (auto coroutineRef = V(result))
+                {
+                    operands.push_back(coroutineRef);
+                }
+            }
+
             // resolve function
             MLIRCustomMethods cm(builder, location);
             return cm.callMethod(functionName, operands, genContext);
@@ -8490,6 +9065,24 @@ class MLIRGenImpl
 
                 auto loadedVarArray = builder.create<mlir_ts::LoadOp>(location, arrType, varArray);
 
+                // allocate memory for all elements at once
+                mlir::Value count = builder.create<mlir_ts::ConstantOp>(
+                    location, builder.getI32Type(),
+                    builder.getI32IntegerAttr(llvm::count_if(values, [](auto &val) { return !std::get<2>(val); })));
+                for (auto val : values)
+                {
+                    if (std::get<2>(val))
+                    {
+                        auto length =
+                            builder.create<mlir_ts::LengthOfOp>(location, builder.getI32Type(), std::get<1>(val));
+                        count = builder.create<mlir_ts::ArithmeticBinaryOp>(
+                            location, builder.getI32Type(), builder.getI32IntegerAttr((int)SyntaxKind::PlusToken),
+                            count, length);
+                    }
+                }
+
+                builder.create<mlir_ts::ReserveOp>(location, varArray, count);
+
                 // TODO: push every element into array
                 for (auto val : values)
                 {
@@ -9081,8 +9674,7 @@ class MLIRGenImpl
     }
 
     mlir::Value resolveFunctionWithCapture(mlir::Location location, StringRef name, mlir_ts::FunctionType funcType,
-                                           bool allocTrampolineInHeap, bool addGenericAttrFlag,
-                                           const GenContext &genContext)
+                                           bool addGenericAttrFlag, const GenContext &genContext)
     {
         // check if required capture of vars
         auto captureVars = getCaptureVarsMap().find(name);
@@ -9133,7 +9725,7 @@ class MLIRGenImpl
             auto funcType = funcOp.getType();
             auto funcName = funcOp.getName();
 
-            return resolveFunctionWithCapture(location, funcName, funcType, false, false, genContext);
+            return resolveFunctionWithCapture(location, funcName, funcType, false, genContext);
         }
 
         return mlir::Value();
@@ -9777,7 +10369,7 @@ class MLIRGenImpl
         mlirGenClassDefaultConstructor(classDeclarationAST, newClassPtr, classGenContext);
 
 #ifdef ENABLE_RTTI
-        // INFO: .instanceOf must be first element in VTable for Cast Any
+        // INFO: .instanceOf must be first method in VTable (after class id) for Cast Any
         mlirGenClassInstanceOfMethod(classDeclarationAST, newClassPtr, classGenContext);
 #endif
 
@@ -9939,6 +10531,7 @@ class MLIRGenImpl
 
             getClassesMap().insert({namePtr, newClassPtr});
             fullNameClassesMap.insert(fullNamePtr, newClassPtr);
+            moduleClasses.push_back(newClassPtr);
         }
 
         return newClassPtr;
@@ -10799,7 +11392,7 @@ genContext);
             // TODO: you adding new member to the same DOM(parse) instance but it is used for 2 instances of generic
             // type ERROR: do not change members!!!!
 
-            // INFO: .instanceOf must be first element in VTable for Cast Any
+            // INFO: .instanceOf must be first method in VTable (after class id) for Cast Any
             for (auto member : newClassPtr->extraMembers)
             {
                 assert(member == SyntaxKind::Constructor);
@@ -11241,7 +11834,7 @@ genContext);
         llvm::SmallVector<mlir_ts::FieldInfo> fields;
         for (auto vtableRecord : virtualTable)
         {
-            if (vtableRecord.isInterfaceVTable)
+            if (vtableRecord.isInterfaceVTable || vtableRecord.isClassId || vtableRecord.isClassModule)
             {
                 fields.push_back({mcl.TupleFieldName(vtableRecord.methodInfo.name), getOpaqueType()});
             }
@@ -11317,6 +11910,26 @@ genContext);
                             location, virtTuple, interfaceVTableValueAsAny, vtableValue,
                             builder.getArrayAttr(mth.getStructIndexAttrValue(fieldIndex++)));
                     }
+                    else if (vtRecord.isClassId)
+                    {
+                        // value itself is stored in vtable
+                        auto classIdValue = builder.create<mlir_ts::ConstantOp>(
+                            location, builder.getI32Type(), builder.getI32IntegerAttr(newClassPtr->classId));
+                        auto classIdValueAsAny = builder.create<mlir_ts::CastOp>(location, getOpaqueType(), classIdValue);
+
+                        vtableValue = builder.create<mlir_ts::InsertPropertyOp>(
+                            location, virtTuple, classIdValueAsAny, vtableValue,
+                            builder.getArrayAttr(mth.getStructIndexAttrValue(fieldIndex++)));
+                    }
+                    else if (vtRecord.isClassModule)
+                    {
+                        auto moduleMarkerPtr = builder.create<mlir_ts::AddressOfOp>(
+                            location, getOpaqueType(), MODULE_MARKER_NAME, ::mlir::IntegerAttr());
+
+                        vtableValue = builder.create<mlir_ts::InsertPropertyOp>(
+                            location, virtTuple, moduleMarkerPtr, vtableValue,
+                            builder.getArrayAttr(mth.getStructIndexAttrValue(fieldIndex++)));
+                    }
                     else
                     {
                         mlir::Value methodOrFieldNameRef;
@@ -14624,6 +15237,9 @@ genContext);
 
     llvm::ScopedHashTable<StringRef, ClassInfo::TypePtr> fullNameClassesMap;
 
+    // all classes in order of registration, to number them
+    llvm::SmallVector<ClassInfo::TypePtr> moduleClasses;
+
     llvm::ScopedHashTable<StringRef, GenericClassInfo::TypePtr> fullNameGenericClassesMap;
 
     llvm::ScopedHashTable<StringRef, InterfaceInfo::TypePtr> fullNameInterfacesMap;
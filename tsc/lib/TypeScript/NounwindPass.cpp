@@ -0,0 +1,177 @@
+#define DEBUG_TYPE "pass"
+
+#include "mlir/Pass/Pass.h"
+
+#include "TypeScript/Config.h"
+#include "TypeScript/Defines.h"
+#include "TypeScript/TypeScriptDialect.h"
+#include "TypeScript/TypeScriptOps.h"
+#include "TypeScript/Passes.h"
+#include "TypeScript/TypeScriptModulePass.h"
+
+#include "mlir/IR/BuiltinOps.h"
+#include "mlir/IR/SymbolTable.h"
+#include "mlir/Interfaces/CallInterfaces.h"
+
+#include "llvm/ADT/DenseSet.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/Support/Debug.h"
+#include "llvm/Support/raw_ostream.h"
+
+namespace mlir_ts = mlir::typescript;
+
+namespace
+{
+
+// Function can not throw when it has no ts.Throw and calls only functions which can not throw. Accessors are calls of
+// their getter and setter. Calls of unknown targets (declarations, function values, virtual calls) and resuming of
+// coroutines may throw. Runtime functions are
+// called by LLVM calls created in lowering of their ops (ts.Print, ts.ParseInt etc.), they never unwind.
+//
+// Set is computed optimistically: all functions with bodies are assumed to be nounwind and functions which may throw
+// are removed until nothing changes, so recursive functions without throws stay nounwind.
+//
+// Functions and calls of them are marked with __nounwind, calls inside of 'try' are lowered to plain calls instead of
+// invokes and LLVM functions get 'nounwind' attribute.
+class NounwindPass : public mlir::PassWrapper<NounwindPass, TypeScriptModulePass>
+{
+    llvm::DenseSet<mlir::Operation *> nounwindFuncs;
+
+  public:
+    void runOnModule() override
+    {
+        auto module = getModule();
+
+        mlir::SymbolTable symbolTable(module);
+
+        llvm::SmallVector<mlir_ts::FuncOp> funcs;
+        module.walk([&](mlir_ts::FuncOp funcOp) {
+            if (!funcOp.isExternal())
+            {
+                funcs.push_back(funcOp);
+                nounwindFuncs.insert(funcOp);
+            }
+        });
+
+        auto changed = true;
+        while (changed)
+        {
+            changed = false;
+            for (auto funcOp : funcs)
+            {
+                if (nounwindFuncs.count(funcOp) && mayThrow(funcOp, symbolTable))
+                {
+                    nounwindFuncs.erase(funcOp);
+                    changed = true;
+                }
+            }
+        }
+
+        auto unitAttr = mlir::UnitAttr::get(module.getContext());
+        for (auto funcOp : funcs)
+        {
+            if (!nounwindFuncs.count(funcOp))
+            {
+                continue;
+            }
+
+            LLVM_DEBUG(llvm::dbgs() << "\n!! nounwind: " << funcOp.getName() << "\n";);
+
+            funcOp->setAttr(NOUNWIND_ATTR_NAME, unitAttr);
+        }
+
+        module.walk([&](mlir::Operation *op) {
+            if ((isa<mlir_ts::CallOp>(op) || isa<mlir_ts::CallIndirectOp>(op)) &&
+                nounwindFuncs.count(getCallee(op, symbolTable)))
+            {
+                op->setAttr(NOUNWIND_ATTR_NAME, unitAttr);
+            }
+        });
+    }
+
+  private:
+    bool mayThrow(mlir_ts::FuncOp funcOp, mlir::SymbolTable &symbolTable)
+    {
+        auto result = funcOp.walk([&](mlir::Operation *op) {
+            if (isa<mlir_ts::ThrowOp>(op) || isa<mlir_ts::CoroutineResumeOp>(op))
+            {
+                return mlir::WalkResult::interrupt();
+            }
+
+            if (isa<mlir::CallOpInterface>(op) && !nounwindFuncs.count(getCallee(op, symbolTable)))
+            {
+                return mlir::WalkResult::interrupt();
+            }
+
+            // accessors are lowered into calls of getter or setter
+            if (auto accessorOp = dyn_cast<mlir_ts::AccessorOp>(op))
+            {
+                if (mayThrow(accessorOp.getAccessorAttr(), accessorOp.setAccessorAttr(), symbolTable))
+                {
+                    return mlir::WalkResult::interrupt();
+                }
+            }
+            else if (auto thisAccessorOp = dyn_cast<mlir_ts::ThisAccessorOp>(op))
+            {
+                if (mayThrow(thisAccessorOp.getAccessorAttr(), thisAccessorOp.setAccessorAttr(), symbolTable))
+                {
+                    return mlir::WalkResult::interrupt();
+                }
+            }
+
+            return mlir::WalkResult::advance();
+        });
+
+        return result.wasInterrupted();
+    }
+
+    bool mayThrow(mlir::FlatSymbolRefAttr getAccessorAttr, mlir::FlatSymbolRefAttr setAccessorAttr,
+                  mlir::SymbolTable &symbolTable)
+    {
+        for (auto accessorAttr : {getAccessorAttr, setAccessorAttr})
+        {
+            if (accessorAttr &&
+                !nounwindFuncs.count(symbolTable.lookup<mlir_ts::FuncOp>(accessorAttr.getValue())))
+            {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    // function called by ts.Call or by ts.CallIndirect of symbol reference, null if target is not known
+    mlir::Operation *getCallee(mlir::Operation *op, mlir::SymbolTable &symbolTable)
+    {
+        mlir::FlatSymbolRefAttr calleeAttr;
+        if (auto callOp = dyn_cast<mlir_ts::CallOp>(op))
+        {
+            calleeAttr = callOp.calleeAttr();
+        }
+        else if (auto callIndirectOp = dyn_cast<mlir_ts::CallIndirectOp>(op))
+        {
+            if (auto symbolRefOp = callIndirectOp.getCallee().getDefiningOp<mlir_ts::SymbolRefOp>())
+            {
+                calleeAttr = symbolRefOp.identifierAttr();
+            }
+            else if (auto thisSymbolRefOp = callIndirectOp.getCallee().getDefiningOp<mlir_ts::ThisSymbolRefOp>())
+            {
+                calleeAttr = thisSymbolRefOp.identifierAttr();
+            }
+        }
+
+        if (!calleeAttr)
+        {
+            return nullptr;
+        }
+
+        return symbolTable.lookup<mlir_ts::FuncOp>(calleeAttr.getValue());
+    }
+};
+} // end anonymous namespace
+
+/// Create a pass to mark functions which can not throw as nounwind.
+std::unique_ptr<mlir::Pass> mlir_ts::createNounwindPass()
+{
+    return std::make_unique<NounwindPass>();
+}
@@ -0,0 +1,363 @@
+#define DEBUG_TYPE "pass"
+
+#include "mlir/Pass/Pass.h"
+
+#include "TypeScript/Config.h"
+#include "TypeScript/Defines.h"
+#include "TypeScript/Passes.h"
+#include "TypeScript/TypeScriptModulePass.h"
+
+#include "TypeScript/LowerToLLVM/TypeHelper.h"
+
+#include "mlir/Dialect/LLVMIR/LLVMDialect.h"
+#include "mlir/IR/BuiltinOps.h"
+
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/Support/Debug.h"
+#include "llvm/Support/raw_ostream.h"
+
+using namespace ::typescript;
+namespace mlir_ts = mlir::typescript;
+
+namespace
+{
+
+// 'print' is lowered into calls of OUTPUT_WRITE_NAME (chars and number of chars) and OUTPUT_LINE_NAME, failed
+// 'assert' calls OUTPUT_FLUSH_NAME. The pass defines declared functions:
+//  - write: chars are copied into buffer, when they do not fit buffer is flushed and chars are written directly
+//  - line: flushes buffer when output is line buffered, does nothing otherwise
+//  - flush: writes content of buffer into stdout
+// and flushes buffer before 'main' returns and before exception is thrown (uncaught exception terminates process
+// without calling exit handlers). Module without 'main' registers flush with 'atexit' when buffer is used first time.
+// Buffer is not synchronized, so when module runs code in threads of async runtime output is written directly.
+// Only 'write' of C runtime is called, so it works in AOT and JIT modes.
+class OutputBufferPass : public mlir::PassWrapper<OutputBufferPass, TypeScriptModulePass>
+{
+    bool lineBuffered;
+
+  public:
+    OutputBufferPass(bool lineBuffered) : lineBuffered(lineBuffered)
+    {
+    }
+
+    void runOnModule() override
+    {
+        auto module = getModule();
+
+        auto writeFuncOp = module.lookupSymbol<LLVM::LLVMFuncOp>(OUTPUT_WRITE_NAME);
+        auto lineFuncOp = module.lookupSymbol<LLVM::LLVMFuncOp>(OUTPUT_LINE_NAME);
+        auto flushFuncOp = module.lookupSymbol<LLVM::LLVMFuncOp>(OUTPUT_FLUSH_NAME);
+        if (!writeFuncOp && !lineFuncOp && !flushFuncOp)
+        {
+            return;
+        }
+
+        mlir::OpBuilder builder(module.getBody(), module.getBody()->begin());
+        TypeHelper th(module.getContext());
+        auto loc = module.getLoc();
+
+        if (usesAsyncRuntime())
+        {
+            defineUnbuffered(builder, writeFuncOp, lineFuncOp, flushFuncOp);
+            return;
+        }
+
+        auto bufferType = th.getArrayType(th.getI8Type(), OUTPUT_BUFFER_SIZE);
+        auto bufferOp = builder.create<LLVM::GlobalOp>(loc, bufferType, false, LLVM::Linkage::Internal,
+                                                       "__ts_output_buffer", mlir::Attribute());
+        {
+            mlir::OpBuilder::InsertionGuard guard(builder);
+            builder.createBlock(&bufferOp.getInitializerRegion());
+            builder.create<LLVM::ReturnOp>(loc, ValueRange{builder.create<LLVM::UndefOp>(loc, bufferType)});
+        }
+
+        auto lengthOp = builder.create<LLVM::GlobalOp>(loc, th.getI64Type(), false, LLVM::Linkage::Internal,
+                                                       "__ts_output_length", builder.getI64IntegerAttr(0));
+
+        flushFuncOp = flushFuncOp ? replaceDeclaration(builder, flushFuncOp)
+                                  : builder.create<LLVM::LLVMFuncOp>(
+                                        loc, OUTPUT_FLUSH_NAME,
+                                        th.getFunctionType(th.getVoidType(), ArrayRef<mlir::Type>{}),
+                                        LLVM::Linkage::Internal);
+        defineFlush(builder, flushFuncOp, bufferOp, lengthOp);
+
+        auto mainFuncOp = module.lookupSymbol<LLVM::LLVMFuncOp>(MAIN_ENTRY_NAME);
+
+        if (writeFuncOp)
+        {
+            LLVM::GlobalOp registeredOp;
+            if (!mainFuncOp)
+            {
+                registeredOp = builder.create<LLVM::GlobalOp>(loc, th.getLLVMBoolType(), false, LLVM::Linkage::Internal,
+                                                              "__ts_output_registered",
+                                                              builder.getIntegerAttr(builder.getI1Type(), 0));
+            }
+
+            defineWrite(builder, replaceDeclaration(builder, writeFuncOp), flushFuncOp, bufferOp, lengthOp,
+                        registeredOp);
+        }
+
+        if (lineFuncOp)
+        {
+            defineLine(builder, replaceDeclaration(builder, lineFuncOp), flushFuncOp);
+        }
+
+        llvm::SmallVector<mlir::Operation *> flushBeforeOps;
+        if (mainFuncOp)
+        {
+            mainFuncOp.walk([&](LLVM::ReturnOp returnOp) { flushBeforeOps.push_back(returnOp); });
+        }
+
+        module.walk([&](mlir::Operation *op) {
+            if (isThrowCall(op))
+            {
+                flushBeforeOps.push_back(op);
+            }
+        });
+
+        for (auto op : flushBeforeOps)
+        {
+            builder.setInsertionPoint(op);
+            builder.create<LLVM::CallOp>(op->getLoc(), flushFuncOp, ValueRange{});
+        }
+    }
+
+    bool usesAsyncRuntime()
+    {
+#ifdef ENABLE_ASYNC
+        for (auto funcOp : getModule().getOps<LLVM::LLVMFuncOp>())
+        {
+            if (funcOp.getName().startswith("mlirAsyncRuntime"))
+            {
+                return true;
+            }
+        }
+#endif
+
+        return false;
+    }
+
+    // write goes straight to stdout, line and flush have nothing to do
+    void defineUnbuffered(mlir::OpBuilder &builder, LLVM::LLVMFuncOp writeFuncOp, LLVM::LLVMFuncOp lineFuncOp,
+                          LLVM::LLVMFuncOp flushFuncOp)
+    {
+        mlir::OpBuilder::InsertionGuard guard(builder);
+
+        if (writeFuncOp)
+        {
+            writeFuncOp = replaceDeclaration(builder, writeFuncOp);
+            auto loc = writeFuncOp->getLoc();
+            auto *entryBlock = startBody(builder, writeFuncOp);
+            writeToStdout(builder, loc, entryBlock->getArgument(0), entryBlock->getArgument(1));
+            builder.create<LLVM::ReturnOp>(loc, ValueRange{});
+        }
+
+        for (auto funcOp : {lineFuncOp, flushFuncOp})
+        {
+            if (funcOp)
+            {
+                funcOp = replaceDeclaration(builder, funcOp);
+                startBody(builder, funcOp);
+                builder.create<LLVM::ReturnOp>(funcOp->getLoc(), ValueRange{});
+            }
+        }
+    }
+
+    bool isThrowCall(mlir::Operation *op)
+    {
+        Optional<StringRef> callee;
+        if (auto callOp = dyn_cast<LLVM::CallOp>(op))
+        {
+            callee = callOp.callee();
+        }
+        else if (auto invokeOp = dyn_cast<LLVM::InvokeOp>(op))
+        {
+            callee = invokeOp.callee();
+        }
+
+        return callee && (*callee == "__cxa_throw" || *callee == "__cxa_rethrow" || *callee == "_CxxThrowException");
+    }
+
+    void defineFlush(mlir::OpBuilder &builder, LLVM::LLVMFuncOp flushFuncOp, LLVM::GlobalOp bufferOp,
+                     LLVM::GlobalOp lengthOp)
+    {
+        TypeHelper th(builder.getContext());
+        auto loc = flushFuncOp->getLoc();
+
+        mlir::OpBuilder::InsertionGuard guard(builder);
+        auto *entryBlock = startBody(builder, flushFuncOp);
+        auto *writeBlock = builder.createBlock(&flushFuncOp.getBody());
+        auto *exitBlock = builder.createBlock(&flushFuncOp.getBody());
+
+        builder.setInsertionPointToEnd(entryBlock);
+        auto lengthRef = builder.create<LLVM::AddressOfOp>(loc, lengthOp);
+        auto length = builder.create<LLVM::LoadOp>(loc, lengthRef);
+        auto isEmpty = builder.create<LLVM::ICmpOp>(loc, LLVM::ICmpPredicate::eq, length, constI64(builder, loc, 0));
+        builder.create<LLVM::CondBrOp>(loc, isEmpty, exitBlock, writeBlock);
+
+        builder.setInsertionPointToEnd(writeBlock);
+        writeToStdout(builder, loc, bufferPtr(builder, loc, bufferOp), length);
+        builder.create<LLVM::StoreOp>(loc, constI64(builder, loc, 0), lengthRef);
+        builder.create<LLVM::BrOp>(loc, ValueRange{}, exitBlock);
+
+        builder.setInsertionPointToEnd(exitBlock);
+        builder.create<LLVM::ReturnOp>(loc, ValueRange{});
+    }
+
+    void defineWrite(mlir::OpBuilder &builder, LLVM::LLVMFuncOp writeFuncOp, LLVM::LLVMFuncOp flushFuncOp,
+                     LLVM::GlobalOp bufferOp, LLVM::GlobalOp lengthOp, LLVM::GlobalOp registeredOp)
+    {
+        TypeHelper th(builder.getContext());
+        auto loc = writeFuncOp->getLoc();
+        auto i8PtrTy = th.getI8PtrType();
+        auto i64Ty = th.getI64Type();
+
+        mlir::OpBuilder::InsertionGuard guard(builder);
+        auto *entryBlock = startBody(builder, writeFuncOp);
+        auto *bufferBlock = registeredOp ? builder.createBlock(&writeFuncOp.getBody()) : entryBlock;
+        auto *copyBlock = builder.createBlock(&writeFuncOp.getBody());
+        auto *directBlock = builder.createBlock(&writeFuncOp.getBody());
+
+        auto chars = entryBlock->getArgument(0);
+        auto size = entryBlock->getArgument(1);
+
+        if (registeredOp)
+        {
+            registerFlushAtExit(builder, loc, entryBlock, bufferBlock, flushFuncOp, registeredOp);
+        }
+
+        builder.setInsertionPointToEnd(bufferBlock);
+        auto lengthRef = builder.create<LLVM::AddressOfOp>(loc, lengthOp);
+        auto length = builder.create<LLVM::LoadOp>(loc, lengthRef);
+        auto newLength = builder.create<LLVM::AddOp>(loc, i64Ty, ValueRange{length, size});
+        auto fits = builder.create<LLVM::ICmpOp>(loc, LLVM::ICmpPredicate::ule, newLength,
+                                                 constI64(builder, loc, OUTPUT_BUFFER_SIZE));
+        builder.create<LLVM::CondBrOp>(loc, fits, copyBlock, directBlock);
+
+        builder.setInsertionPointToEnd(copyBlock);
+        auto copyMemFuncOp = getOrInsertFunction(
+            builder, "llvm.memcpy.p0i8.p0i8.i64",
+            th.getFunctionType(th.getVoidType(), {i8PtrTy, i8PtrTy, i64Ty, th.getLLVMBoolType()}));
+        auto dest = builder.create<LLVM::GEPOp>(loc, i8PtrTy, bufferPtr(builder, loc, bufferOp), ValueRange{length});
+        auto immarg = builder.create<LLVM::ConstantOp>(loc, th.getLLVMBoolType(),
+                                                      builder.getIntegerAttr(builder.getI1Type(), 0));
+        builder.create<LLVM::CallOp>(loc, copyMemFuncOp, ValueRange{dest, chars, size, immarg});
+        builder.create<LLVM::StoreOp>(loc, newLength, lengthRef);
+        builder.create<LLVM::ReturnOp>(loc, ValueRange{});
+
+        builder.setInsertionPointToEnd(directBlock);
+        builder.create<LLVM::CallOp>(loc, flushFuncOp, ValueRange{});
+        writeToStdout(builder, loc, chars, size);
+        builder.create<LLVM::ReturnOp>(loc, ValueRange{});
+    }
+
+    // there is no 'main' to flush buffer on return, so flush is called by exit handler
+    void registerFlushAtExit(mlir::OpBuilder &builder, mlir::Location loc, mlir::Block *entryBlock,
+                             mlir::Block *continuationBlock, LLVM::LLVMFuncOp flushFuncOp, LLVM::GlobalOp registeredOp)
+    {
+        TypeHelper th(builder.getContext());
+
+        mlir::OpBuilder::InsertionGuard guard(builder);
+        auto *registerBlock = builder.createBlock(continuationBlock);
+
+        builder.setInsertionPointToEnd(entryBlock);
+        auto registeredRef = builder.create<LLVM::AddressOfOp>(loc, registeredOp);
+        auto registered = builder.create<LLVM::LoadOp>(loc, registeredRef);
+        builder.create<LLVM::CondBrOp>(loc, registered, continuationBlock, registerBlock);
+
+        builder.setInsertionPointToEnd(registerBlock);
+        auto trueValue =
+            builder.create<LLVM::ConstantOp>(loc, th.getLLVMBoolType(), builder.getIntegerAttr(builder.getI1Type(), 1));
+        builder.create<LLVM::StoreOp>(loc, trueValue, registeredRef);
+        auto flushFuncType = th.getFunctionType(th.getVoidType(), ArrayRef<mlir::Type>{});
+        auto atexitFuncOp =
+            getOrInsertFunction(builder, "atexit", th.getFunctionType(th.getI32Type(), {th.getPointerType(flushFuncType)}));
+        auto flushFuncPtr = builder.create<LLVM::AddressOfOp>(loc, flushFuncOp);
+        builder.create<LLVM::CallOp>(loc, atexitFuncOp, ValueRange{flushFuncPtr});
+        builder.create<LLVM::BrOp>(loc, ValueRange{}, continuationBlock);
+    }
+
+    void defineLine(mlir::OpBuilder &builder, LLVM::LLVMFuncOp lineFuncOp, LLVM::LLVMFuncOp flushFuncOp)
+    {
+        auto loc = lineFuncOp->getLoc();
+
+        mlir::OpBuilder::InsertionGuard guard(builder);
+        startBody(builder, lineFuncOp);
+        if (lineBuffered)
+        {
+            builder.create<LLVM::CallOp>(loc, flushFuncOp, ValueRange{});
+        }
+
+        builder.create<LLVM::ReturnOp>(loc, ValueRange{});
+    }
+
+    // external declaration made by lowering is replaced with internal function, so it can be inlined
+    LLVM::LLVMFuncOp replaceDeclaration(mlir::OpBuilder &builder, LLVM::LLVMFuncOp declFuncOp)
+    {
+        mlir::OpBuilder::InsertionGuard guard(builder);
+        builder.setInsertionPoint(declFuncOp);
+
+        auto loc = declFuncOp->getLoc();
+        auto name = declFuncOp.getName().str();
+        auto funcType = declFuncOp.getType();
+        declFuncOp->erase();
+
+        return builder.create<LLVM::LLVMFuncOp>(loc, name, funcType, LLVM::Linkage::Internal);
+    }
+
+    mlir::Block *startBody(mlir::OpBuilder &builder, LLVM::LLVMFuncOp funcOp)
+    {
+        auto *entryBlock = funcOp.addEntryBlock();
+        builder.setInsertionPointToStart(entryBlock);
+        return entryBlock;
+    }
+
+    void writeToStdout(mlir::OpBuilder &builder, mlir::Location loc, mlir::Value chars, mlir::Value size)
+    {
+        TypeHelper th(builder.getContext());
+        auto stdoutHandle = builder.create<LLVM::ConstantOp>(loc, th.getI32Type(), builder.getI32IntegerAttr(1));
+#ifdef WIN32
+        auto writeFuncOp = getOrInsertFunction(
+            builder, "_write", th.getFunctionType(th.getI32Type(), {th.getI32Type(), th.getI8PtrType(), th.getI32Type()}));
+        auto sizeI32 = builder.create<LLVM::TruncOp>(loc, th.getI32Type(), size);
+        builder.create<LLVM::CallOp>(loc, writeFuncOp, ValueRange{stdoutHandle, chars, sizeI32});
+#else
+        auto writeFuncOp = getOrInsertFunction(
+            builder, "write", th.getFunctionType(th.getI64Type(), {th.getI32Type(), th.getI8PtrType(), th.getI64Type()}));
+        builder.create<LLVM::CallOp>(loc, writeFuncOp, ValueRange{stdoutHandle, chars, size});
+#endif
+    }
+
+    mlir::Value bufferPtr(mlir::OpBuilder &builder, mlir::Location loc, LLVM::GlobalOp bufferOp)
+    {
+        TypeHelper th(builder.getContext());
+        auto bufferRef = builder.create<LLVM::AddressOfOp>(loc, bufferOp);
+        auto cst0 = constI64(builder, loc, 0);
+        return builder.create<LLVM::GEPOp>(loc, th.getI8PtrType(), bufferRef, ValueRange{cst0, cst0});
+    }
+
+    mlir::Value constI64(mlir::OpBuilder &builder, mlir::Location loc, int64_t value)
+    {
+        return builder.create<LLVM::ConstantOp>(loc, builder.getI64Type(), builder.getI64IntegerAttr(value));
+    }
+
+    LLVM::LLVMFuncOp getOrInsertFunction(mlir::OpBuilder &builder, StringRef name, LLVM::LLVMFunctionType funcType)
+    {
+        auto module = getModule();
+        if (auto funcOp = module.lookupSymbol<LLVM::LLVMFuncOp>(name))
+        {
+            return funcOp;
+        }
+
+        mlir::OpBuilder::InsertionGuard guard(builder);
+        builder.setInsertionPointToStart(module.getBody());
+        return builder.create<LLVM::LLVMFuncOp>(module.getLoc(), name, funcType);
+    }
+};
+} // end anonymous namespace
+
+/// Create a pass to define buffered output of 'print'.
+std::unique_ptr<mlir::Pass> mlir_ts::createOutputBufferPass(bool lineBuffered)
+{
+    return std::make_unique<OutputBufferPass>(lineBuffered);
+}
@@ -0,0 +1,276 @@
+#define DEBUG_TYPE "pass"
+
+#include "mlir/Pass/Pass.h"
+
+#include "TypeScript/Config.h"
+#include "TypeScript/TypeScriptDialect.h"
+#include "TypeScript/TypeScriptOps.h"
+#include "TypeScript/TypeScriptFunctionPass.h"
+#include "TypeScript/Passes.h"
+
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/Support/Debug.h"
+#include "llvm/Support/raw_ostream.h"
+
+namespace mlir_ts = mlir::typescript;
+
+namespace
+{
+
+// Replaces fields of instance which is used only to keep values locally with SSA values:
+//
+//    %0 = ts.New
+//    %1 = ts.PropertyRef %0 <1>
+//    ts.Store %a, %1
+//    ...
+//    %2 = ts.PropertyRef %0 <1>
+//    %3 = ts.Load %2
+//
+//  ->
+//
+//    %3 => %a
+//
+// All stores must be in the same block as ts.New (loads can be in nested regions), so value of field in any point
+// is the value of last store before it. Instance with load of field which is not stored yet is kept.
+// Instance can be kept in constant local variable (const v = new Vector()). Constructors and helpers have to be
+// inlined before to remove all other users of instance.
+class ScalarReplacementPass : public mlir::PassWrapper<ScalarReplacementPass, TypeScriptFunctionPass>
+{
+  public:
+    void runOnFunction() override
+    {
+        auto f = getFunction();
+
+        mlir::SmallVector<mlir_ts::NewOp, 4> workList;
+        f.walk([&](mlir_ts::NewOp newOp) {
+            if (canBeReplaced(newOp))
+            {
+                workList.push_back(newOp);
+            }
+        });
+
+        for (auto newOp : workList)
+        {
+            LLVM_DEBUG(llvm::dbgs() << "\n!! scalar replacement of: " << newOp << "\n";);
+
+            replace(newOp);
+        }
+    }
+
+  private:
+    // returns op in block of instance which contains access to field
+    mlir::Operation *getOpInBlock(mlir_ts::NewOp newOp, mlir::Operation *op)
+    {
+        return newOp->getBlock()->findAncestorOpInBlock(*op);
+    }
+
+    // instance and values loaded from constant local variable initialized with it
+    bool getInstanceValues(mlir_ts::NewOp newOp, mlir::SmallVector<mlir::Value> &instanceValues,
+                           mlir::SmallVector<mlir::Operation *> &variableOps)
+    {
+        instanceValues.push_back(newOp.getResult());
+        for (auto *user : newOp->getUsers())
+        {
+            auto variableOp = dyn_cast<mlir_ts::VariableOp>(user);
+            if (!variableOp)
+            {
+                continue;
+            }
+
+            if ((variableOp.captured().hasValue() && variableOp.captured().getValue()) ||
+                variableOp->getBlock() != newOp->getBlock())
+            {
+                return false;
+            }
+
+            for (auto *variableUser : variableOp->getUsers())
+            {
+                auto loadOp = dyn_cast<mlir_ts::LoadOp>(variableUser);
+                if (!loadOp)
+                {
+                    return false;
+                }
+
+                instanceValues.push_back(loadOp.getResult());
+                variableOps.push_back(loadOp);
+            }
+
+            variableOps.push_back(variableOp);
+        }
+
+        return true;
+    }
+
+    bool canBeReplaced(mlir_ts::NewOp newOp)
+    {
+        auto *block = newOp->getBlock();
+
+        mlir::SmallVector<mlir::Value> instanceValues;
+        mlir::SmallVector<mlir::Operation *> variableOps;
+        if (!getInstanceValues(newOp, instanceValues, variableOps))
+        {
+            return false;
+        }
+
+        // field => position of first store
+        llvm::DenseMap<unsigned, mlir::Operation *> firstStores;
+        mlir::SmallVector<mlir_ts::LoadOp> loads;
+        for (auto *user : getUsers(instanceValues))
+        {
+            if (llvm::is_contained(variableOps, user))
+            {
+                continue;
+            }
+
+            auto propertyRefOp = dyn_cast<mlir_ts::PropertyRefOp>(user);
+            if (!propertyRefOp)
+            {
+                return false;
+            }
+
+            auto position = propertyRefOp.position();
+            auto fieldType = propertyRefOp.getType().dyn_cast<mlir_ts::RefType>();
+            if (!fieldType)
+            {
+                return false;
+            }
+
+            for (auto *fieldUser : propertyRefOp->getUsers())
+            {
+                if (auto loadOp = dyn_cast<mlir_ts::LoadOp>(fieldUser))
+                {
+                    if (loadOp.getType() != fieldType.getElementType() || !getOpInBlock(newOp, loadOp))
+                    {
+                        return false;
+                    }
+
+                    loads.push_back(loadOp);
+                    continue;
+                }
+
+                if (auto storeOp = dyn_cast<mlir_ts::StoreOp>(fieldUser))
+                {
+                    if (storeOp.reference() != propertyRefOp.getResult() || storeOp.value() == propertyRefOp.getResult() ||
+                        storeOp->getBlock() != block || storeOp.value().getType() != fieldType.getElementType())
+                    {
+                        return false;
+                    }
+
+                    auto &firstStore = firstStores[position];
+                    if (!firstStore || storeOp->isBeforeInBlock(firstStore))
+                    {
+                        firstStore = storeOp;
+                    }
+
+                    continue;
+                }
+
+                return false;
+            }
+        }
+
+        // all loads have to read stored value
+        for (auto loadOp : loads)
+        {
+            auto position = loadOp.reference().getDefiningOp<mlir_ts::PropertyRefOp>().position();
+            auto firstStore = firstStores.lookup(position);
+            if (!firstStore || !firstStore->isBeforeInBlock(getOpInBlock(newOp, loadOp)))
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    mlir::SmallVector<mlir::Operation *> getUsers(mlir::ArrayRef<mlir::Value> values)
+    {
+        mlir::SmallVector<mlir::Operation *> users;
+        for (auto value : values)
+        {
+            users.append(value.user_begin(), value.user_end());
+        }
+
+        return users;
+    }
+
+    void replace(mlir_ts::NewOp newOp)
+    {
+        auto *block = newOp->getBlock();
+
+        mlir::SmallVector<mlir::Value> instanceValues;
+        mlir::SmallVector<mlir::Operation *> variableOps;
+        getInstanceValues(newOp, instanceValues, variableOps);
+
+        // op in block => loads in it
+        llvm::DenseMap<mlir::Operation *, mlir::SmallVector<mlir_ts::LoadOp>> loadsByOp;
+        mlir::SmallVector<mlir::Operation *> toErase;
+        for (auto *user : getUsers(instanceValues))
+        {
+            if (llvm::is_contained(variableOps, user))
+            {
+                continue;
+            }
+
+            for (auto *fieldUser : user->getUsers())
+            {
+                if (auto loadOp = dyn_cast<mlir_ts::LoadOp>(fieldUser))
+                {
+                    loadsByOp[getOpInBlock(newOp, loadOp)].push_back(loadOp);
+                }
+
+                toErase.push_back(fieldUser);
+            }
+
+            toErase.push_back(user);
+        }
+
+        // field => current value
+        llvm::DenseMap<unsigned, mlir::Value> values;
+        for (auto &op : llvm::make_range(std::next(newOp->getIterator()), block->end()))
+        {
+            auto it = loadsByOp.find(&op);
+            if (it != loadsByOp.end())
+            {
+                for (auto loadOp : it->second)
+                {
+                    auto position = loadOp.reference().getDefiningOp<mlir_ts::PropertyRefOp>().position();
+                    loadOp.getResult().replaceAllUsesWith(values[position]);
+                }
+            }
+
+            if (auto storeOp = dyn_cast<mlir_ts::StoreOp>(&op))
+            {
+                if (auto propertyRefOp = storeOp.reference().getDefiningOp<mlir_ts::PropertyRefOp>())
+                {
+                    if (llvm::is_contained(instanceValues, propertyRefOp.objectRef()))
+                    {
+                        values[propertyRefOp.position()] = storeOp.value();
+                    }
+                }
+            }
+        }
+
+        for (auto *op : toErase)
+        {
+            op->erase();
+        }
+
+        // loads of variable, then variable
+        for (auto *op : variableOps)
+        {
+            op->erase();
+        }
+
+        newOp->erase();
+    }
+};
+} // end anonymous namespace
+
+/// Create pass.
+std::unique_ptr<mlir::Pass> mlir_ts::createScalarReplacementPass()
+{
+    return std::make_unique<ScalarReplacementPass>();
+}
@@ -0,0 +1,244 @@
+#define DEBUG_TYPE "pass"
+
+#include "mlir/Pass/Pass.h"
+
+#include "TypeScript/Config.h"
+#include "TypeScript/TypeScriptDialect.h"
+#include "TypeScript/TypeScriptOps.h"
+#include "TypeScript/TypeScriptFunctionPass.h"
+#include "TypeScript/Passes.h"
+
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/Support/Debug.h"
+#include "llvm/Support/raw_ostream.h"
+
+namespace mlir_ts = mlir::typescript;
+
+namespace
+{
+
+// Replaces concatenation to local string variable in loop with appending to string builder:
+//
+//    ts.For {
+//      %0 = ts.Load %s
+//      %1 = ts.StringConcat %0, %x
+//      ts.Store %1, %s
+//    }
+//
+//  ->
+//
+//    %b = ts.Variable (ts.StringConcat (ts.Load %s))      // own copy of string which can be appended
+//    %l = ts.Variable (length of %b)
+//    %c = ts.Variable (length of %b)
+//    ts.For {
+//      ts.StringAppend %b, %l, %c, %x
+//    }
+//    ts.Store (ts.Load %b), %s
+//
+// String variable can't be used in loop by any other way, as buffer of builder is changed in place.
+class StringBuilderPass : public mlir::PassWrapper<StringBuilderPass, TypeScriptFunctionPass>
+{
+  public:
+    void runOnFunction() override
+    {
+        auto f = getFunction();
+
+        // state of generator is restored in loops, do not touch them
+        auto isGenerator = false;
+        f.walk([&](mlir::Operation *op) {
+            if (isa<mlir_ts::SwitchStateOp>(op) || isa<mlir_ts::StateLabelOp>(op) ||
+                isa<mlir_ts::YieldReturnValOp>(op))
+            {
+                isGenerator = true;
+            }
+        });
+
+        if (isGenerator)
+        {
+            return;
+        }
+
+        mlir::SmallVector<std::pair<mlir_ts::StoreOp, mlir::Operation *>, 4> workList;
+        f.walk([&](mlir_ts::StoreOp storeOp) {
+            if (auto *loopOp = getBuilderLoop(storeOp))
+            {
+                workList.push_back({storeOp, loopOp});
+            }
+        });
+
+        for (auto item : workList)
+        {
+            LLVM_DEBUG(llvm::dbgs() << "\n!! string builder for: " << item.first << "\n";);
+
+            replace(item.first, item.second);
+        }
+    }
+
+  private:
+    static bool isLoop(mlir::Operation *op)
+    {
+        return isa<mlir_ts::ForOp>(op) || isa<mlir_ts::WhileOp>(op) || isa<mlir_ts::DoWhileOp>(op);
+    }
+
+    mlir_ts::VariableOp getStringVariable(mlir::Value ref)
+    {
+        auto variableOp = ref.getDefiningOp<mlir_ts::VariableOp>();
+        if (!variableOp || (variableOp.captured().hasValue() && variableOp.captured().getValue()) ||
+            !variableOp.getType().cast<mlir_ts::RefType>().getElementType().isa<mlir_ts::StringType>())
+        {
+            return mlir_ts::VariableOp();
+        }
+
+        // variable is only loaded and stored, reference is not sent anywhere
+        for (auto *user : variableOp->getUsers())
+        {
+            if (isa<mlir_ts::LoadOp>(user))
+            {
+                continue;
+            }
+
+            auto storeOp = dyn_cast<mlir_ts::StoreOp>(user);
+            if (storeOp && storeOp.value() != variableOp.getResult())
+            {
+                continue;
+            }
+
+            return mlir_ts::VariableOp();
+        }
+
+        return variableOp;
+    }
+
+    // s = s + ... in loop, returns loop
+    mlir::Operation *getBuilderLoop(mlir_ts::StoreOp storeOp)
+    {
+        auto variableOp = getStringVariable(storeOp.reference());
+        if (!variableOp)
+        {
+            return nullptr;
+        }
+
+        auto concatOp = storeOp.value().getDefiningOp<mlir_ts::StringConcatOp>();
+        if (!concatOp || !concatOp->hasOneUse() || concatOp.ops().size() < 2 ||
+            (concatOp.allocInStack().hasValue() && concatOp.allocInStack().getValue()))
+        {
+            return nullptr;
+        }
+
+        auto loadOp = concatOp.ops().front().getDefiningOp<mlir_ts::LoadOp>();
+        if (!loadOp || loadOp.reference() != variableOp.getResult() || !loadOp->hasOneUse() ||
+            loadOp->getBlock() != storeOp->getBlock())
+        {
+            return nullptr;
+        }
+
+        // loops between variable and store, outer loop first
+        mlir::SmallVector<mlir::Operation *> loops;
+        for (auto *parentOp = storeOp->getParentOp(); parentOp && parentOp != variableOp->getParentOp();
+             parentOp = parentOp->getParentOp())
+        {
+            if (isa<mlir_ts::FuncOp>(parentOp) || isa<mlir_ts::TryOp>(parentOp))
+            {
+                // variable in other function or value of variable is needed when exception is caught
+                return nullptr;
+            }
+
+            if (isLoop(parentOp))
+            {
+                loops.insert(loops.begin(), parentOp);
+            }
+        }
+
+        for (auto *loopOp : loops)
+        {
+            if (!variableOp->getParentRegion()->isAncestor(loopOp->getParentRegion()))
+            {
+                continue;
+            }
+
+            if (canBuildInLoop(variableOp, loadOp, storeOp, loopOp))
+            {
+                return loopOp;
+            }
+        }
+
+        return nullptr;
+    }
+
+    bool canBuildInLoop(mlir_ts::VariableOp variableOp, mlir_ts::LoadOp loadOp, mlir_ts::StoreOp storeOp,
+                        mlir::Operation *loopOp)
+    {
+        // no other access to variable in loop
+        for (auto *user : variableOp->getUsers())
+        {
+            if (user != loadOp && user != storeOp && loopOp->isAncestor(user))
+            {
+                return false;
+            }
+        }
+
+        // labeled break/continue can leave outer loop skipping storing result
+        auto hasLabeledJump = false;
+        loopOp->walk([&](mlir::Operation *op) {
+            if (auto breakOp = dyn_cast<mlir_ts::BreakOp>(op))
+            {
+                hasLabeledJump |= breakOp.label().hasValue() && !breakOp.label().getValue().empty();
+            }
+
+            if (auto continueOp = dyn_cast<mlir_ts::ContinueOp>(op))
+            {
+                hasLabeledJump |= continueOp.label().hasValue() && !continueOp.label().getValue().empty();
+            }
+        });
+
+        return !hasLabeledJump;
+    }
+
+    void replace(mlir_ts::StoreOp storeOp, mlir::Operation *loopOp)
+    {
+        auto variableOp = storeOp.reference().getDefiningOp<mlir_ts::VariableOp>();
+        auto concatOp = storeOp.value().getDefiningOp<mlir_ts::StringConcatOp>();
+        auto loadOp = concatOp.ops().front().getDefiningOp<mlir_ts::LoadOp>();
+
+        mlir::OpBuilder builder(loopOp);
+        auto loc = loopOp->getLoc();
+
+        auto stringType = mlir_ts::StringType::get(builder.getContext());
+        auto i64Type = builder.getI64Type();
+
+        // builder owns copy of string
+        auto value = builder.create<mlir_ts::LoadOp>(loc, stringType, variableOp);
+        auto buffer = builder.create<mlir_ts::StringConcatOp>(loc, stringType, mlir::ValueRange{value});
+        auto length32 = builder.create<mlir_ts::StringLengthOp>(loc, builder.getI32Type(), buffer);
+        auto length = builder.create<mlir_ts::CastOp>(loc, i64Type, length32);
+
+        auto bufferVar =
+            builder.create<mlir_ts::VariableOp>(loc, mlir_ts::RefType::get(stringType), buffer, builder.getBoolAttr(false));
+        auto lengthVar =
+            builder.create<mlir_ts::VariableOp>(loc, mlir_ts::RefType::get(i64Type), length, builder.getBoolAttr(false));
+        auto capacityVar =
+            builder.create<mlir_ts::VariableOp>(loc, mlir_ts::RefType::get(i64Type), length, builder.getBoolAttr(false));
+
+        // append
+        builder.setInsertionPoint(storeOp);
+        builder.create<mlir_ts::StringAppendOp>(storeOp->getLoc(), bufferVar, lengthVar, capacityVar,
+                                                concatOp.ops().drop_front());
+
+        // result
+        builder.setInsertionPointAfter(loopOp);
+        auto result = builder.create<mlir_ts::LoadOp>(loc, stringType, bufferVar);
+        builder.create<mlir_ts::StoreOp>(loc, result, variableOp);
+
+        storeOp->erase();
+        concatOp->erase();
+        loadOp->erase();
+    }
+};
+} // end anonymous namespace
+
+/// Create pass.
+std::unique_ptr<mlir::Pass> mlir_ts::createStringBuilderPass()
+{
+    return std::make_unique<StringBuilderPass>();
+}
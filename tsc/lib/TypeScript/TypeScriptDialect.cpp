@@ -123,12 +123,14 @@ struct TypeScriptInlinerInterface : public mlir::DialectInlinerInterface
     //===--------------------------------------------------------------------===//
 
     /// All call operations within TypeScript(but recursive) can be inlined.
-    // TODO: find out how to prevent recursive calls in better way
     // TODO: something happening when inlining class methods
     bool isLegalToInline(mlir::Operation *call, mlir::Operation *callable, bool wouldBeCloned) const final
     {
-        LLVM_DEBUG(llvm::dbgs() << "!! Legal To Inline(call): TRUE = " << *call << "\n";);
-        return true;
+        // function calling itself
+        auto condition = !callable->isAncestor(call);
+        LLVM_DEBUG(llvm::dbgs() << "!! Legal To Inline(call): " << (condition ? "TRUE" : "FALSE") << " = " << *call
+                                << "\n";);
+        return condition;
     }
 
     bool isLegalToInline(Region *dest, Region *src, bool wouldBeCloned, BlockAndValueMapping &valueMapping) const final
@@ -160,6 +162,13 @@ struct TypeScriptInlinerInterface : public mlir::DialectInlinerInterface
         condition &= !isa<mlir_ts::BeginCatchOp>(op);
         condition &= !isa<mlir_ts::EndCatchOp>(op);
 
+        // body of coroutine can't be inlined into its caller
+        condition &= !isa<mlir_ts::CoroutineBeginOp>(op);
+
+        // body of generator
+        condition &= !isa<mlir_ts::SwitchStateOp>(op);
+        condition &= !isa<mlir_ts::YieldReturnValOp>(op);
+
         LLVM_DEBUG(llvm::dbgs() << "!! is Legal To Inline (op): " << (condition ? "TRUE" : "FALSE") << " " << *op << " = "
                                 << "\n";);
 
@@ -254,6 +263,12 @@ void mlir_ts::TypeScriptDialect::initialize()
     addInterfaces<TypeScriptInlinerInterface>();
 }
 
+/// Materializes result of folded operation as ts.Constant
+Operation *mlir_ts::TypeScriptDialect::materializeConstant(OpBuilder &builder, Attribute value, Type type, Location loc)
+{
+    return builder.create<mlir_ts::ConstantOp>(loc, type, value);
+}
+
 Type mlir_ts::TypeScriptDialect::parseType(DialectAsmParser &parser) const
 {
     llvm::SMLoc typeLoc = parser.getCurrentLocation();
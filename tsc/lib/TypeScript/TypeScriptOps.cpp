@@ -17,9 +17,14 @@
 #include "mlir/IR/PatternMatch.h"
 #include "mlir/IR/TypeUtilities.h"
 
+#include "llvm/ADT/APSInt.h"
 #include "llvm/ADT/TypeSwitch.h"
 #include "llvm/Support/Debug.h"
 
+#include "scanner_enums.h"
+
+#include <cmath>
+
 using namespace mlir;
 namespace mlir_ts = mlir::typescript;
 
@@ -163,6 +168,152 @@ OpFoldResult mlir_ts::ConstantOp::fold(ArrayRef<Attribute> operands)
     return getValue();
 }
 
+namespace
+{
+// folders evaluate ops in the same way as they are lowered into LLVM: integers are signed, numbers are compared by
+// ordered predicates and converted into strings as by runtime conversion
+
+mlir::Type getFoldType(mlir::Type type)
+{
+    if (auto literalType = type.dyn_cast<mlir_ts::LiteralType>())
+    {
+        return literalType.getElementType();
+    }
+
+    return type;
+}
+
+mlir::FloatType getFloatType(mlir::Type type)
+{
+    if (type.isa<mlir_ts::NumberType>())
+    {
+#ifdef NUMBER_F64
+        return Float64Type::get(type.getContext());
+#else
+        return Float32Type::get(type.getContext());
+#endif
+    }
+
+    return type.dyn_cast<mlir::FloatType>();
+}
+
+// value of constant operand if it can be folded as value of given type
+Attribute getFoldConstant(Attribute value, mlir::Type type)
+{
+    if (!value)
+    {
+        return Attribute();
+    }
+
+    if (type.isa<mlir_ts::BooleanType>() && value.isa<BoolAttr>())
+    {
+        return value;
+    }
+
+    if (type.isa<mlir_ts::StringType>() && value.isa<StringAttr>())
+    {
+        return value;
+    }
+
+    auto floatType = getFloatType(type);
+    auto floatAttr = value.dyn_cast<FloatAttr>();
+    if (floatType && floatAttr && floatAttr.getType() == floatType)
+    {
+        return value;
+    }
+
+    auto intAttr = value.dyn_cast<IntegerAttr>();
+    if (type.isSignlessInteger() && intAttr && intAttr.getType() == type)
+    {
+        return value;
+    }
+
+    return Attribute();
+}
+
+Attribute foldCompare(SyntaxKind code, APFloat::cmpResult cmp, MLIRContext *context)
+{
+    auto less = cmp == APFloat::cmpLessThan;
+    auto equal = cmp == APFloat::cmpEqual;
+    auto greater = cmp == APFloat::cmpGreaterThan;
+    switch (code)
+    {
+    case SyntaxKind::EqualsEqualsToken:
+    case SyntaxKind::EqualsEqualsEqualsToken:
+        return BoolAttr::get(context, equal);
+    case SyntaxKind::ExclamationEqualsToken:
+    case SyntaxKind::ExclamationEqualsEqualsToken:
+        return BoolAttr::get(context, less || greater);
+    case SyntaxKind::GreaterThanToken:
+        return BoolAttr::get(context, greater);
+    case SyntaxKind::GreaterThanEqualsToken:
+        return BoolAttr::get(context, greater || equal);
+    case SyntaxKind::LessThanToken:
+        return BoolAttr::get(context, less);
+    case SyntaxKind::LessThanEqualsToken:
+        return BoolAttr::get(context, less || equal);
+    default:
+        return Attribute();
+    }
+}
+
+// booleans are compared as i1 and strings as by 'strcmp'
+Attribute foldCompare(SyntaxKind code, mlir::Type type, Attribute lhsValue, Attribute rhsValue)
+{
+    auto lhs = getFoldConstant(lhsValue, type);
+    auto rhs = getFoldConstant(rhsValue, type);
+    if (!lhs || !rhs)
+    {
+        return Attribute();
+    }
+
+    auto context = type.getContext();
+    if (auto lhsStr = lhs.dyn_cast<StringAttr>())
+    {
+        auto result = lhsStr.getValue().compare(rhs.cast<StringAttr>().getValue());
+        auto cmp = result < 0 ? APFloat::cmpLessThan : result > 0 ? APFloat::cmpGreaterThan : APFloat::cmpEqual;
+        return foldCompare(code, cmp, context);
+    }
+
+    if (auto lhsFloat = lhs.dyn_cast<FloatAttr>())
+    {
+        return foldCompare(code, lhsFloat.getValue().compare(rhs.cast<FloatAttr>().getValue()), context);
+    }
+
+    auto lhsInt = lhs.cast<IntegerAttr>().getValue();
+    auto rhsInt = rhs.cast<IntegerAttr>().getValue();
+    auto cmp = lhsInt.slt(rhsInt)   ? APFloat::cmpLessThan
+               : lhsInt.sgt(rhsInt) ? APFloat::cmpGreaterThan
+                                    : APFloat::cmpEqual;
+    return foldCompare(code, cmp, context);
+}
+
+// same text as number has when it is converted into string at runtime, values which are printed with shortest precision
+// are not folded
+Attribute foldNumberToString(FloatAttr value)
+{
+    auto context = value.getContext();
+    if (value.getValue().isNaN())
+    {
+        return StringAttr::get(context, "NaN");
+    }
+
+    if (value.getValue().isInfinity())
+    {
+        return StringAttr::get(context, value.getValue().isNegative() ? "-Infinity" : "Infinity");
+    }
+
+    auto doubleValue = value.getValueAsDouble();
+    if (doubleValue < 9007199254740992.0 && doubleValue > -9007199254740992.0 &&
+        (double)(int64_t)doubleValue == doubleValue)
+    {
+        return StringAttr::get(context, std::to_string((int64_t)doubleValue));
+    }
+
+    return Attribute();
+}
+} // end anonymous namespace.
+
 namespace
 {
 template <typename T> struct RemoveUnused : public OpRewritePattern<T>
@@ -303,6 +454,49 @@ void mlir_ts::LoadOp::getCanonicalizationPatterns(OwningRewritePatternList &resu
     results.insert<RemoveUnused<mlir_ts::LoadOp>>(context);
 }
 
+//===----------------------------------------------------------------------===//
+// StoreOp
+//===----------------------------------------------------------------------===//
+
+namespace
+{
+// storing value into field does not need 'this' of bound reference
+struct StoreToBoundRef : public OpRewritePattern<mlir_ts::StoreOp>
+{
+    using OpRewritePattern<mlir_ts::StoreOp>::OpRewritePattern;
+
+    LogicalResult matchAndRewrite(mlir_ts::StoreOp storeOp, PatternRewriter &rewriter) const override
+    {
+        auto propertyRefOp = storeOp.reference().getDefiningOp<mlir_ts::PropertyRefOp>();
+        if (!propertyRefOp)
+        {
+            return failure();
+        }
+
+        auto boundRefType = propertyRefOp.getType().dyn_cast<mlir_ts::BoundRefType>();
+        if (!boundRefType || boundRefType.getElementType() != storeOp.value().getType())
+        {
+            return failure();
+        }
+
+        auto fieldRef = rewriter.create<mlir_ts::PropertyRefOp>(storeOp->getLoc(), mlir_ts::RefType::get(boundRefType.getElementType()),
+                                                                propertyRefOp.objectRef(), propertyRefOp.positionAttr());
+        rewriter.replaceOpWithNewOp<mlir_ts::StoreOp>(storeOp, storeOp.value(), fieldRef);
+        if (propertyRefOp.getResult().use_empty())
+        {
+            rewriter.eraseOp(propertyRefOp);
+        }
+
+        return success();
+    }
+};
+} // end anonymous namespace.
+
+void mlir_ts::StoreOp::getCanonicalizationPatterns(OwningRewritePatternList &results, MLIRContext *context)
+{
+    results.insert<StoreToBoundRef>(context);
+}
+
 //===----------------------------------------------------------------------===//
 // NullOp
 //===----------------------------------------------------------------------===//
@@ -321,6 +515,184 @@ void mlir_ts::UndefOp::getCanonicalizationPatterns(OwningRewritePatternList &res
     results.insert<RemoveUnused<mlir_ts::UndefOp>>(context);
 }
 
+//===----------------------------------------------------------------------===//
+// CreateTupleOp, DeconstructTupleOp, ExtractPropertyOp, InsertPropertyOp
+//===----------------------------------------------------------------------===//
+
+namespace
+{
+ArrayRef<mlir_ts::FieldInfo> getTupleFields(mlir::Type type)
+{
+    if (auto tupleType = type.dyn_cast_or_null<mlir_ts::TupleType>())
+    {
+        return tupleType.getFields();
+    }
+
+    if (auto constTupleType = type.dyn_cast_or_null<mlir_ts::ConstTupleType>())
+    {
+        return constTupleType.getFields();
+    }
+
+    return ArrayRef<mlir_ts::FieldInfo>();
+}
+
+mlir::Value castValue(mlir::Location loc, mlir::Value value, mlir::Type type, PatternRewriter &rewriter)
+{
+    if (value.getType() == type)
+    {
+        return value;
+    }
+
+    return rewriter.create<mlir_ts::CastOp>(loc, type, value);
+}
+
+// returns index of field if position is index of field of tuple (not nested field)
+int getFieldIndex(ArrayAttr position)
+{
+    if (position.size() != 1)
+    {
+        return -1;
+    }
+
+    auto indexAttr = position[0].dyn_cast<mlir::IntegerAttr>();
+    return indexAttr ? static_cast<int>(indexAttr.getInt()) : -1;
+}
+
+// deconstruct of created tuple returns values tuple is created from
+struct DeconstructCreatedTuple : public OpRewritePattern<mlir_ts::DeconstructTupleOp>
+{
+    using OpRewritePattern<mlir_ts::DeconstructTupleOp>::OpRewritePattern;
+
+    LogicalResult matchAndRewrite(mlir_ts::DeconstructTupleOp deconstructTupleOp, PatternRewriter &rewriter) const override
+    {
+        if (deconstructTupleOp->use_empty())
+        {
+            rewriter.eraseOp(deconstructTupleOp);
+            return success();
+        }
+
+        auto createTupleOp = deconstructTupleOp.instance().getDefiningOp<mlir_ts::CreateTupleOp>();
+        if (!createTupleOp || createTupleOp.items().size() != deconstructTupleOp.getNumResults())
+        {
+            return failure();
+        }
+
+        SmallVector<mlir::Value> values;
+        for (auto it : llvm::zip(createTupleOp.items(), deconstructTupleOp.getResults()))
+        {
+            values.push_back(castValue(deconstructTupleOp->getLoc(), std::get<0>(it), std::get<1>(it).getType(), rewriter));
+        }
+
+        rewriter.replaceOp(deconstructTupleOp, values);
+        return success();
+    }
+};
+
+// extract of field of created tuple or of just inserted field returns value of field
+struct ExtractInsertedProperty : public OpRewritePattern<mlir_ts::ExtractPropertyOp>
+{
+    using OpRewritePattern<mlir_ts::ExtractPropertyOp>::OpRewritePattern;
+
+    LogicalResult matchAndRewrite(mlir_ts::ExtractPropertyOp extractPropertyOp, PatternRewriter &rewriter) const override
+    {
+        if (extractPropertyOp->use_empty())
+        {
+            rewriter.eraseOp(extractPropertyOp);
+            return success();
+        }
+
+        auto index = getFieldIndex(extractPropertyOp.position());
+        if (index < 0)
+        {
+            return failure();
+        }
+
+        auto object = extractPropertyOp.object();
+        if (auto createTupleOp = object.getDefiningOp<mlir_ts::CreateTupleOp>())
+        {
+            if (index >= static_cast<int>(createTupleOp.items().size()))
+            {
+                return failure();
+            }
+
+            rewriter.replaceOp(extractPropertyOp, castValue(extractPropertyOp->getLoc(), createTupleOp.items()[index],
+                                                            extractPropertyOp.getType(), rewriter));
+            return success();
+        }
+
+        if (auto insertPropertyOp = object.getDefiningOp<mlir_ts::InsertPropertyOp>())
+        {
+            auto insertIndex = getFieldIndex(insertPropertyOp.position());
+            if (insertIndex < 0 || insertPropertyOp.object().getType() != object.getType())
+            {
+                return failure();
+            }
+
+            if (insertIndex == index)
+            {
+                rewriter.replaceOp(extractPropertyOp, castValue(extractPropertyOp->getLoc(), insertPropertyOp.value(),
+                                                                extractPropertyOp.getType(), rewriter));
+                return success();
+            }
+
+            // other field is not changed
+            rewriter.updateRootInPlace(extractPropertyOp, [&]() { extractPropertyOp->setOperand(0, insertPropertyOp.object()); });
+            return success();
+        }
+
+        return failure();
+    }
+};
+
+// insert into created tuple creates tuple with new value of field
+struct InsertIntoCreatedTuple : public OpRewritePattern<mlir_ts::InsertPropertyOp>
+{
+    using OpRewritePattern<mlir_ts::InsertPropertyOp>::OpRewritePattern;
+
+    LogicalResult matchAndRewrite(mlir_ts::InsertPropertyOp insertPropertyOp, PatternRewriter &rewriter) const override
+    {
+        if (insertPropertyOp->use_empty())
+        {
+            rewriter.eraseOp(insertPropertyOp);
+            return success();
+        }
+
+        auto createTupleOp = insertPropertyOp.object().getDefiningOp<mlir_ts::CreateTupleOp>();
+        auto index = getFieldIndex(insertPropertyOp.position());
+        if (!createTupleOp || index < 0 || index >= static_cast<int>(createTupleOp.items().size()) ||
+            createTupleOp.getType() != insertPropertyOp.getType())
+        {
+            return failure();
+        }
+
+        SmallVector<mlir::Value> values(createTupleOp.items().begin(), createTupleOp.items().end());
+        values[index] = castValue(insertPropertyOp->getLoc(), insertPropertyOp.value(), values[index].getType(), rewriter);
+        rewriter.replaceOpWithNewOp<mlir_ts::CreateTupleOp>(insertPropertyOp, createTupleOp.getType(), values);
+        return success();
+    }
+};
+} // end anonymous namespace.
+
+void mlir_ts::CreateTupleOp::getCanonicalizationPatterns(OwningRewritePatternList &results, MLIRContext *context)
+{
+    results.insert<RemoveUnused<mlir_ts::CreateTupleOp>>(context);
+}
+
+void mlir_ts::DeconstructTupleOp::getCanonicalizationPatterns(OwningRewritePatternList &results, MLIRContext *context)
+{
+    results.insert<DeconstructCreatedTuple>(context);
+}
+
+void mlir_ts::ExtractPropertyOp::getCanonicalizationPatterns(OwningRewritePatternList &results, MLIRContext *context)
+{
+    results.insert<ExtractInsertedProperty>(context);
+}
+
+void mlir_ts::InsertPropertyOp::getCanonicalizationPatterns(OwningRewritePatternList &results, MLIRContext *context)
+{
+    results.insert<InsertIntoCreatedTuple>(context);
+}
+
 //===----------------------------------------------------------------------===//
 // CastOp
 //===----------------------------------------------------------------------===//
@@ -425,6 +797,97 @@ LogicalResult verify(mlir_ts::CastOp op)
 
 namespace
 {
+// maps fields of source tuple to fields of destination tuple (by name, or by index when source fields do not have names),
+// -1 means field is not found
+LogicalResult mapTupleFields(ArrayRef<mlir_ts::FieldInfo> srcFields, ArrayRef<mlir_ts::FieldInfo> destFields,
+                             SmallVectorImpl<int> &mapping)
+{
+    auto anyFieldWithName = llvm::any_of(srcFields, [](const mlir_ts::FieldInfo &srcField) { return !!srcField.id; });
+    for (auto destIndex = 0; destIndex < static_cast<int>(destFields.size()); destIndex++)
+    {
+        auto destField = destFields[destIndex];
+        if (destField.id && anyFieldWithName)
+        {
+            auto found = std::find_if(srcFields.begin(), srcFields.end(),
+                                      [&](const mlir_ts::FieldInfo &srcField) { return srcField.id && srcField.id == destField.id; });
+            mapping.push_back(found != srcFields.end() ? static_cast<int>(std::distance(srcFields.begin(), found)) : -1);
+            continue;
+        }
+
+        if (destIndex >= static_cast<int>(srcFields.size()))
+        {
+            return failure();
+        }
+
+        mapping.push_back(destIndex);
+    }
+
+    return success();
+}
+
+// cast of tuple into tuple is creating new tuple with values of fields of source tuple, so casting of just created tuple
+// is creating one tuple:
+//
+//    %0 = ts.CreateTuple [%a, %b]
+//    %1 = ts.Cast %0 -> tuple<b, a>
+//
+//  ->
+//
+//    %1 = ts.CreateTuple [%b, %a]
+LogicalResult castTupleToTuple(mlir_ts::CastOp castOp, PatternRewriter &rewriter)
+{
+    auto in = castOp.in();
+    auto tupleTypeRes = castOp.getType().dyn_cast<mlir_ts::TupleType>();
+    if (!tupleTypeRes || in.getDefiningOp<mlir_ts::ConstantOp>())
+    {
+        return failure();
+    }
+
+    if (!in.getType().isa<mlir_ts::TupleType>() && !in.getType().isa<mlir_ts::ConstTupleType>())
+    {
+        return failure();
+    }
+
+    auto srcFields = getTupleFields(in.getType());
+
+    SmallVector<int> mapping;
+    if (failed(mapTupleFields(srcFields, tupleTypeRes.getFields(), mapping)))
+    {
+        return failure();
+    }
+
+    auto loc = castOp->getLoc();
+
+    SmallVector<mlir::Value> srcValues;
+    if (auto createTupleOp = in.getDefiningOp<mlir_ts::CreateTupleOp>())
+    {
+        srcValues.append(createTupleOp.items().begin(), createTupleOp.items().end());
+    }
+    else
+    {
+        SmallVector<mlir::Type> types;
+        for (auto &field : srcFields)
+        {
+            types.push_back(field.type);
+        }
+
+        auto deconstructTupleOp = rewriter.create<mlir_ts::DeconstructTupleOp>(loc, types, in);
+        srcValues.append(deconstructTupleOp.getResults().begin(), deconstructTupleOp.getResults().end());
+    }
+
+    SmallVector<mlir::Value> values;
+    for (auto it : llvm::zip(tupleTypeRes.getFields(), mapping))
+    {
+        auto destType = std::get<0>(it).type;
+        auto srcIndex = std::get<1>(it);
+        values.push_back(srcIndex >= 0 ? castValue(loc, srcValues[srcIndex], destType, rewriter)
+                                       : rewriter.create<mlir_ts::UndefOp>(loc, destType).getResult());
+    }
+
+    rewriter.replaceOpWithNewOp<mlir_ts::CreateTupleOp>(castOp, tupleTypeRes, values);
+    return success();
+}
+
 struct NormalizeCast : public OpRewritePattern<mlir_ts::CastOp>
 {
     using OpRewritePattern<mlir_ts::CastOp>::OpRewritePattern;
@@ -516,6 +979,12 @@ struct NormalizeCast : public OpRewritePattern<mlir_ts::CastOp>
             }
         }
 
+        // tuple -> tuple, fields are mapped when tuple is created
+        if (succeeded(castTupleToTuple(castOp, rewriter)))
+        {
+            return success();
+        }
+
         // const tuple -> const tuple, for example { value: undefined, done: true } -> { value: <int>, done: <boolean> }
         if (auto constTupleIn = in.getType().dyn_cast_or_null<mlir_ts::ConstTupleType>())
         {
@@ -579,22 +1048,130 @@ bool mlir_ts::CastOp::areCastCompatible(TypeRange inputs, TypeRange outputs)
     return true;
 }
 
-//===----------------------------------------------------------------------===//
-// DialectCastOp
-//===----------------------------------------------------------------------===//
-
-/// Returns true if the given set of input and result types are compatible with
-/// this cast operation. This is required by the `CastOpInterface` to verify
-/// this operation and provide other additional utilities.
-bool mlir_ts::DialectCastOp::areCastCompatible(TypeRange inputs, TypeRange outputs)
+OpFoldResult mlir_ts::CastOp::fold(ArrayRef<Attribute> operands)
 {
-    if (inputs.size() != 1 || outputs.size() != 1)
+    if (in().getType() == res().getType())
     {
-        // not supporting N->N cast
-        return false;
+        return in();
     }
 
-    // for now all are true
+    auto inType = getFoldType(in().getType());
+    auto resType = res().getType();
+    auto value = getFoldConstant(operands.front(), inType);
+    if (!value)
+    {
+        return {};
+    }
+
+    // literal -> type of literal
+    if (inType == resType)
+    {
+        return value;
+    }
+
+    auto context = getContext();
+    auto intAttr = value.dyn_cast<IntegerAttr>();
+    auto floatAttr = value.dyn_cast<FloatAttr>();
+
+    if (resType.isa<mlir_ts::BooleanType>())
+    {
+        if (intAttr && !inType.isa<mlir_ts::BooleanType>())
+        {
+            return BoolAttr::get(context, intAttr.getValue().getBoolValue());
+        }
+
+        // NaN is false
+        if (floatAttr)
+        {
+            return BoolAttr::get(context, !floatAttr.getValue().isZero() && !floatAttr.getValue().isNaN());
+        }
+
+        return {};
+    }
+
+    if (resType.isa<mlir_ts::StringType>())
+    {
+        if (inType.isa<mlir_ts::BooleanType>())
+        {
+            return StringAttr::get(context, value.cast<BoolAttr>().getValue() ? "true" : "false");
+        }
+
+        if (intAttr && (inType.isInteger(32) || inType.isInteger(64)))
+        {
+            return StringAttr::get(context, std::to_string(intAttr.getValue().getSExtValue()));
+        }
+
+        if (floatAttr)
+        {
+            return foldNumberToString(floatAttr);
+        }
+
+        return {};
+    }
+
+    if (auto resFloatType = getFloatType(resType))
+    {
+        if (intAttr && inType.isSignlessInteger() && !inType.isInteger(1))
+        {
+            APFloat result(resFloatType.getFloatSemantics());
+            result.convertFromAPInt(intAttr.getValue(), true, APFloat::rmNearestTiesToEven);
+            return FloatAttr::get(resFloatType, result);
+        }
+
+        if (floatAttr)
+        {
+            auto losesInfo = false;
+            auto result = floatAttr.getValue();
+            result.convert(resFloatType.getFloatSemantics(), APFloat::rmNearestTiesToEven, &losesInfo);
+            return FloatAttr::get(resFloatType, result);
+        }
+
+        return {};
+    }
+
+    if (resType.isSignlessInteger() && !resType.isInteger(1))
+    {
+        auto width = resType.getIntOrFloatBitWidth();
+
+        // booleans and integers are zero extended
+        if (intAttr)
+        {
+            return IntegerAttr::get(resType, intAttr.getValue().zextOrTrunc(width));
+        }
+
+        // value out of range is undefined at runtime
+        if (floatAttr)
+        {
+            APSInt result(width, false);
+            auto isExact = false;
+            if (floatAttr.getValue().convertToInteger(result, APFloat::rmTowardZero, &isExact) == APFloat::opInvalidOp)
+            {
+                return {};
+            }
+
+            return IntegerAttr::get(resType, result);
+        }
+    }
+
+    return {};
+}
+
+//===----------------------------------------------------------------------===//
+// DialectCastOp
+//===----------------------------------------------------------------------===//
+
+/// Returns true if the given set of input and result types are compatible with
+/// this cast operation. This is required by the `CastOpInterface` to verify
+/// this operation and provide other additional utilities.
+bool mlir_ts::DialectCastOp::areCastCompatible(TypeRange inputs, TypeRange outputs)
+{
+    if (inputs.size() != 1 || outputs.size() != 1)
+    {
+        // not supporting N->N cast
+        return false;
+    }
+
+    // for now all are true
     return true;
 }
 
@@ -972,6 +1549,637 @@ void mlir_ts::CallIndirectOp::getCanonicalizationPatterns(OwningRewritePatternLi
     results.insert<SimplifyIndirectCallWithKnownCallee>(context);
 }
 
+//===----------------------------------------------------------------------===//
+// ArithmeticBinaryOp
+//===----------------------------------------------------------------------===//
+
+namespace
+{
+// string + string is concatenation, to join chains of concatenations into one
+struct StringPlusToConcat : public OpRewritePattern<mlir_ts::ArithmeticBinaryOp>
+{
+    using OpRewritePattern<mlir_ts::ArithmeticBinaryOp>::OpRewritePattern;
+
+    LogicalResult matchAndRewrite(mlir_ts::ArithmeticBinaryOp arithmeticBinaryOp, PatternRewriter &rewriter) const override
+    {
+        if ((SyntaxKind)arithmeticBinaryOp.opCode() != SyntaxKind::PlusToken ||
+            !arithmeticBinaryOp.operand1().getType().isa<mlir_ts::StringType>() ||
+            !arithmeticBinaryOp.operand2().getType().isa<mlir_ts::StringType>() ||
+            !arithmeticBinaryOp.getType().isa<mlir_ts::StringType>())
+        {
+            return failure();
+        }
+
+        rewriter.replaceOpWithNewOp<mlir_ts::StringConcatOp>(
+            arithmeticBinaryOp, arithmeticBinaryOp.getType(),
+            ValueRange{arithmeticBinaryOp.operand1(), arithmeticBinaryOp.operand2()});
+        return success();
+    }
+};
+} // end anonymous namespace.
+
+void mlir_ts::ArithmeticBinaryOp::getCanonicalizationPatterns(OwningRewritePatternList &results, MLIRContext *context)
+{
+    results.insert<StringPlusToConcat>(context);
+}
+
+// integer division and remainder are undefined for zero divisor, so they are not moved or removed as pure ops
+void mlir_ts::ArithmeticBinaryOp::getEffects(
+    SmallVectorImpl<SideEffects::EffectInstance<MemoryEffects::Effect>> &effects)
+{
+    auto code = (SyntaxKind)opCode();
+    if ((code == SyntaxKind::SlashToken || code == SyntaxKind::PercentToken) &&
+        operand1().getType().isa<mlir::IntegerType>())
+    {
+        effects.emplace_back(MemoryEffects::Write::get());
+    }
+}
+
+namespace
+{
+// division by zero, overflow of division and shift by width of integer or more are undefined at runtime
+Attribute foldIntegerBinary(SyntaxKind code, mlir::Type type, const APInt &lhs, const APInt &rhs)
+{
+    switch (code)
+    {
+    case SyntaxKind::PlusToken:
+        return IntegerAttr::get(type, lhs + rhs);
+    case SyntaxKind::MinusToken:
+        return IntegerAttr::get(type, lhs - rhs);
+    case SyntaxKind::AsteriskToken:
+        return IntegerAttr::get(type, lhs * rhs);
+    case SyntaxKind::SlashToken:
+    case SyntaxKind::PercentToken:
+        if (rhs == 0 || (lhs.isMinSignedValue() && rhs.isAllOnesValue()))
+        {
+            return Attribute();
+        }
+
+        return IntegerAttr::get(type, code == SyntaxKind::SlashToken ? lhs.sdiv(rhs) : lhs.srem(rhs));
+    case SyntaxKind::AmpersandToken:
+        return IntegerAttr::get(type, lhs & rhs);
+    case SyntaxKind::BarToken:
+        return IntegerAttr::get(type, lhs | rhs);
+    case SyntaxKind::CaretToken:
+        return IntegerAttr::get(type, lhs ^ rhs);
+    case SyntaxKind::LessThanLessThanToken:
+    case SyntaxKind::GreaterThanGreaterThanToken:
+    case SyntaxKind::GreaterThanGreaterThanGreaterThanToken:
+        if (rhs.uge(lhs.getBitWidth()))
+        {
+            return Attribute();
+        }
+
+        return IntegerAttr::get(type, code == SyntaxKind::LessThanLessThanToken         ? lhs.shl(rhs)
+                                      : code == SyntaxKind::GreaterThanGreaterThanToken ? lhs.ashr(rhs)
+                                                                                        : lhs.lshr(rhs));
+    default:
+        return Attribute();
+    }
+}
+
+Attribute foldFloatBinary(SyntaxKind code, FloatAttr lhsAttr, FloatAttr rhsAttr)
+{
+    auto lhs = lhsAttr.getValue();
+    auto rhs = rhsAttr.getValue();
+    switch (code)
+    {
+    case SyntaxKind::PlusToken:
+        lhs.add(rhs, APFloat::rmNearestTiesToEven);
+        break;
+    case SyntaxKind::MinusToken:
+        lhs.subtract(rhs, APFloat::rmNearestTiesToEven);
+        break;
+    case SyntaxKind::AsteriskToken:
+        lhs.multiply(rhs, APFloat::rmNearestTiesToEven);
+        break;
+    case SyntaxKind::SlashToken:
+        lhs.divide(rhs, APFloat::rmNearestTiesToEven);
+        break;
+    case SyntaxKind::PercentToken:
+        // the same as 'fmod'
+        lhs.mod(rhs);
+        break;
+    case SyntaxKind::AsteriskAsteriskToken:
+        // 'pow' of f32 is not calculated in double precision
+        if (!lhsAttr.getType().isF64())
+        {
+            return Attribute();
+        }
+
+        return FloatAttr::get(lhsAttr.getType(), std::pow(lhsAttr.getValueAsDouble(), rhsAttr.getValueAsDouble()));
+    default:
+        return Attribute();
+    }
+
+    return FloatAttr::get(lhsAttr.getType(), lhs);
+}
+} // end anonymous namespace.
+
+OpFoldResult mlir_ts::ArithmeticBinaryOp::fold(ArrayRef<Attribute> operands)
+{
+    auto type = getFoldType(operand1().getType());
+    if (type != getFoldType(operand2().getType()) || type != getType())
+    {
+        return {};
+    }
+
+    auto lhs = getFoldConstant(operands[0], type);
+    auto rhs = getFoldConstant(operands[1], type);
+    if (!lhs || !rhs)
+    {
+        return {};
+    }
+
+    auto code = (SyntaxKind)opCode();
+    if (auto lhsStr = lhs.dyn_cast<StringAttr>())
+    {
+        if (code != SyntaxKind::PlusToken)
+        {
+            return {};
+        }
+
+        return StringAttr::get(getContext(), (lhsStr.getValue() + rhs.cast<StringAttr>().getValue()).str());
+    }
+
+    if (auto lhsFloat = lhs.dyn_cast<FloatAttr>())
+    {
+        return foldFloatBinary(code, lhsFloat, rhs.cast<FloatAttr>());
+    }
+
+    if (type.isSignlessInteger())
+    {
+        return foldIntegerBinary(code, type, lhs.cast<IntegerAttr>().getValue(), rhs.cast<IntegerAttr>().getValue());
+    }
+
+    return {};
+}
+
+//===----------------------------------------------------------------------===//
+// ArithmeticUnaryOp
+//===----------------------------------------------------------------------===//
+
+OpFoldResult mlir_ts::ArithmeticUnaryOp::fold(ArrayRef<Attribute> operands)
+{
+    auto type = getFoldType(operand1().getType());
+    auto value = getFoldConstant(operands.front(), type);
+    if (!value || type != getType())
+    {
+        return {};
+    }
+
+    auto intAttr = value.dyn_cast<IntegerAttr>();
+    auto floatAttr = value.dyn_cast<FloatAttr>();
+    switch ((SyntaxKind)opCode())
+    {
+    case SyntaxKind::ExclamationToken:
+        if (type.isa<mlir_ts::BooleanType>())
+        {
+            return BoolAttr::get(getContext(), !value.cast<BoolAttr>().getValue());
+        }
+
+        break;
+    case SyntaxKind::PlusToken:
+        return value;
+    case SyntaxKind::MinusToken:
+        if (intAttr && type.isSignlessInteger())
+        {
+            return IntegerAttr::get(type, -intAttr.getValue());
+        }
+
+        // lowered as 0.0 - value
+        if (floatAttr)
+        {
+            APFloat result(floatAttr.getValue().getSemantics(), 0);
+            result.subtract(floatAttr.getValue(), APFloat::rmNearestTiesToEven);
+            return FloatAttr::get(floatAttr.getType(), result);
+        }
+
+        break;
+    case SyntaxKind::TildeToken:
+        if (intAttr && type.isSignlessInteger())
+        {
+            return IntegerAttr::get(type, ~intAttr.getValue());
+        }
+
+        break;
+    default:
+        break;
+    }
+
+    return {};
+}
+
+//===----------------------------------------------------------------------===//
+// LogicalBinaryOp
+//===----------------------------------------------------------------------===//
+
+OpFoldResult mlir_ts::LogicalBinaryOp::fold(ArrayRef<Attribute> operands)
+{
+    auto type = getFoldType(operand1().getType());
+    if (type != getFoldType(operand2().getType()))
+    {
+        return {};
+    }
+
+    return foldCompare((SyntaxKind)opCode(), type, operands[0], operands[1]);
+}
+
+// strings are compared by content, so compare can't be moved over stores
+void mlir_ts::LogicalBinaryOp::getEffects(SmallVectorImpl<SideEffects::EffectInstance<MemoryEffects::Effect>> &effects)
+{
+    auto readsMemory = [](mlir::Type type) {
+        if (auto optType = type.dyn_cast<mlir_ts::OptionalType>())
+        {
+            type = optType.getElementType();
+        }
+
+        return type.isa<mlir_ts::StringType>() || type.isa<mlir_ts::RefType>();
+    };
+
+    if (readsMemory(operand1().getType()) || readsMemory(operand2().getType()))
+    {
+        effects.emplace_back(MemoryEffects::Read::get());
+    }
+}
+
+//===----------------------------------------------------------------------===//
+// StringConcatOp
+//===----------------------------------------------------------------------===//
+
+namespace
+{
+StringAttr getConstantString(mlir::Value value)
+{
+    if (auto constantOp = value.getDefiningOp<mlir_ts::ConstantOp>())
+    {
+        return constantOp.value().dyn_cast_or_null<StringAttr>();
+    }
+
+    return StringAttr();
+}
+
+// (a + b) + c => concat(a, b, c), concat(a, "b", "c") => concat(a, "bc"), result of concatenation is new string, so
+// concatenation with one part is kept to copy string
+struct JoinStringConcat : public OpRewritePattern<mlir_ts::StringConcatOp>
+{
+    using OpRewritePattern<mlir_ts::StringConcatOp>::OpRewritePattern;
+
+    LogicalResult matchAndRewrite(mlir_ts::StringConcatOp stringConcatOp, PatternRewriter &rewriter) const override
+    {
+        if (stringConcatOp->use_empty())
+        {
+            rewriter.eraseOp(stringConcatOp);
+            return success();
+        }
+
+        auto changed = false;
+        SmallVector<mlir::Value> ops;
+        for (auto op : stringConcatOp.ops())
+        {
+            if (auto partConcatOp = op.getDefiningOp<mlir_ts::StringConcatOp>())
+            {
+                if (op.hasOneUse() && !(partConcatOp.allocInStack().hasValue() && partConcatOp.allocInStack().getValue()))
+                {
+                    ops.append(partConcatOp.ops().begin(), partConcatOp.ops().end());
+                    changed = true;
+                    continue;
+                }
+            }
+
+            // empty string
+            if (auto constantOp = op.getDefiningOp<mlir_ts::ConstantOp>())
+            {
+                if (auto strAttr = constantOp.value().dyn_cast_or_null<StringAttr>())
+                {
+                    if (strAttr.getValue().empty() && stringConcatOp.ops().size() > 1)
+                    {
+                        changed = true;
+                        continue;
+                    }
+                }
+            }
+
+            // adjacent constant parts are joined into one constant
+            if (!ops.empty())
+            {
+                auto prevStrAttr = getConstantString(ops.back());
+                auto strAttr = getConstantString(op);
+                if (prevStrAttr && strAttr)
+                {
+                    ops.back() = rewriter.create<mlir_ts::ConstantOp>(
+                        stringConcatOp->getLoc(), stringConcatOp.getType(),
+                        rewriter.getStringAttr((prevStrAttr.getValue() + strAttr.getValue()).str()));
+                    changed = true;
+                    continue;
+                }
+            }
+
+            ops.push_back(op);
+        }
+
+        if (!changed || ops.empty())
+        {
+            return failure();
+        }
+
+        rewriter.replaceOpWithNewOp<mlir_ts::StringConcatOp>(stringConcatOp, stringConcatOp.getType(), ops,
+                                                             stringConcatOp.allocInStackAttr());
+        return success();
+    }
+};
+} // end anonymous namespace.
+
+void mlir_ts::StringConcatOp::getCanonicalizationPatterns(OwningRewritePatternList &results, MLIRContext *context)
+{
+    results.insert<JoinStringConcat>(context);
+}
+
+OpFoldResult mlir_ts::StringConcatOp::fold(ArrayRef<Attribute> operands)
+{
+    // concatenation with one part is copy of string
+    if (operands.size() < 2)
+    {
+        return {};
+    }
+
+    std::string value;
+    for (auto operand : operands)
+    {
+        auto strAttr = operand.dyn_cast_or_null<StringAttr>();
+        if (!strAttr)
+        {
+            return {};
+        }
+
+        value += strAttr.getValue().str();
+    }
+
+    return StringAttr::get(getContext(), value);
+}
+
+//===----------------------------------------------------------------------===//
+// StringCompareOp, StringLengthOp, LengthOfOp
+//===----------------------------------------------------------------------===//
+
+OpFoldResult mlir_ts::StringCompareOp::fold(ArrayRef<Attribute> operands)
+{
+    return foldCompare((SyntaxKind)code(), op1().getType(), operands[0], operands[1]);
+}
+
+OpFoldResult mlir_ts::StringLengthOp::fold(ArrayRef<Attribute> operands)
+{
+    if (auto strAttr = operands.front().dyn_cast_or_null<StringAttr>())
+    {
+        return IntegerAttr::get(getType(), strAttr.getValue().size());
+    }
+
+    return {};
+}
+
+OpFoldResult mlir_ts::LengthOfOp::fold(ArrayRef<Attribute> operands)
+{
+    auto value = operands.front();
+
+    // constant array is casted to array when it is assigned
+    if (!value)
+    {
+        if (auto castOp = op().getDefiningOp<mlir_ts::CastOp>())
+        {
+            if (auto constantOp = castOp.in().getDefiningOp<mlir_ts::ConstantOp>())
+            {
+                value = constantOp.value();
+            }
+        }
+    }
+
+    if (auto arrayAttr = value.dyn_cast_or_null<ArrayAttr>())
+    {
+        return IntegerAttr::get(getType(), arrayAttr.size());
+    }
+
+    return {};
+}
+
+//===----------------------------------------------------------------------===//
+// TypeOfOp
+//===----------------------------------------------------------------------===//
+
+// 'typeof' of value which type is known is constant, so type guards are removed by canonicalizer
+OpFoldResult mlir_ts::TypeOfOp::fold(ArrayRef<Attribute> operands)
+{
+    ::typescript::MLIRTypeHelper mth(getContext());
+    auto typeOfName = mth.getTypeOfName(value().getType());
+    if (typeOfName.empty())
+    {
+        return {};
+    }
+
+    return StringAttr::get(getContext(), typeOfName);
+}
+
+//===----------------------------------------------------------------------===//
+// GetThisOp, GetMethodOp
+//===----------------------------------------------------------------------===//
+
+namespace
+{
+// returns field reference if bound function is loaded by bound reference to field of object
+mlir_ts::PropertyRefOp getBoundRefPropertyRef(mlir::Value boundFunc)
+{
+    if (auto loadOp = boundFunc.getDefiningOp<mlir_ts::LoadOp>())
+    {
+        if (auto propertyRefOp = loadOp.reference().getDefiningOp<mlir_ts::PropertyRefOp>())
+        {
+            if (propertyRefOp.getType().isa<mlir_ts::BoundRefType>())
+            {
+                return propertyRefOp;
+            }
+        }
+    }
+
+    return mlir_ts::PropertyRefOp();
+}
+
+// removes load of bound function and bound reference when they are not used anymore
+void eraseUnusedBoundRef(mlir::Value boundFunc, PatternRewriter &rewriter)
+{
+    auto loadOp = boundFunc.getDefiningOp<mlir_ts::LoadOp>();
+    if (!loadOp || !loadOp.getResult().use_empty())
+    {
+        return;
+    }
+
+    auto propertyRefOp = loadOp.reference().getDefiningOp<mlir_ts::PropertyRefOp>();
+    rewriter.eraseOp(loadOp);
+    if (propertyRefOp && propertyRefOp.getResult().use_empty())
+    {
+        rewriter.eraseOp(propertyRefOp);
+    }
+}
+
+// true if op can be executed again after its parent op which is in region of variable, e.g. it is in loop
+bool isRepeatedInScopeOf(mlir::Operation *op, mlir::Operation *variableOp)
+{
+    auto *variableRegion = variableOp->getParentRegion();
+    for (auto *parentOp = op->getParentOp(); parentOp; parentOp = parentOp->getParentOp())
+    {
+        if (isa<mlir_ts::ForOp>(parentOp) || isa<mlir_ts::WhileOp>(parentOp) || isa<mlir_ts::DoWhileOp>(parentOp))
+        {
+            return true;
+        }
+
+        if (parentOp->getParentRegion() == variableRegion)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// method stored in object which is local copy of constant object literal (object value is copied in stack variable
+// to access its methods). Fields are never stored directly, so field can be changed only by method called with
+// object as 'this'. Such calls must be executed after loading method: they are after load in the same block and the
+// load is not repeated (by loop) after them.
+mlir::FlatSymbolRefAttr getConstMethod(mlir_ts::PropertyRefOp propertyRefOp, mlir::Operation *loadOp)
+{
+    auto variableOp = propertyRefOp.objectRef().getDefiningOp<mlir_ts::VariableOp>();
+    if (!variableOp || !variableOp.initializer() || (variableOp.captured().hasValue() && variableOp.captured().getValue()))
+    {
+        return mlir::FlatSymbolRefAttr();
+    }
+
+    if (variableOp->getBlock() == loadOp->getBlock() ? !variableOp->isBeforeInBlock(loadOp)
+                                                     : isRepeatedInScopeOf(loadOp, variableOp))
+    {
+        return mlir::FlatSymbolRefAttr();
+    }
+
+    auto constantOp = variableOp.initializer().getDefiningOp<mlir_ts::ConstantOp>();
+    if (!constantOp)
+    {
+        return mlir::FlatSymbolRefAttr();
+    }
+
+    auto fields = constantOp.value().dyn_cast_or_null<mlir::ArrayAttr>();
+    auto position = static_cast<size_t>(propertyRefOp.position());
+    if (!fields || position >= fields.size())
+    {
+        return mlir::FlatSymbolRefAttr();
+    }
+
+    for (auto *user : variableOp->getUsers())
+    {
+        if (auto fieldRefOp = dyn_cast<mlir_ts::PropertyRefOp>(user))
+        {
+            if (llvm::all_of(fieldRefOp->getUsers(), [](mlir::Operation *fieldUser) { return isa<mlir_ts::LoadOp>(fieldUser); }))
+            {
+                continue;
+            }
+
+            return mlir::FlatSymbolRefAttr();
+        }
+
+        // 'this' of method call, method can change object only after it is loaded
+        if (isa<mlir_ts::CastOp>(user) && user->getBlock() == loadOp->getBlock() && loadOp->isBeforeInBlock(user))
+        {
+            continue;
+        }
+
+        return mlir::FlatSymbolRefAttr();
+    }
+
+    return fields[position].dyn_cast<mlir::FlatSymbolRefAttr>();
+}
+
+// this of bound function loaded by bound reference is object of field
+struct GetThisOfBoundRef : public OpRewritePattern<mlir_ts::GetThisOp>
+{
+    using OpRewritePattern<mlir_ts::GetThisOp>::OpRewritePattern;
+
+    LogicalResult matchAndRewrite(mlir_ts::GetThisOp getThisOp, PatternRewriter &rewriter) const override
+    {
+        auto boundFunc = getThisOp.boundFunc();
+        auto propertyRefOp = getBoundRefPropertyRef(boundFunc);
+        if (!propertyRefOp)
+        {
+            return failure();
+        }
+
+        auto objectRef = propertyRefOp.objectRef();
+        auto objectType = objectRef.getType();
+        auto thisType = getThisOp.getType();
+        if (objectType == thisType)
+        {
+            rewriter.replaceOp(getThisOp, objectRef);
+        }
+        else if (thisType.isa<mlir_ts::OpaqueType>() &&
+                 (objectType.isa<mlir_ts::RefType>() || objectType.isa<mlir_ts::ObjectType>() || objectType.isa<mlir_ts::ClassType>()))
+        {
+            rewriter.replaceOpWithNewOp<mlir_ts::CastOp>(getThisOp, thisType, objectRef);
+        }
+        else
+        {
+            return failure();
+        }
+
+        eraseUnusedBoundRef(boundFunc, rewriter);
+        return success();
+    }
+};
+
+// method of bound function loaded by bound reference is value of field
+struct GetMethodOfBoundRef : public OpRewritePattern<mlir_ts::GetMethodOp>
+{
+    using OpRewritePattern<mlir_ts::GetMethodOp>::OpRewritePattern;
+
+    LogicalResult matchAndRewrite(mlir_ts::GetMethodOp getMethodOp, PatternRewriter &rewriter) const override
+    {
+        auto boundFunc = getMethodOp.boundFunc();
+        auto propertyRefOp = getBoundRefPropertyRef(boundFunc);
+        if (!propertyRefOp)
+        {
+            return failure();
+        }
+
+        auto methodType = propertyRefOp.getType().cast<mlir_ts::BoundRefType>().getElementType();
+        if (methodType != getMethodOp.getType())
+        {
+            return failure();
+        }
+
+        if (auto methodSymbol = getConstMethod(propertyRefOp, boundFunc.getDefiningOp()))
+        {
+            rewriter.replaceOpWithNewOp<mlir_ts::SymbolRefOp>(getMethodOp, methodType, methodSymbol);
+        }
+        else
+        {
+            // field is loaded where bound function was loaded, store between them must not change the method
+            OpBuilder::InsertionGuard insertGuard(rewriter);
+            rewriter.setInsertionPoint(boundFunc.getDefiningOp());
+            auto fieldRef = rewriter.create<mlir_ts::PropertyRefOp>(getMethodOp->getLoc(), mlir_ts::RefType::get(methodType),
+                                                                    propertyRefOp.objectRef(), propertyRefOp.positionAttr());
+            auto methodValue = rewriter.create<mlir_ts::LoadOp>(getMethodOp->getLoc(), methodType, fieldRef);
+            rewriter.replaceOp(getMethodOp, ValueRange{methodValue});
+        }
+
+        eraseUnusedBoundRef(boundFunc, rewriter);
+        return success();
+    }
+};
+} // end anonymous namespace.
+
+void mlir_ts::GetThisOp::getCanonicalizationPatterns(OwningRewritePatternList &results, MLIRContext *context)
+{
+    results.insert<GetThisOfBoundRef>(context);
+}
+
+void mlir_ts::GetMethodOp::getCanonicalizationPatterns(OwningRewritePatternList &results, MLIRContext *context)
+{
+    results.insert<GetMethodOfBoundRef>(context);
+}
+
 //===----------------------------------------------------------------------===//
 // SymbolCallInternalOp
 //===----------------------------------------------------------------------===//
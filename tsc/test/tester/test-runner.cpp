@@ -121,6 +121,8 @@ bool isJitCompile = false;
 bool enableBuiltins = false;
 bool noGC = false;
 bool asyncRuntime = false;
+// options starting with "--" are passed to tsc as is (f.e. --coroutines)
+std::string tscOptions;
 
 bool hasEnding(std::string const &fullString, std::string const &ending)
 {
@@ -240,7 +242,7 @@ void createCompileBatchFile()
     batFile << "set UCRTPATH=\"" << TEST_UCRTPATH << "\"" << std::endl;
     batFile << "set LLVM_EXEPATH=" << TEST_LLVM_EXEPATH << std::endl;
     batFile << "set TSCEXEPATH=" << TEST_TSC_EXEPATH << std::endl;
-    batFile << "%TSCEXEPATH%\\tsc.exe --emit=llvm " _OPT_ "%2 2> %FILENAME%.il" << std::endl;
+    batFile << "%TSCEXEPATH%\\tsc.exe --emit=llvm " _OPT_ "%2 %~3 2> %FILENAME%.il" << std::endl;
     batFile << "%LLVM_EXEPATH%\\llc.exe --filetype=obj -o=%FILENAME%.o %FILENAME%.il" << std::endl;
     batFile << "%LLVM_EXEPATH%\\lld.exe -flavor link %FILENAME%.o /libpath:%LIBPATH% /libpath:%SDKPATH% /libpath:%UCRTPATH% "
                "/defaultlib:libcmt" _D_ ".lib libvcruntime" _D_ ".lib"
@@ -272,7 +274,7 @@ void createCompileBatchFileWithAsyncRT()
     batFile << "set TSCEXEPATH=" << TEST_TSC_EXEPATH << std::endl;
     batFile << "set TSCLIBPATH=" << TEST_TSC_LIBPATH << std::endl;
     batFile << "set CLANGLIBPATH=" << TEST_CLANGLIBPATH << std::endl;
-    batFile << "%TSCEXEPATH%\\tsc.exe --emit=llvm " _OPT_ "%2 2> %FILENAME%.il" << std::endl;
+    batFile << "%TSCEXEPATH%\\tsc.exe --emit=llvm " _OPT_ "%2 %~3 2> %FILENAME%.il" << std::endl;
     batFile << "%LLVM_EXEPATH%\\llc.exe --filetype=obj -o=%FILENAME%.o %FILENAME%.il" << std::endl;
     batFile << "%LLVM_EXEPATH%\\lld.exe -flavor link %FILENAME%.o /libpath:%LIBPATH% /libpath:%SDKPATH% /libpath:%UCRTPATH% "
                "/libpath:%LLVM_LIBPATH% /libpath:%TSCLIBPATH% /defaultlib:libcmt" _D_ ".lib libvcruntime" _D_
@@ -303,7 +305,7 @@ void createCompileBatchFileGC()
     batFile << "set LLVM_EXEPATH=" << TEST_LLVM_EXEPATH << std::endl;
     batFile << "set TSCEXEPATH=" << TEST_TSC_EXEPATH << std::endl;
     batFile << "set GCLIBPATH=" << TEST_GCPATH << std::endl;
-    batFile << "%TSCEXEPATH%\\tsc.exe --emit=llvm " _OPT_ "%2 2> %FILENAME%.il" << std::endl;
+    batFile << "%TSCEXEPATH%\\tsc.exe --emit=llvm " _OPT_ "%2 %~3 2> %FILENAME%.il" << std::endl;
     batFile << "%LLVM_EXEPATH%\\llc.exe --filetype=obj -o=%FILENAME%.o %FILENAME%.il" << std::endl;
     batFile << "%LLVM_EXEPATH%\\lld.exe -flavor link %FILENAME%.o /libpath:%LIBPATH% /libpath:%SDKPATH% /libpath:%UCRTPATH% "
                "/libpath:%GCLIBPATH% msvcrt" _D_ ".lib ucrt" _D_ ".lib kernel32.lib user32.lib "
@@ -335,7 +337,7 @@ void createCompileBatchFileGCWithAsyncRT()
     batFile << "set TSCEXEPATH=" << TEST_TSC_EXEPATH << std::endl;
     batFile << "set TSCLIBPATH=" << TEST_TSC_LIBPATH << std::endl;
     batFile << "set GCLIBPATH=" << TEST_GCPATH << std::endl;
-    batFile << "%TSCEXEPATH%\\tsc.exe --emit=llvm " _OPT_ "%2 2> %FILENAME%.il" << std::endl;
+    batFile << "%TSCEXEPATH%\\tsc.exe --emit=llvm " _OPT_ "%2 %~3 2> %FILENAME%.il" << std::endl;
     batFile << "%LLVM_EXEPATH%\\llc.exe --filetype=obj -o=%FILENAME%.o %FILENAME%.il" << std::endl;
     batFile << "%LLVM_EXEPATH%\\lld.exe -flavor link %FILENAME%.o /libpath:%LIBPATH% /libpath:%SDKPATH% /libpath:%UCRTPATH% "
                "/libpath:%GCLIBPATH% /libpath:%LLVM_LIBPATH% /libpath:%TSCLIBPATH% "
@@ -366,7 +368,7 @@ void createJitCompileBatchFile()
     batFile << "set UCRTPATH=\"" << TEST_UCRTPATH << "\"" << std::endl;
     batFile << "set TSCEXEPATH=" << TEST_TSC_EXEPATH << std::endl;
     batFile << "%TSCEXEPATH%\\tsc.exe --emit=jit -nogc --shared-libs=%TSCEXEPATH%/TypeScriptRuntime.dll -dump-object-file "
-               "-object-filename=%FILENAME%.o %2"
+               "-object-filename=%FILENAME%.o %2 %~3"
             << std::endl;
     batFile << "%LLVM_EXEPATH%\\lld.exe -flavor link %FILENAME%.o /libpath:%LIBPATH% /libpath:%SDKPATH% /libpath:%UCRTPATH% "
                "/defaultlib:libcmt" _D_ ".lib libvcruntime" _D_ ".lib"
@@ -395,7 +397,7 @@ void createJitCompileBatchFileGC()
     batFile << "set UCRTPATH=\"" << TEST_UCRTPATH << "\"" << std::endl;
     batFile << "set TSCEXEPATH=" << TEST_TSC_EXEPATH << std::endl;
     batFile << "%TSCEXEPATH%\\tsc.exe --emit=jit --shared-libs=%TSCEXEPATH%/TypeScriptRuntime.dll -dump-object-file "
-               "-object-filename=%FILENAME%.o %2"
+               "-object-filename=%FILENAME%.o %2 %~3"
             << std::endl;
     batFile << "%LLVM_EXEPATH%\\lld.exe -flavor link %FILENAME%.o /libpath:%LIBPATH% /libpath:%SDKPATH% /libpath:%UCRTPATH% "
                "/defaultlib:libcmt" _D_ ".lib libvcruntime" _D_ ".lib"
@@ -422,7 +424,7 @@ void createJitBatchFile()
     batFile << "set TSCEXEPATH=" << TEST_TSC_EXEPATH << std::endl;
     batFile << "echo on" << std::endl;
     batFile
-        << "%TSCEXEPATH%\\tsc.exe --emit=jit -nogc --shared-libs=%LLVMPATH%/TypeScriptRuntime.dll %2 1> %FILENAME%.txt 2> %FILENAME%.err"
+        << "%TSCEXEPATH%\\tsc.exe --emit=jit -nogc --shared-libs=%LLVMPATH%/TypeScriptRuntime.dll %2 %~3 1> %FILENAME%.txt 2> %FILENAME%.err"
         << std::endl;
     batFile.close();
 }
@@ -441,7 +443,7 @@ void createJitBatchFileGC()
     batFile << "set FILENAME=%1" << std::endl;
     batFile << "set TSCEXEPATH=" << TEST_TSC_EXEPATH << std::endl;
     batFile << "echo on" << std::endl;
-    batFile << "%TSCEXEPATH%\\tsc.exe --emit=jit --shared-libs=%TSCEXEPATH%/TypeScriptRuntime.dll %2 1> %FILENAME%.txt 2> %FILENAME%.err"
+    batFile << "%TSCEXEPATH%\\tsc.exe --emit=jit --shared-libs=%TSCEXEPATH%/TypeScriptRuntime.dll %2 %~3 1> %FILENAME%.txt 2> %FILENAME%.err"
             << std::endl;
     batFile.close();
 }
@@ -458,7 +460,7 @@ void createCompileBatchFile()
     std::ofstream batFile("compile.sh");
     batFile << "FILENAME=$1" << std::endl;
     batFile << "TSCEXEPATH=" << TEST_TSC_EXEPATH << std::endl;
-    batFile << "$TSCEXEPATH/tsc --emit=llvm " _OPT_ "-nogc $2 2>$FILENAME.il" << std::endl;
+    batFile << "$TSCEXEPATH/tsc --emit=llvm " _OPT_ "-nogc $2 $3 2>$FILENAME.il" << std::endl;
     batFile << "/usr/bin/llc-12 -relocation-model=pic --filetype=obj -o=$FILENAME.o $FILENAME.il" << std::endl;
     batFile << "gcc -o $FILENAME $FILENAME.o -lm -frtti -fexceptions -lstdc++" << std::endl;
     batFile << "./$FILENAME 1> $FILENAME.txt 2> $FILENAME.err" << std::endl;
@@ -481,7 +483,7 @@ void createCompileBatchFileWithAsyncRT()
     batFile << "TSCEXEPATH=" << TEST_TSC_EXEPATH << std::endl;
     batFile << "TSCLIBPATH=" << TEST_TSC_LIBPATH << std::endl;
     batFile << "LLVM_LIBPATH=" << TEST_LLVM_LIBPATH << std::endl;
-    batFile << "$TSCEXEPATH/tsc --emit=llvm " _OPT_ "-nogc $2 2>$FILENAME.il" << std::endl;
+    batFile << "$TSCEXEPATH/tsc --emit=llvm " _OPT_ "-nogc $2 $3 2>$FILENAME.il" << std::endl;
     batFile << "/usr/bin/llc-12 -relocation-model=pic --filetype=obj -o=$FILENAME.o $FILENAME.il" << std::endl;
     batFile << "gcc -o $FILENAME $FILENAME.o -L$LLVM_LIBPATH -L$TSCLIBPATH " << TYPESCRIPT_ASYNC_LIB << " " << LIBS << std::endl;
     batFile << "./$FILENAME 1> $FILENAME.txt 2> $FILENAME.err" << std::endl;
@@ -503,7 +505,7 @@ void createCompileBatchFileGC()
     batFile << "FILENAME=$1" << std::endl;
     batFile << "TSCEXEPATH=" << TEST_TSC_EXEPATH << std::endl;
     batFile << "GCLIBPATH=" << TEST_GCPATH << std::endl;
-    batFile << "$TSCEXEPATH/tsc --emit=llvm " _OPT_ "$2 2>$FILENAME.il" << std::endl;
+    batFile << "$TSCEXEPATH/tsc --emit=llvm " _OPT_ "$2 $3 2>$FILENAME.il" << std::endl;
     batFile << "/usr/bin/llc-12 -relocation-model=pic --filetype=obj -o=$FILENAME.o $FILENAME.il" << std::endl;
     batFile << "gcc -o $FILENAME -L$GCLIBPATH $FILENAME.o " << GC_LIB << " " << LIBS << std::endl;
     batFile << "./$FILENAME 1> $FILENAME.txt 2> $FILENAME.err" << std::endl;
@@ -528,7 +530,7 @@ void createCompileBatchFileGCWithAsyncRT()
     batFile << "LLVM_LIBPATH=" << TEST_LLVM_LIBPATH << std::endl;
     batFile << "GCLIBPATH=" << TEST_GCPATH << std::endl;
     batFile << "CLANGLIBPATH=" << TEST_CLANGLIBPATH << std::endl;
-    batFile << "$TSCEXEPATH/tsc --emit=llvm " _OPT_ "$2 2>$FILENAME.il" << std::endl;
+    batFile << "$TSCEXEPATH/tsc --emit=llvm " _OPT_ "$2 $3 2>$FILENAME.il" << std::endl;
     batFile << "/usr/bin/llc-12 -relocation-model=pic --filetype=obj -o=$FILENAME.o $FILENAME.il" << std::endl;
     batFile << "gcc -o $FILENAME -L$LLVM_LIBPATH -L$GCLIBPATH -L$TSCLIBPATH -L$CLANGLIBPATH $FILENAME.o " << GC_LIB
             << " " TYPESCRIPT_ASYNC_LIB << " " << LIBS << std::endl;
@@ -552,7 +554,7 @@ void createJitCompileBatchFile()
     batFile << "LLVMPATH=" << TEST_LLVM_EXEPATH << std::endl;
     batFile << "TSCEXEPATH=" << TEST_TSC_EXEPATH << std::endl;
     batFile << "$TSCEXEPATH/tsc --emit=jit " _OPT_ " -nogc --shared-libs=../../lib/libTypeScriptRuntime.so -dump-object-file "
-               "-object-filename=$FILENAME.o $2"
+               "-object-filename=$FILENAME.o $2 $3"
             << std::endl;
     batFile << "gcc -o $FILENAME $FILENAME.o"
             << " " << LIBS << std::endl;
@@ -577,7 +579,7 @@ void createJitCompileBatchFileGC()
     batFile << "TSCEXEPATH=" << TEST_TSC_EXEPATH << std::endl;
     batFile << "GCLIBPATH=" << TEST_GCPATH << std::endl;
     batFile << "$TSCEXEPATH/tsc --emit=jit " _OPT_
-               " --shared-libs=../../lib/libTypeScriptRuntime.so -dump-object-file -object-filename=$FILENAME.o $2"
+               " --shared-libs=../../lib/libTypeScriptRuntime.so -dump-object-file -object-filename=$FILENAME.o $2 $3"
             << std::endl;
     batFile << "gcc -o $FILENAME -L$GCLIBPATH $FILENAME.o " << GC_LIB << " " << LIBS << std::endl;
     batFile << "./$FILENAME 1> $FILENAME.txt 2> $FILENAME.err" << std::endl;
@@ -600,7 +602,7 @@ void createJitBatchFile()
     batFile << "LLVMPATH=" << TEST_LLVM_EXEPATH << std::endl;
     batFile << "TSCEXEPATH=" << TEST_TSC_EXEPATH << std::endl;
     batFile << "$TSCEXEPATH/tsc --emit=jit " _OPT_
-               " -nogc --shared-libs=../../lib/libTypeScriptRuntime.so $2 1> $FILENAME.txt 2> $FILENAME.err"
+               " -nogc --shared-libs=../../lib/libTypeScriptRuntime.so $2 $3 1> $FILENAME.txt 2> $FILENAME.err"
             << std::endl;
     batFile.close();
 }
@@ -618,7 +620,7 @@ void createJitBatchFileGC()
     batFile << "FILENAME=$1" << std::endl;
     batFile << "LLVMPATH=" << TEST_LLVM_EXEPATH << std::endl;
     batFile << "TSCEXEPATH=" << TEST_TSC_EXEPATH << std::endl;
-    batFile << "$TSCEXEPATH/tsc --emit=jit " _OPT_ " --shared-libs=../../lib/libTypeScriptRuntime.so $2 1> $FILENAME.txt 2> $FILENAME.err"
+    batFile << "$TSCEXEPATH/tsc --emit=jit " _OPT_ " --shared-libs=../../lib/libTypeScriptRuntime.so $2 $3 1> $FILENAME.txt 2> $FILENAME.err"
             << std::endl;
     batFile.close();
 }
@@ -755,6 +757,11 @@ void testFile(const char *file)
         }
     }
 
+    if (!tscOptions.empty())
+    {
+        ss << " \"" << tscOptions << "\"";
+    }
+
     try
     {
         auto compileResult = exec(ss.str());
@@ -814,6 +821,10 @@ int main(int argc, char **argv)
             {
                 asyncRuntime = true;
             }
+            else if (std::string(argv[index]).rfind("--", 0) == 0)
+            {
+                tscOptions += tscOptions.empty() ? argv[index] : std::string(" ") + argv[index];
+            }
             else
             {
                 filePath = argv[index];
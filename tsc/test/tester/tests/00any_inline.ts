@@ -0,0 +1,58 @@
+type int = TypeOf<1>;
+
+class Point {
+    constructor(public x: number, public y: number) {}
+}
+
+function main() {
+    let sum = 0;
+    for (let i = 0; i < 1000; i++) {
+        const n = <any>(i + 0.5);
+        sum += <number>n;
+    }
+
+    print(sum);
+    assert(sum == 500000);
+
+    const nan = <any>(0 / 0);
+    assert(typeof nan == "number");
+    const nanBack = <number>nan;
+    assert(nanBack != nanBack);
+
+    const neg = <any>-1.25;
+    assert(<number>neg == -1.25);
+
+    const b = <any>true;
+    print(typeof b);
+    assert(typeof b == "boolean");
+    assert(<boolean>b);
+
+    const a = 1;
+    const aAny = <any>a;
+    assert(typeof aAny == typeof a);
+    assert(<int>aAny == 1);
+
+    const s = "string value";
+    const sAny = <any>s;
+    assert(typeof sAny == "string");
+    assert(<string>sAny == s);
+
+    // allocated string and class instance are stored as pointers with kind in low bits
+    let built = "";
+    for (let i = 0; i < 3; i++) {
+        built = built + "ab";
+    }
+
+    const builtAny = <any>built;
+    assert(typeof builtAny == "string");
+    assert(<string>builtAny == "ababab");
+
+    const p = new Point(1, 2);
+    const pAny = <any>p;
+    print(typeof pAny);
+    const pBack = <Point>pAny;
+    assert(pBack.x == 1 && pBack.y == 2);
+    assert(pBack === p);
+
+    print("done.");
+}
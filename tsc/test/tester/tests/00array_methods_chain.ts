@@ -0,0 +1,70 @@
+function test_chain() {
+    const arr = [1, 2, 3, 4, 5, 6];
+
+    const sum = arr.map(x => x * 10).filter(x => x > 20).reduce((s, v) => s + v, 0);
+    assert(sum == 180, "map-filter-reduce");
+
+    let calls = 0;
+    const evens = arr.filter(x => x % 2 == 0).map(x => { calls++; return x + 1; });
+    assert(calls == 3, "map after filter");
+    assert(evens.length == 3, "filter-map length");
+    assert(evens[0] == 3 && evens[2] == 7, "filter-map values");
+}
+
+function test_chain_order() {
+    const arr = [1, 2, 3];
+
+    let log = "";
+    const r = arr.map(x => { log += "m" + x; return x * 2; }).filter(x => { log += "f" + x; return x > 2; });
+    assert(log == "m1m2m3f2f4f6", "callbacks run stage by stage");
+    assert(r.length == 2 && r[0] == 4 && r[1] == 6, "map-filter values");
+
+    let n = 0;
+    const inc = (x: number) => { n++; return x + n; };
+    const s = arr.map(inc).reduce((acc, v) => acc + v + n, 0);
+    assert(n == 3, "map runs before reduce");
+    assert(s == 21, "reduce sees state after map");
+}
+
+function test_map() {
+    const arr = [1, 2, 3];
+    const doubled = arr.map(x => x * 2);
+    assert(doubled.length == 3, "map length");
+    assert(doubled[0] == 2 && doubled[1] == 4 && doubled[2] == 6, "map values");
+
+    doubled.push(8);
+    assert(doubled.length == 4 && doubled[3] == 8, "push to map result");
+
+    const strs = arr.map(x => "v" + x);
+    assert(strs[2] == "v3", "map to string");
+}
+
+function test_every_some() {
+    const arr = [1, 2, 3, 4];
+
+    let visited = 0;
+    assert(!arr.every(x => { visited++; return x < 2; }), "every");
+    assert(visited == 2, "every stops early");
+
+    visited = 0;
+    assert(arr.some(x => { visited++; return x == 3; }), "some");
+    assert(visited == 3, "some stops early");
+
+    assert(arr.map(x => x - 1).every(x => x < 4), "map-every");
+    assert(!arr.filter(x => x > 2).some(x => x == 1), "filter-some");
+}
+
+function test_foreach() {
+    let r = 0;
+    [1, 2, 3].map(x => x * x).forEach(x => { r += x; });
+    assert(r == 14, "map-forEach");
+}
+
+function main() {
+    test_chain();
+    test_chain_order();
+    test_map();
+    test_every_some();
+    test_foreach();
+    print("done.");
+}
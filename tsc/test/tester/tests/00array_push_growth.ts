@@ -0,0 +1,67 @@
+function test_push_many() {
+    let a: number[] = [];
+    for (let i = 0; i < 10000; i++) {
+        assert(a.push(i) == i + 1, "push count");
+    }
+
+    assert(a.length == 10000, "length");
+    assert(a[0] == 0, "first");
+    assert(a[5000] == 5000, "middle");
+    assert(a[9999] == 9999, "last");
+}
+
+function test_pop_push() {
+    let a: number[] = [];
+    a.push(1);
+    a.push(2);
+    a.push(3);
+    assert(a.pop() == 3, "pop");
+    assert(a.pop() == 2, "pop");
+    a.push(4);
+    assert(a.length == 2, "length after pop/push");
+    assert(a[0] == 1 && a[1] == 4, "values after pop/push");
+}
+
+function test_push_to_const() {
+    let a = [1, 2, 3];
+    a.push(4);
+    a.push(5);
+    assert(a.length == 5, "length");
+    assert(a[0] == 1 && a[2] == 3 && a[4] == 5, "values");
+
+    // data of other array is not changed
+    let b = [1, 2, 3];
+    assert(b.length == 3, "other length");
+    assert(b[2] == 3, "other value");
+}
+
+function test_pop_all_then_push_to_const() {
+    let a = [1];
+    assert(a.pop() == 1, "pop");
+    assert(a.length == 0, "empty");
+    a.push(2);
+    a.push(3);
+    assert(a.length == 2, "length after push");
+    assert(a[0] == 2 && a[1] == 3, "values after push");
+
+    // data of other array is not changed
+    let b = [1];
+    assert(b.length == 1 && b[0] == 1, "other array");
+}
+
+function test_spread() {
+    let a = [1, 2];
+    let b = [3, 4, 5];
+    let c = [...a, ...b, 6];
+    assert(c.length == 6, "spread length");
+    assert(c[0] == 1 && c[2] == 3 && c[5] == 6, "spread values");
+}
+
+function main() {
+    test_push_many();
+    test_pop_push();
+    test_push_to_const();
+    test_pop_all_then_push_to_const();
+    test_spread();
+    print("done.");
+}
@@ -0,0 +1,74 @@
+let shape_area = 0;
+
+abstract class Shape {
+    abstract area(): number;
+
+    name() {
+        return "shape";
+    }
+}
+
+class Square extends Shape {
+    constructor(public side: number) {
+        super();
+    }
+
+    area() {
+        shape_area++;
+        return this.side * this.side;
+    }
+}
+
+class Circle extends Shape {
+    constructor(public r: number) {
+        super();
+    }
+
+    area() {
+        shape_area++;
+        return 3 * this.r * this.r;
+    }
+
+    name() {
+        return "circle";
+    }
+}
+
+class Counter {
+    count = 0;
+
+    inc(step: number) {
+        this.count += step;
+    }
+}
+
+function totalArea(shapes: Shape[]) {
+    let total = 0;
+    for (const s of shapes) {
+        // two targets: Square.area, Circle.area
+        total += s.area();
+    }
+
+    return total;
+}
+
+function main() {
+    // one target
+    const c = new Counter();
+    for (let i = 0; i < 10; i++) {
+        c.inc(2);
+    }
+
+    assert(c.count == 20);
+
+    const shapes: Shape[] = [new Square(2), new Circle(1), new Square(3)];
+    assert(totalArea(shapes) == 16);
+    assert(shape_area == 3);
+
+    const sq: Shape = new Square(1);
+    const ci: Shape = new Circle(1);
+    assert(sq.name() == "shape");
+    assert(ci.name() == "circle");
+
+    print("done.");
+}
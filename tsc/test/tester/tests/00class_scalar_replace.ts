@@ -0,0 +1,33 @@
+class Point {
+    x: number;
+    y: number;
+}
+
+function area(count: number) {
+    let total = 0;
+    for (let i = 0; i < count; i++) {
+        // fields of instance are kept in registers
+        const p = new Point();
+        p.x = i;
+        p.y = 2;
+        if (p.x > 0) {
+            total += p.x * p.y;
+        }
+
+        p.y = 3;
+        total += p.y;
+    }
+
+    return total;
+}
+
+function main() {
+    assert(area(10) == 2 * 45 + 3 * 10);
+
+    const q = new Point();
+    q.x = 1;
+    q.y = q.x + 1;
+    assert(q.y == 2);
+
+    print("done.");
+}
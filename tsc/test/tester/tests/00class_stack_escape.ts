@@ -0,0 +1,57 @@
+class Vector {
+    constructor(public x: number, public y: number, public z: number) {}
+
+    add(v: Vector) {
+        return new Vector(this.x + v.x, this.y + v.y, this.z + v.z);
+    }
+
+    dot(v: Vector) {
+        return this.x * v.x + this.y * v.y + this.z * v.z;
+    }
+}
+
+let kept: Vector;
+
+function keep(v: Vector) {
+    kept = v;
+}
+
+function sum(count: number) {
+    let total = 0;
+    for (let i = 0; i < count; i++) {
+        // temporaries do not outlive iteration
+        const a = new Vector(i, 1, 2);
+        const b = new Vector(1, i, 3);
+        total += a.add(b).dot(new Vector(1, 1, 1));
+    }
+
+    return total;
+}
+
+function apply(count: number) {
+    let calls = 0;
+    const inc = () => {
+        calls++;
+    };
+
+    for (let i = 0; i < count; i++) {
+        inc();
+    }
+
+    return calls;
+}
+
+function main() {
+    // sum of (i + 1) + (1 + i) + 5
+    assert(sum(100) == 100 * 7 + 2 * 4950);
+
+    const v = new Vector(1, 2, 3);
+    keep(v);
+    const w = new Vector(4, 5, 6);
+    keep(w.add(v));
+    assert(kept.x == 5 && kept.y == 7 && kept.z == 9);
+
+    assert(apply(10) == 10);
+
+    print("done.");
+}
@@ -0,0 +1,44 @@
+const KB = 1024;
+const MB = KB * KB;
+const PREFIX = "config";
+const NAME = PREFIX + "." + "value";
+const ITEMS = [1, 2, 3, 4];
+
+function arithmetic() {
+    assert(MB == 1048576);
+    assert(MB / KB == 1024);
+    assert(7 % 3 == 1);
+    assert(-(2 - 5) == 3);
+    assert(2 ** 10 == 1024);
+    assert(KB >> 2 == 256);
+    assert((1 + 2) * 3 > 8);
+    assert(!(1 > 2));
+}
+
+function strings() {
+    assert(NAME == "config.value");
+    assert(NAME.length == 12);
+    assert("a" < "b");
+    assert("abc" != "abd");
+    assert("size: " + 5 == "size: 5");
+    assert("" + true == "true");
+    assert("x" + 1.5 + "y" == "x1.5y");
+}
+
+function length() {
+    assert(ITEMS.length == 4);
+
+    let total = 0;
+    for (let i = 0; i < ITEMS.length; i++) {
+        total += ITEMS[i];
+    }
+
+    assert(total == 10);
+}
+
+function main() {
+    arithmetic();
+    strings();
+    length();
+    print("done.");
+}
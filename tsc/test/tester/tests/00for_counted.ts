@@ -0,0 +1,83 @@
+// counted loops which are lowered into structured loops (with --opt)
+function dot(a: number[], b: number[]) {
+    let s = 0;
+    for (let i = 0; i < a.length; i++) {
+        s += a[i] * b[i];
+    }
+
+    return s;
+}
+
+function fill(n: number) {
+    let arr: number[] = [];
+    for (let i = 0; i < n; i++) {
+        arr.push(i);
+    }
+
+    return arr;
+}
+
+function main() {
+    assert(dot([1, 2, 3], [4, 5, 6]) == 32, "failed. 1");
+
+    let total = 0;
+    for (let i = 0; i < 4; i++) {
+        for (let j = 0; j <= i; j++) {
+            total += j;
+        }
+    }
+
+    assert(total == 10, "failed. 2");
+
+    let grid = 0;
+    for (let i = 0; i < 3; i++) {
+        for (let j = 0; j <= 2; j++) {
+            grid += i * 3 + j;
+        }
+    }
+
+    assert(grid == 36, "failed. 2.1");
+
+    let c = 0;
+    let k = 0;
+    for (k = 1; k <= 10; k += 2) {
+        c++;
+    }
+
+    assert(c == 5, "failed. 3");
+    assert(k == 11, "failed. 4");
+
+    let e = 0;
+    for (k = 5; k < 3; k++) {
+        e++;
+    }
+
+    assert(e == 0, "failed. 5");
+    assert(k == 5, "failed. 6");
+
+    const arr = fill(100);
+    assert(arr.length == 100, "failed. 7");
+    assert(arr[99] == 99, "failed. 8");
+
+    // bound is changed in body, loop is not counted
+    let p = [1, 2, 3, 4];
+    let n = 0;
+    for (let i = 0; i < p.length; i++) {
+        p.pop();
+        n++;
+    }
+
+    assert(n == 2, "failed. 9");
+
+    let q = [1, 2, 3, 4];
+    const shrink = () => { q.pop(); };
+    let m = 0;
+    for (let i = 0; i < q.length; i++) {
+        shrink();
+        m++;
+    }
+
+    assert(m == 2, "failed. 10");
+
+    print("done.");
+}
@@ -0,0 +1,55 @@
+// loop counters which can be narrowed to integers (with --opt)
+function sum(arr: number[]) {
+    let s = 0;
+    for (let i = 0; i < arr.length; i++) {
+        s += arr[i];
+    }
+
+    return s;
+}
+
+function sumBackward(arr: number[]) {
+    let s = 0;
+    for (let i = arr.length - 1; i >= 0; i--) {
+        s += arr[i];
+    }
+
+    return s;
+}
+
+function main() {
+    const arr = [1, 2, 3, 4, 5];
+    assert(sum(arr) == 15, "failed. 1");
+    assert(sumBackward(arr) == 15, "failed. 2");
+
+    let c = 0;
+    let i = 0;
+    for (i = 0; i < 10; i += 3) {
+        c++;
+    }
+
+    assert(c == 4, "failed. 3");
+    assert(i == 12, "failed. 4");
+    assert(i / 8 == 1.5, "failed. 5");
+
+    let k = 2147483640;
+    for (; k <= 2147483647; k++) {}
+
+    assert(k == 2147483648, "failed. 6");
+
+    let z = -0;
+    for (let j = 0; j < 1; j++) {
+        z = z * 1;
+    }
+
+    assert(1 / z < 0, "failed. 7");
+
+    // initialized by first store, not by declaration
+    let u: number;
+    u = 0;
+    for (; u < 3; u++) {}
+
+    assert(u == 3, "failed. 8");
+
+    print("done.");
+}
@@ -0,0 +1,30 @@
+function apply(f: (v: number) => number, v: number) {
+    return f(v);
+}
+
+function test_create_in_loop() {
+    let sum = 0;
+    for (let i = 0; i < 100000; i++) {
+        const k = i % 10;
+        sum += apply((v: number) => v + k, 1);
+    }
+
+    assert(sum == 550000);
+}
+
+function test_keep_closures() {
+    let base = 10;
+    let f1 = (v: number) => v + base;
+    let f2 = (v: number) => v * base;
+
+    base = 2;
+    assert(f1(1) == 3);
+    assert(f2(3) == 6);
+    assert(apply(f1, 1) + apply(f2, 1) == 5);
+}
+
+function main() {
+    test_create_in_loop();
+    test_keep_closures();
+    print("done.");
+}
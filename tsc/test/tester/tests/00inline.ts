@@ -0,0 +1,86 @@
+class Vector {
+    _x: number;
+    _y: number;
+
+    constructor(x: number, y: number) {
+        this._x = x;
+        this._y = y;
+    }
+
+    get x() {
+        return this._x;
+    }
+    set x(value: number) {
+        this._x = value;
+    }
+
+    get y() {
+        return this._y;
+    }
+
+    static dot(a: Vector, b: Vector) {
+        return a.x * b.x + a.y * b.y;
+    }
+
+    static _count: number;
+
+    static get count() {
+        return this._count;
+    }
+
+    static set count(value: number) {
+        this._count = value;
+    }
+}
+
+function sqr(v: number) {
+    return v * v;
+}
+
+function clamp(v: number, min: number, max: number) {
+    if (v < min) {
+        return min;
+    }
+
+    if (v > max) {
+        return max;
+    }
+
+    return v;
+}
+
+// recursive function is not inlined into itself
+function fact(n: number): number {
+    return n <= 1 ? 1 : n * fact(n - 1);
+}
+
+function sum(count: number) {
+    let total = 0;
+    for (let i = 0; i < count; i++) {
+        const v = new Vector(i, 2);
+        v.x = v.x + 1;
+        total += Vector.dot(v, v);
+    }
+
+    return total;
+}
+
+function main() {
+    assert(sqr(3) == 9);
+    assert(sqr(sqr(2)) == 16);
+
+    assert(clamp(5, 0, 3) == 3);
+    assert(clamp(-1, 0, 3) == 0);
+    assert(clamp(2, 0, 3) == 2);
+
+    assert(fact(5) == 120);
+
+    // (i + 1)^2 + 4 for i in 0..3
+    assert(sum(4) == 1 + 4 + 9 + 16 + 4 * 4);
+
+    Vector.count = 3;
+    Vector.count = Vector.count + 1;
+    assert(Vector.count == 4);
+
+    print("done.");
+}
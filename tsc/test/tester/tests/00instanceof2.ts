@@ -0,0 +1,49 @@
+class Animal { }
+
+class Mammal extends Animal { }
+
+class Dog extends Mammal { }
+
+class Cat extends Mammal { }
+
+class Bird extends Animal { }
+
+class Stone { }
+
+function isMammal(a: any) {
+    return a instanceof Mammal;
+}
+
+function main() {
+    const animal: Animal = new Dog();
+    assert(animal instanceof Animal);
+    assert(animal instanceof Mammal);
+    assert(animal instanceof Dog);
+    assert(!(animal instanceof Cat));
+    assert(!(animal instanceof Bird));
+
+    const bird: Animal = new Bird();
+    assert(bird instanceof Animal);
+    assert(!(bird instanceof Mammal));
+    assert(!(bird instanceof Dog));
+
+    const mammal: Mammal = new Cat();
+    assert(mammal instanceof Cat);
+    assert(!(mammal instanceof Dog));
+
+    assert(isMammal(new Dog()));
+    assert(isMammal(new Cat()));
+    assert(!isMammal(new Bird()));
+    assert(!isMammal(new Stone()));
+    assert(!isMammal(1));
+
+    let count = 0;
+    const animals: Animal[] = [new Dog(), new Cat(), new Bird(), new Animal()];
+    for (const a of animals) {
+        if (a instanceof Mammal) count++;
+    }
+
+    assert(count == 2);
+
+    print("done.");
+}
@@ -0,0 +1,37 @@
+// results of bitwise operators are 32-bit integers, variables which store only them are narrowed to i32 (with --opt)
+function bitwise(x: number) {
+    let a: number = x | 0;
+    let b: number = a & 0xff;
+    let c: number = a ^ b;
+    let d: number = c >> 4;
+    return a + b + c + d;
+}
+
+function index(arr: number[], x: number) {
+    let i: number = x | 0;
+    return arr[i];
+}
+
+// can have fraction or be out of range of i32, these variables stay 'number'
+function staysNumber(x: number) {
+    let half: number = (x | 0) / 2;
+    assert(half == 3.5, "failed. half");
+
+    let shifted: number = (x | 0) + 0.5;
+    assert(shifted == 7.5, "failed. shifted");
+
+    let big: number = (x | 0) * 4294967296.0;
+    assert(big == 30064771072, "failed. big");
+}
+
+function main() {
+    assert(bitwise(1000.75) == 2048, "failed. 1");
+    assert(bitwise(-5.5) == -26, "failed. 2");
+
+    const arr = [10, 20, 30];
+    assert(index(arr, 1.5) == 20, "failed. 3");
+
+    staysNumber(7.9);
+
+    print("done.");
+}
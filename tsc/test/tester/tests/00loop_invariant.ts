@@ -0,0 +1,82 @@
+class Counter {
+    count = 0;
+    step = 2;
+
+    next() {
+        return this.step;
+    }
+}
+
+class Doubler extends Counter {
+    next() {
+        return this.step * 2;
+    }
+}
+
+function arrayLength() {
+    const items = [1, 2, 3, 4, 5];
+    let total = 0;
+    for (let i = 0; i < 10; i++) {
+        // length of array is the same in each iteration
+        total += items.length;
+    }
+
+    assert(total == 50);
+}
+
+function fields(c: Counter) {
+    for (let i = 0; i < 10; i++) {
+        // field is changed in loop, it must be reloaded in each iteration
+        c.count += c.next();
+        if (i == 4) c.step = 1;
+    }
+
+    return c.count;
+}
+
+function strings() {
+    const s = "loop";
+    let total = 0;
+    for (let i = 0; i < 8; i++) {
+        total += s.length;
+        if (typeof s == "string") total++;
+    }
+
+    assert(total == 40);
+}
+
+class Named {
+    name = "a";
+}
+
+// compare of strings reads them, it is not moved over assignment of field
+function stringCompare(n: Named) {
+    let matches = 0;
+    for (let i = 0; i < 6; i++) {
+        if (n.name == "b") matches++;
+        if (i == 2) n.name = "b";
+    }
+
+    return matches;
+}
+
+// division by zero which is never executed must stay in loop
+function guardedDivision(d: number) {
+    let total = 0;
+    for (let i = 0; i < 8; i++) {
+        if (d != 0) total += i % d;
+    }
+
+    return total;
+}
+
+function main() {
+    arrayLength();
+    assert(fields(new Counter()) == 15);
+    assert(fields(new Doubler()) == 30);
+    strings();
+    assert(stringCompare(new Named()) == 3);
+    assert(guardedDivision(0) == 0);
+    assert(guardedDivision(3) == 7);
+    print("done.");
+}
@@ -0,0 +1,110 @@
+let glb1 = 0;
+
+function add(a: number, b: number) {
+    return a + b;
+}
+
+// recursive functions without throw can not throw
+function fib(n: number): number {
+    return n < 2 ? n : fib(n - 1) + fib(n - 2);
+}
+
+function check(v: number) {
+    if (v < 0) {
+        throw v;
+    }
+
+    return v;
+}
+
+// calls function which may throw
+function checkTwice(v: number) {
+    return check(v) + check(v);
+}
+
+class Checked {
+    _v: number;
+
+    constructor() {
+        this._v = -1;
+    }
+
+    get value() {
+        if (this._v < 0) {
+            throw this._v;
+        }
+
+        return this._v;
+    }
+}
+
+// calls throwing getter
+function readValue(o: Checked) {
+    return o.value;
+}
+
+function main1() {
+    let c = 0;
+
+    // no landing pad is needed
+    try {
+        c = add(c, 1);
+        c = add(c, fib(10));
+    } finally {
+        c++;
+    }
+
+    assert(c == 57);
+}
+
+function main2() {
+    let c = 0;
+
+    try {
+        c = add(c, checkTwice(1));
+        c = add(c, checkTwice(-1));
+        c = 100;
+    } catch (e: number) {
+        c = add(c, 10);
+    }
+
+    assert(c == 12);
+}
+
+function main3() {
+    glb1 = 0;
+
+    try {
+        try {
+            glb1 = add(glb1, 1);
+            check(-2);
+        } finally {
+            glb1 = add(glb1, 1);
+        }
+    } catch {
+        glb1++;
+    }
+
+    assert(glb1 == 3);
+}
+
+function main4() {
+    let c = 0;
+
+    try {
+        c = readValue(new Checked());
+        c = 100;
+    } catch (e: number) {
+        c = e;
+    }
+
+    assert(c == -1);
+}
+
+function main() {
+    main1();
+    main2();
+    main3();
+    main4();
+    print("done.");
+}
@@ -0,0 +1,69 @@
+function str(n: number) {
+    return "" + n;
+}
+
+function test_to_string() {
+    assert(str(0) == "0");
+    assert(str(7) == "7");
+    assert(str(-42) == "-42");
+    assert(str(1234567890) == "1234567890");
+    assert(str(9007199254740991) == "9007199254740991");
+    assert(str(-0.0) == "0");
+
+    assert(str(0.1) == "0.1");
+    assert(str(0.5) == "0.5");
+    assert(str(-2.25) == "-2.25");
+    assert(str(0.1 + 0.2) == "0.30000000000000004");
+    assert(str(1 / 3) == "0.3333333333333333");
+
+    assert(str(123.456) == "123.456");
+    assert(str(0.000001) == "0.000001");
+    assert(str(1e-7) == "1e-7");
+    assert(str(-1e-7) == "-1e-7");
+    assert(str(1.5e-10) == "1.5e-10");
+    assert(str(1e20) == "100000000000000000000");
+    assert(str(1152921504606846976) == "1152921504606847000");
+    assert(str(1e21) == "1e+21");
+    assert(str(-2.5e300) == "-2.5e+300");
+
+    assert(str(0 / 0) == "NaN");
+    assert(str(1 / 0) == "Infinity");
+    assert(str(-1 / 0) == "-Infinity");
+
+    const i = 12;
+    assert(("" + i).length == 2);
+    assert(("v" + -i) == "v-12");
+}
+
+function test_parse() {
+    assert(parseInt("0") == 0);
+    assert(parseInt("123") == 123);
+    assert(parseInt("-123") == -123);
+    assert(parseInt("42px") == 42);
+    assert(parseInt(" 7") == 7);
+
+    assert(parseFloat("0") == 0);
+    assert(parseFloat("123456789012345") == 123456789012345);
+    assert(parseFloat("1234567890123456789") == 1234567890123456789);
+    assert(parseFloat("2.5") == 2.5);
+    assert(parseFloat("-0.125") == -0.125);
+    assert(parseFloat("1e3") == 1000);
+    assert(parseFloat("12abc") == 12);
+    assert(isNaN(parseFloat("")));
+    assert(isNaN(parseFloat("abc")));
+}
+
+function test_round_trip() {
+    let v = 0.001;
+    for (let i = 0; i < 100; i++) {
+        assert(parseFloat(str(v)) == v);
+        v = v * 1.37 + 0.1;
+    }
+}
+
+function main() {
+    test_to_string();
+    test_parse();
+    test_round_trip();
+    print("done.");
+}
@@ -0,0 +1,73 @@
+function test_const_in_loop() {
+    const counter = {
+        step: 2,
+        next(v: number) {
+            return v + this.step;
+        },
+    };
+
+    let sum = 0;
+    for (let i = 0; i < 100; i++) {
+        sum = counter.next(sum);
+    }
+
+    assert(sum == 200);
+}
+
+function test_let_changed_method() {
+    let calc = {
+        base: 10,
+        apply(v: number) {
+            return this.base + v;
+        },
+    };
+
+    assert(calc.apply(1) == 11);
+
+    calc.base = 20;
+    assert(calc.apply(1) == 21);
+}
+
+function test_method_changed_by_this() {
+    let obj = {
+        val: 1,
+        inc() {
+            this.val++;
+            return this.val;
+        },
+    };
+
+    obj.inc();
+    assert(obj.inc() == 3);
+}
+
+function test_method_replaced_by_this() {
+    const m = {
+        total: 0,
+        run() {
+            this.total += 1;
+            this.run = this.other;
+        },
+        other() {
+            this.total += 10;
+        },
+    };
+
+    // method field is changed by the first call, next iterations call the new method
+    for (let i = 0; i < 3; i++) {
+        m.run();
+    }
+
+    assert(m.total == 21);
+
+    m.run();
+    assert(m.total == 31);
+}
+
+function main() {
+    test_const_in_loop();
+    test_let_changed_method();
+    test_method_changed_by_this();
+    test_method_replaced_by_this();
+    print("done.");
+}
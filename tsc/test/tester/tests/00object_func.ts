@@ -31,8 +31,7 @@ function test_nest_capture_of_this() {
     };
 
     let funcInst = deck.funcWithCapture();
-    // BUG: double call causes crash (due to Trampoline)
-    //print(funcInst());
+    print(funcInst());
     assert(funcInst() == 1);
 }
 
@@ -0,0 +1,23 @@
+function main() {
+    const i = 10;
+    const n = 2.5;
+    const b = true;
+    print("values:", i, n, b, -i, 1 / 3, 0 / 0);
+    print(false, "", 12345678901);
+
+    // more than output buffer keeps
+    const line = "0123456789012345678901234567890123456789";
+    for (let j = 0; j < 4000; j++) {
+        print(j, line);
+    }
+
+    let big = "";
+    for (let j = 0; j < 2000; j++) {
+        big += line;
+    }
+
+    assert(big.length == 80000);
+    print(big.length, big);
+
+    print("done.");
+}
@@ -0,0 +1,59 @@
+function test_append_in_loop() {
+    let s = "";
+    for (let i = 0; i < 10000; i++) {
+        s = s + "a";
+    }
+
+    assert(s.length == 10000);
+}
+
+function test_append_chain_in_loop() {
+    let s = "[";
+    let i = 0;
+    while (i < 5) {
+        s += "<" + i + ">";
+        i++;
+    }
+
+    s = s + "]";
+    assert(s == "[<0><1><2><3><4>]");
+}
+
+function test_template_in_loop() {
+    let s = "x";
+    for (let i = 0; i < 3; i++) {
+        s = `${s}-${i}`;
+    }
+
+    assert(s == "x-0-1-2");
+}
+
+function test_read_in_loop() {
+    let s = "";
+    for (let i = 0; i < 3; i++) {
+        s = s + i;
+        assert(s.length == i + 1);
+    }
+
+    assert(s == "012");
+}
+
+function test_nested_loops() {
+    let s = "";
+    for (let i = 0; i < 3; i++) {
+        for (let j = 0; j < 2; j++) {
+            s = s + "ab" + "" + "c";
+        }
+    }
+
+    assert(s.length == 18);
+}
+
+function main() {
+    test_append_in_loop();
+    test_append_chain_in_loop();
+    test_template_in_loop();
+    test_read_in_loop();
+    test_nested_loops();
+    print("done.");
+}
@@ -0,0 +1,45 @@
+declare function strstr(haystack: string, needle: string): string;
+
+function test_length() {
+    const empty = "";
+    assert(empty.length == 0);
+    assert("abc".length == 3);
+    assert(("ab" + "cde").length == 5);
+
+    const n = 12345;
+    assert(("" + n).length == 5);
+
+    const c = "xyz"[1];
+    const s: string = c;
+    assert(s.length == 1);
+    assert(s == "y");
+}
+
+function test_compare() {
+    const a = "abc";
+    const b = "ab" + "c";
+    assert(a == b);
+    assert(!(a != b));
+    assert(a != "abcd");
+    assert("abcd" != a);
+    assert(a != "abd");
+    assert("" == "");
+    assert(a < "abd");
+    assert("b" > a);
+}
+
+function test_c_string() {
+    const s = strstr("hello world", "wor");
+    assert(s.length == 5);
+    assert(s == "world");
+    assert(s != "worl");
+    assert("world" == s);
+    assert((s + "!").length == 6);
+}
+
+function main() {
+    test_length();
+    test_compare();
+    test_c_string();
+    print("done.");
+}
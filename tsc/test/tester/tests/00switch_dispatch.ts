@@ -0,0 +1,144 @@
+enum Color {
+    Red,
+    Green,
+    Blue,
+    Black,
+    White
+}
+
+function classify(a: number) {
+    switch (a) {
+        case 1:
+            return 10;
+        case 2:
+        case 3:
+            return 23;
+        case 2:
+            return -1;
+        case 7:
+            return 70;
+        default:
+            return 0;
+        case 100:
+            return 1000;
+    }
+
+    return -2;
+}
+
+function fallthrough(a: number) {
+    let r = 0;
+    switch (a) {
+        default:
+            r += 1;
+        case 0:
+            r += 10;
+            break;
+        case 1:
+            r += 100;
+        case 2:
+            r += 1000;
+        case 3:
+            r += 10000;
+    }
+
+    return r;
+}
+
+// cases of type number, value of switch can have fraction or be out of range of integer
+function scale(a: number) {
+    switch (a) {
+        case 1.0:
+            return 1;
+        case 2.0:
+            return 2;
+        case -3.0:
+            return 3;
+        case 2.0:
+            return -1;
+        case 1000.0:
+            return 4;
+        default:
+            return 0;
+    }
+
+    return -2;
+}
+
+function keyword(s: string) {
+    switch (s) {
+        case "break":
+            return 1;
+        case "case":
+            return 2;
+        case "catch":
+            return 3;
+        case "class":
+            return 4;
+        case "const":
+            return 5;
+        case "":
+            return 6;
+        default:
+            return 0;
+    }
+
+    return -2;
+}
+
+function colorName(c: Color) {
+    switch (c) {
+        case Color.Red:
+            return "red";
+        case Color.Green:
+            return "green";
+        case Color.Blue:
+            return "blue";
+        case Color.Black:
+            return "black";
+    }
+
+    return "unknown";
+}
+
+function main() {
+    assert(classify(1) == 10);
+    assert(classify(2) == 23);
+    assert(classify(3) == 23);
+    assert(classify(7) == 70);
+    assert(classify(100) == 1000);
+    assert(classify(5) == 0);
+    assert(classify(-1) == 0);
+
+    assert(fallthrough(0) == 10);
+    assert(fallthrough(1) == 11100);
+    assert(fallthrough(2) == 11000);
+    assert(fallthrough(3) == 10000);
+    assert(fallthrough(4) == 11);
+
+    assert(scale(1) == 1);
+    assert(scale(2) == 2);
+    assert(scale(-3) == 3);
+    assert(scale(1000) == 4);
+    assert(scale(1.5) == 0);
+    assert(scale(-3.25) == 0);
+    assert(scale(4294967298) == 0);
+    assert(scale(-4294967295) == 0);
+    assert(scale(0 / 0) == 0);
+
+    assert(keyword("break") == 1);
+    assert(keyword("case") == 2);
+    assert(keyword("ca" + "tch") == 3);
+    assert(keyword("class") == 4);
+    assert(keyword("const") == 5);
+    assert(keyword("") == 6);
+    assert(keyword("cons") == 0);
+    assert(keyword("constant") == 0);
+
+    assert(colorName(Color.Red) == "red");
+    assert(colorName(Color.Blue) == "blue");
+    assert(colorName(Color.Black) == "black");
+    assert(colorName(Color.White) == "unknown");
+
+    print("done.");
+}
@@ -0,0 +1,44 @@
+function sum(p: [number, number]) {
+    return p[0] + p[1];
+}
+
+function dist(p: { x: number; y: number }) {
+    return p.x - p.y;
+}
+
+function test_created_tuple_arg() {
+    let x = 1;
+    let y = 2;
+    assert(sum([x, y]) == 3);
+}
+
+function test_object_arg_fields_order() {
+    let a = 5;
+    let b = 3;
+    assert(dist({ y: b, x: a }) == 2);
+}
+
+function test_deconstruct_created_tuple() {
+    let n = 1;
+    let s = "str";
+    const t: [number, string] = [n, s];
+    const [v1, v2] = t;
+    assert(v1 == 1);
+    assert(v2 == "str");
+}
+
+function test_changed_field() {
+    let v = 10.0;
+    let c: [name: string, age: number] = ["user", v];
+    c.age = 20.0;
+    assert(c.name == "user");
+    assert(c.age == 20.0);
+}
+
+function main() {
+    test_created_tuple_arg();
+    test_object_arg_fields_order();
+    test_deconstruct_created_tuple();
+    test_changed_field();
+    print("done.");
+}
@@ -0,0 +1,55 @@
+// typeof of value which type is known is constant, guards are removed at compile time
+function kindOf<T>(v: T) {
+    if (typeof v == "number") {
+        return 1;
+    }
+
+    if (typeof v == "string") {
+        return 2;
+    }
+
+    if (typeof v === "boolean") {
+        return 3;
+    }
+
+    return 0;
+}
+
+// typeof of union is checked by tag of union
+function unionKind(v: number | string | boolean) {
+    switch (typeof v) {
+        case "number":
+            return 1;
+        case "string":
+            return 2;
+        case "boolean":
+            return 3;
+        case "object":
+            return 4;
+    }
+
+    return 0;
+}
+
+function main() {
+    assert(kindOf<number>(1) == 1);
+    assert(kindOf<string>("s") == 2);
+    assert(kindOf<boolean>(true) == 3);
+
+    const n = 10;
+    assert(typeof n == "number");
+    assert(typeof "str" == "string");
+
+    let sum = 0;
+    for (let i = 0; i < 100; i++) {
+        let v: number | string | boolean = i;
+        if (i % 4 == 1) v = "s";
+        if (i % 4 == 2) v = false;
+        sum += unionKind(v);
+    }
+
+    // 50 numbers, 25 strings and 25 booleans
+    assert(sum == 50 + 25 * 2 + 25 * 3);
+
+    print("done.");
+}
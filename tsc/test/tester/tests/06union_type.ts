@@ -0,0 +1,38 @@
+// type-heavy code: the same unions are built again and again (useful to time the frontend)
+function widen1(v: number | string | boolean) {
+    let a: string | number | boolean = v;
+    let b: boolean | string | number = a;
+    let c: number | boolean | string = b;
+    return c;
+}
+
+function widen2(v: number | string) {
+    let a: string | number | undefined = v;
+    let b: number | string | undefined = a;
+    let c: undefined | number | string = b;
+    return c;
+}
+
+function widen3(v: 1 | 2 | 3) {
+    let a: 1 | 2 | 3 | number = v;
+    let b: number | 3 | 2 | 1 = a;
+    return b;
+}
+
+function main() {
+    let count = 0;
+    for (let i = 0; i < 10; i++) {
+        const x = widen1(i);
+        if (typeof x == "number") count++;
+
+        const y = widen2("s");
+        if (typeof y == "string") count++;
+
+        const z = widen3(2);
+        if (z == 2) count++;
+    }
+
+    assert(count == 30);
+
+    print("done.");
+}
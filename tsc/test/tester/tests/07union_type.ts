@@ -0,0 +1,42 @@
+// union-heavy code: tag checks are integer compares (useful to time union discrimination)
+function kind(v: number | string | boolean) {
+    switch (typeof v) {
+        case "number":
+            return 1;
+        case "string":
+            return 2;
+        case "boolean":
+            return 3;
+    }
+
+    return 0;
+}
+
+function main() {
+    let u: number | string | boolean = 1;
+    assert(typeof u == "number", "failed. 1");
+    assert(typeof u != "string", "failed. 2");
+    print(typeof u);
+
+    u = "str";
+    assert(typeof u === "string", "failed. 3");
+    print(typeof u);
+
+    u = true;
+    assert(typeof u !== "number", "failed. 4");
+    const name = typeof u;
+    assert(name == "boolean", "failed. 5");
+    print(name);
+
+    let sum = 0;
+    for (let i = 0; i < 1000; i++) {
+        let v: number | string | boolean = i;
+        if (i % 3 == 1) v = "s";
+        if (i % 3 == 2) v = false;
+        sum += kind(v);
+    }
+
+    assert(sum == 1999, "failed. 6");
+
+    print("done.");
+}
@@ -18,8 +18,6 @@
 #endif
 #endif
 
-#include "TypeScript/rt.h"
-
 #include "mlir/ExecutionEngine/ExecutionEngine.h"
 #include "mlir/ExecutionEngine/OptUtils.h"
 #include "mlir/IR/AsmState.h"
@@ -130,6 +128,8 @@ static cl::opt<std::string> objectFilename{"object-filename", cl::desc("Dump JIT
 
 cl::OptionCategory clTsCompilingOptionsCategory{"TypeScript compiling options"};
 static cl::opt<bool> disableGC("nogc", cl::desc("Disable Garbage collection"), cl::cat(clTsCompilingOptionsCategory));
+static cl::opt<bool> generatorsAsCoroutines("coroutines", cl::desc("Lower generators into LLVM coroutines"), cl::cat(clTsCompilingOptionsCategory));
+static cl::opt<bool> lineBufferedOutput("line-buffered-output", cl::desc("Flush output of 'print' after each line"), cl::cat(clTsCompilingOptionsCategory));
 
 int loadMLIR(mlir::MLIRContext &context, mlir::OwningModuleRef &module)
 {
@@ -147,6 +147,7 @@ int loadMLIR(mlir::MLIRContext &context, mlir::OwningModuleRef &module)
 
         CompileOptions compileOptions;
         compileOptions.disableGC = disableGC;
+        compileOptions.generatorsAsCoroutines = generatorsAsCoroutines;
         module = mlirGenFromSource(context, fileName, fileOrErr.get()->getBuffer(), compileOptions);
         return !module ? 1 : 0;
     }
@@ -231,9 +232,32 @@ int loadAndProcessMLIR(mlir::MLIRContext &context, mlir::OwningModuleRef &module
         pm.addPass(mlir::createAsyncToAsyncRuntimePass());
 #endif
 
+        if (generatorsAsCoroutines)
+        {
+            pm.addPass(mlir::typescript::createGeneratorToCoroutinePass());
+        }
+
+        if (enableOpt)
+        {
+            pm.addPass(mlir::typescript::createDevirtualizePass());
+            pm.addPass(mlir::typescript::createInlinerPass());
+            pm.addPass(mlir::typescript::createEscapeAnalysisPass());
+        }
+
+#ifdef ENABLE_EXCEPTIONS
+        pm.addPass(mlir::typescript::createNounwindPass());
+#endif
+
 #ifndef AFFINE_MODULE_PASS
         mlir::OpPassManager &optPM = pm.nest<mlir::typescript::FuncOp>();
 
+        if (enableOpt)
+        {
+            optPM.addPass(mlir::typescript::createScalarReplacementPass());
+            optPM.addPass(mlir::typescript::createIntegerRangePass());
+            optPM.addPass(mlir::typescript::createStringBuilderPass());
+        }
+
         // Partially lower the TypeScript dialect with a few cleanups afterwards.
         optPM.addPass(mlir::typescript::createLowerToAffineTSFuncPass());
         optPM.addPass(mlir::createCanonicalizerPass());
@@ -248,6 +272,14 @@ int loadAndProcessMLIR(mlir::MLIRContext &context, mlir::OwningModuleRef &module
         pm.addPass(mlir::typescript::createLowerToAffineModulePass());
         pm.addPass(mlir::createCanonicalizerPass());
 #else        
+        if (enableOpt)
+        {
+            mlir::OpPassManager &optPM = pm.nest<mlir::typescript::FuncOp>();
+            optPM.addPass(mlir::typescript::createScalarReplacementPass());
+            optPM.addPass(mlir::typescript::createIntegerRangePass());
+            optPM.addPass(mlir::typescript::createStringBuilderPass());
+        }
+
         pm.addPass(mlir::typescript::createLowerToAffineModulePass());
         pm.addPass(mlir::createCanonicalizerPass());
 
@@ -258,6 +290,8 @@ int loadAndProcessMLIR(mlir::MLIRContext &context, mlir::OwningModuleRef &module
 #ifdef ENABLE_OPT_PASSES
         if (enableOpt)
         {
+            // hoist pure TS ops (property refs, lengths, vtable offsets) out of counted loops
+            optPM.addPass(mlir::createLoopInvariantCodeMotionPass());
             optPM.addPass(mlir::createCSEPass());
             pm.addPass(mlir::createStripDebugInfoPass());
             pm.addPass(mlir::createInlinerPass());
@@ -283,6 +317,7 @@ int loadAndProcessMLIR(mlir::MLIRContext &context, mlir::OwningModuleRef &module
         pm.addPass(mlir::createConvertAsyncToLLVMPass());
 #endif
         pm.addPass(mlir::typescript::createLowerToLLVMPass());
+        pm.addPass(mlir::typescript::createOutputBufferPass(lineBufferedOutput));
         if (!disableGC)
         {
             pm.addPass(mlir::typescript::createGCPass());
@@ -488,9 +523,6 @@ int runJit(mlir::ModuleOp module)
             symbolMap[interner(exportSymbol.getKey())] = llvm::JITEvaluatedSymbol::fromPointer(exportSymbol.getValue());
         }
 
-        // adding my ref to __enable_execute_stack
-        symbolMap[interner("__enable_execute_stack")] = llvm::JITEvaluatedSymbol::fromPointer(_mlir__enable_execute_stack);
-
         if (!disableGC && symbolMap.count(interner("GC_init")) == 0)
         {
             noGC = true;